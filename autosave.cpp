@@ -0,0 +1,428 @@
+/** ***************************************************************************
+* @file
+* @brief Cpp file including functions for the autosave.h, holds the functions
+* which log the changes to the shapes, compact the log into a scene file and
+* recover the shapes from both
+*
+* An autosave is two files, base.pscn, a scene file holding every shape as
+* of some generation, and base.plog, the changes made since, for that same
+* generation. The scene thread only queues changes and snapshots. The writer
+* thread appends the queued changes with one write and one fdatasync per
+* batch, and compacts by writing a scene file of the next generation and then
+* starting an empty log for it. Each step is renamed into place after it is
+* on disk, so a crash at any point leaves a scene file and either the log
+* that follows it or a log of an older generation, which is ignored.
+******************************************************************************/
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <iomanip>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <fcntl.h>
+#include <unistd.h>
+#include "autosave.h"
+#include "scenefile.h"
+#include "document.h"
+#include "stats.h"
+
+using std::chrono::steady_clock;
+
+static_assert(sizeof(ChangeRecord) == 56, "change records must stay the same size on every compiler");
+
+static std::string sceneFile;           // base.pscn, the newest snapshot
+static std::string logFile;             // base.plog, the changes since it
+static size_t limit = AUTOSAVE_LIMIT;   // log bytes after which it is compacted
+static bool running = false;            // set while the writer thread runs
+static size_t logged = 0;               // bytes queued since the last snapshot, scene thread only
+static uint32_t generation = 0;         // the generation of the last snapshot queued or recovered
+
+static std::thread writer;              // appends and compacts, off the scene thread
+static std::mutex queueLock;            // guards what follows
+static std::condition_variable wake;    // signalled when there is work or on stop
+static std::vector<ChangeRecord> queued;    // changes not yet written, all made after the snapshot below
+static SceneSnapshot snapshot;          // the shapes to compact into
+static uint32_t snapshotGeneration = 0; // the generation of that snapshot, 0 if none is queued
+static bool stopping = false;           // set to make the writer finish
+
+/** **************************************************************************
+ * @brief Returns the checksum of a change record, FNV-1a over its bytes with
+ * the check field 0
+ *
+ * @param[in] change - the record
+ ******************************************************************************/
+static uint32_t checksum(ChangeRecord change)
+{
+   change.check = 0;
+   const uint8_t *bytes = reinterpret_cast<const uint8_t *>(&change);
+   uint32_t hash = 2166136261u;
+   for (size_t i = 0; i < sizeof(change); i++)
+      hash = (hash ^ bytes[i]) * 16777619u;
+   return hash;
+}
+
+/** **************************************************************************
+ * @brief Flushes the directory of a file, so a rename in it survives a crash
+ *
+ * @param[in] path - the file
+ ******************************************************************************/
+static void syncDirectory(const std::string &path)
+{
+   size_t slash = path.rfind('/');
+   std::string dir = slash == std::string::npos ? "." : slash == 0 ? "/" : path.substr(0, slash);
+   int fd = open(dir.c_str(), O_RDONLY);
+   if (fd < 0)
+      return;
+   fsync(fd);
+   close(fd);
+}
+
+/** **************************************************************************
+ * @brief Writes all of a buffer, retrying short writes
+ *
+ * @param[in] fd - the file
+ * @param[in] data - the bytes
+ * @param[in] size - the number of bytes
+ *
+ * @returns true if every byte was written
+ ******************************************************************************/
+static bool writeAll(int fd, const void *data, size_t size)
+{
+   const char *bytes = static_cast<const char *>(data);
+   while (size > 0)
+   {
+      ssize_t written = write(fd, bytes, size);
+      if (written <= 0)
+         return false;
+      bytes += written;
+      size -= size_t(written);
+   }
+   return true;
+}
+
+/** **************************************************************************
+ * @brief Writes a snapshot as the scene file and starts an empty log for it
+ *
+ * The scene file is in place before the new log replaces the old one, a
+ * crash in between leaves an old log that no longer matches and is ignored
+ *
+ * @param[in] scene - the shapes
+ * @param[in] gen - the generation of the snapshot
+ *
+ * @returns the new log, open for appending, -1 if either file failed
+ ******************************************************************************/
+static int compact(const SceneSnapshot &scene, uint32_t gen)
+{
+   if (!saveScene(sceneFile.c_str(), scene, gen))
+      return -1;
+   syncDirectory(sceneFile);
+   stats().autosaveSceneBytes.fetch_add(sizeof(SceneHeader) + scene.size() * sizeof(SceneRecord),
+                                        std::memory_order_relaxed);
+   stats().autosaveSnapshots.fetch_add(1, std::memory_order_relaxed);
+
+   std::string temp = logFile + ".tmp";
+   int fd = open(temp.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+   if (fd < 0)
+      return -1;
+   AutosaveHeader header = {{'P', 'L', 'O', 'G'}, AUTOSAVE_VERSION, sizeof(ChangeRecord), gen, 0};
+   if (!writeAll(fd, &header, sizeof(header)) || fsync(fd) != 0 || rename(temp.c_str(), logFile.c_str()) != 0)
+   {
+      close(fd);
+      remove(temp.c_str());
+      return -1;
+   }
+   syncDirectory(logFile);
+   stats().autosaveLogBytes.fetch_add(sizeof(header), std::memory_order_relaxed);
+   return fd;   // the descriptor follows the rename, it is the log now
+}
+
+/** **************************************************************************
+ * @brief The body of the writer thread, compacts and appends whatever was
+ * queued until stopped, then writes what is left
+ ******************************************************************************/
+static void writeLog()
+{
+   int fd = -1;
+   std::vector<ChangeRecord> batch;
+   std::unique_lock<std::mutex> guard(queueLock);
+   while (true)
+   {
+      wake.wait(guard, [] { return stopping || !queued.empty() || snapshotGeneration != 0; });
+      if (queued.empty() && snapshotGeneration == 0)
+         break;   // stopping with nothing left
+      SceneSnapshot scene;
+      uint32_t gen = snapshotGeneration;
+      if (gen != 0)
+      {
+         scene = snapshot;
+         snapshot = SceneSnapshot();   // the tree is not held past the compaction
+         snapshotGeneration = 0;
+      }
+      batch.swap(queued);
+      guard.unlock();
+
+      if (gen != 0)
+      {
+         if (fd >= 0)
+            close(fd);
+         fd = compact(scene, gen);
+         if (fd < 0)
+            std::cerr << "cannot write autosave " << sceneFile << "\n";
+      }
+      if (fd >= 0 && !batch.empty())
+      {
+         // one write and one flush for every change queued since the last batch
+         if (writeAll(fd, batch.data(), batch.size() * sizeof(ChangeRecord)) && fdatasync(fd) == 0)
+         {
+            stats().autosaveLogBytes.fetch_add(batch.size() * sizeof(ChangeRecord), std::memory_order_relaxed);
+            stats().autosaveSyncs.fetch_add(1, std::memory_order_relaxed);
+         }
+         else
+            std::cerr << "cannot append to autosave " << logFile << "\n";
+      }
+      batch.clear();
+      guard.lock();
+   }
+   if (fd >= 0)
+      close(fd);
+}
+
+/** **************************************************************************
+ * @brief Applies a logged change to the shapes
+ *
+ * @param[in,out] shapes - the shapes by depth
+ * @param[in] change - the change, its checksum already checked
+ *
+ * @returns false if the change does not fit the shapes, the log is not the
+ *          one that follows them
+ ******************************************************************************/
+static bool applyChange(SceneShapes &shapes, const ChangeRecord &change)
+{
+   SceneShapes::iterator at = shapes.find(change.depth);
+   switch (change.type)
+   {
+      case ADD_CHANGE:
+         return validRecord(change.shape) && shapes.emplace(change.depth, change.shape).second;
+      case MOVE_CHANGE:
+         if (at == shapes.end() || !validRecord(change.shape))
+            return false;
+         at->second = change.shape;
+         return true;
+      case ERASE_CHANGE:
+         if (at == shapes.end())
+            return false;
+         shapes.erase(at);
+         return true;
+      case RESTACK_CHANGE:
+      {
+         if (at == shapes.end() || shapes.count(change.to) != 0)
+            return false;
+         SceneShapes::node_type node = shapes.extract(at);
+         node.key() = change.to;
+         shapes.insert(std::move(node));
+         return true;
+      }
+      case SWAP_CHANGE:
+      {
+         SceneShapes::iterator other = shapes.find(change.to);
+         if (at == shapes.end() || other == shapes.end())
+            return false;
+         std::swap(at->second, other->second);
+         return true;
+      }
+      default:
+         return false;
+   }
+}
+
+/** **************************************************************************
+ * @brief Rebuilds the shapes an autosave holds, the scene file with the
+ * changes of its log applied
+ *
+ * The log is applied up to the first record that is cut short, fails its
+ * checksum or does not fit, what a crash in the middle of an append leaves.
+ * A log of another generation than the scene file is ignored. How long each
+ * step took is reported.
+ *
+ * @param[in] base - the autosave path, without the .pscn and .plog
+ * @param[in,out] doc - the document whose arena makes the shapes
+ * @param[in,out] out - the stream the report is written to
+ *
+ * @returns the indexes holding the shapes, nullptr if there is no readable
+ *          scene file
+ ******************************************************************************/
+std::unique_ptr<SceneParts> recoverAutosave(const char *base, Document &doc, std::ostream &out)
+{
+   sceneFile = std::string(base) + ".pscn";
+   logFile = std::string(base) + ".plog";
+   steady_clock::time_point start = steady_clock::now();
+   SceneShapes shapes;
+   uint32_t gen = 0;
+   if (!readScene(sceneFile.c_str(), shapes, gen))
+      return nullptr;
+   size_t loaded = shapes.size();
+   std::chrono::duration<double, std::milli> reading = steady_clock::now() - start;
+
+   start = steady_clock::now();
+   size_t applied = 0, torn = 0;
+   FILE *file = fopen(logFile.c_str(), "rb");
+   AutosaveHeader header;
+   if (file != nullptr && fread(&header, sizeof(header), 1, file) == 1 &&
+       memcmp(header.magic, "PLOG", 4) == 0 && header.version == AUTOSAVE_VERSION &&
+       header.recordSize == sizeof(ChangeRecord) && header.generation == gen)
+   {
+      ChangeRecord change;
+      size_t got;
+      while ((got = fread(&change, 1, sizeof(change), file)) == sizeof(change) &&
+             change.check == checksum(change) && applyChange(shapes, change))
+         applied++;
+      torn = got;
+      while ((got = fread(&change, 1, sizeof(change), file)) > 0)
+         torn += got;   // everything past the first bad record is dropped
+   }
+   if (file != nullptr)
+      fclose(file);
+   std::chrono::duration<double, std::milli> replaying = steady_clock::now() - start;
+
+   start = steady_clock::now();
+   std::unique_ptr<SceneParts> parts = buildScene(shapes, doc);
+   std::chrono::duration<double, std::milli> building = steady_clock::now() - start;
+   generation = gen;
+
+   out << std::fixed << std::setprecision(2)
+       << "recovered " << shapes.size() << " shapes in " << reading.count() + replaying.count() + building.count()
+       << " ms: " << loaded << " read from " << sceneFile << " (generation " << gen << ") in " << reading.count()
+       << " ms, " << applied << " changes replayed from " << logFile << " in " << replaying.count()
+       << " ms, shapes made in " << building.count() << " ms";
+   if (torn != 0)
+      out << ", " << torn << " bytes of torn tail dropped";
+   out << "\n";
+   return parts;
+}
+
+/** **************************************************************************
+ * @brief Starts logging changes, the log begins with a snapshot of the shapes
+ *
+ * Only called before the scene thread starts. The first snapshot is a new
+ * generation after any recovered one, so the old files are replaced once it
+ * is written.
+ *
+ * @param[in] base - the autosave path, without the .pscn and .plog
+ * @param[in] bytes - log bytes after which it is compacted
+ * @param[in] scene - the shapes on the canvas now
+ *
+ * @returns true if logging started
+ ******************************************************************************/
+bool startAutosave(const char *base, size_t bytes, const SceneSnapshot &scene)
+{
+   stopAutosave();
+   sceneFile = std::string(base) + ".pscn";
+   logFile = std::string(base) + ".plog";
+   limit = bytes;
+   stopping = false;
+   running = true;
+   autosaveScene(scene);
+   writer = std::thread(writeLog);
+   return true;
+}
+
+/** **************************************************************************
+ * @brief Returns true if changes are being logged
+ ******************************************************************************/
+bool autosaving()
+{
+   return running;
+}
+
+/** **************************************************************************
+ * @brief Queues a change for the writer thread, does nothing if not logging
+ *
+ * Never waits for the disk, the scene thread only takes the queue lock
+ *
+ * @param[in] type - what changed
+ * @param[in] depth - the depth of the changed shape
+ * @param[in] to - its new depth, or the depth of the shape it swapped with
+ * @param[in] shape - the shape added or moved, nullptr for other changes
+ ******************************************************************************/
+void autosaveChange(ChangeType type, long long depth, long long to, Shape *shape)
+{
+   if (!running)
+      return;
+   ChangeRecord change;
+   memset(&change, 0, sizeof(change));   // padding included, for the checksum
+   change.type = type;
+   change.depth = depth;
+   change.to = to;
+   if (shape != nullptr)
+   {
+      ShapeRecord record = shape->toRecord();   // copied field by field, its padding is not set
+      change.shape.type = record.type;
+      change.shape.x = record.x;
+      change.shape.y = record.y;
+      change.shape.a = record.a;
+      change.shape.b = record.b;
+      change.shape.border = record.border;
+      change.shape.fill = record.fill;
+   }
+   change.check = checksum(change);
+   {
+      std::lock_guard<std::mutex> guard(queueLock);
+      queued.push_back(change);
+   }
+   wake.notify_one();
+   logged += sizeof(change);
+   stats().autosaveChanges.fetch_add(1, std::memory_order_relaxed);
+}
+
+/** **************************************************************************
+ * @brief Returns true once the changes logged since the last snapshot are
+ * past the limit
+ ******************************************************************************/
+bool autosaveDue()
+{
+   return running && logged >= limit;
+}
+
+/** **************************************************************************
+ * @brief Queues a compaction, does nothing if not logging
+ *
+ * The snapshot already holds every change still queued, they are dropped,
+ * and the log starts over after it
+ *
+ * @param[in] scene - the shapes on the canvas now
+ ******************************************************************************/
+void autosaveScene(const SceneSnapshot &scene)
+{
+   if (!running)
+      return;
+   {
+      std::lock_guard<std::mutex> guard(queueLock);
+      queued.clear();
+      snapshot = scene;
+      snapshotGeneration = ++generation;
+   }
+   wake.notify_one();
+   logged = 0;
+}
+
+/** **************************************************************************
+ * @brief Writes what is queued and stops the writer thread, if logging
+ *
+ * The files are kept, the next start recovers from them
+ ******************************************************************************/
+void stopAutosave()
+{
+   if (!running)
+      return;
+   {
+      std::lock_guard<std::mutex> guard(queueLock);
+      stopping = true;
+   }
+   wake.notify_one();
+   writer.join();
+   running = false;
+}
@@ -0,0 +1,73 @@
+/** ***************************************************************************
+* @file
+* @brief Header file that holds the autosave, which appends every committed
+* change to the shapes to a log on a background thread, compacts the log into
+* a scene file once it grows past a limit, and rebuilds the shapes from both
+* after a crash
+******************************************************************************/
+
+#ifndef __AUTOSAVE_H
+#define __AUTOSAVE_H
+
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include "shape.h"
+#include "snapshot.h"
+
+struct Document;
+struct SceneParts;
+
+const uint16_t AUTOSAVE_VERSION = 1;        /*!< the autosave log format version */
+const size_t AUTOSAVE_LIMIT = 4 << 20;      /*!< log bytes after which it is compacted, by default */
+
+/*!
+ * @brief The kinds of change the autosave log holds, each names the shapes
+ * it changed by their depth in the drawing order
+ */
+enum ChangeType : uint8_t
+{
+    ADD_CHANGE,         /*!< a shape was put on the canvas at a free depth */
+    MOVE_CHANGE,        /*!< a shape was moved, at the end of the drag */
+    ERASE_CHANGE,       /*!< a shape was taken off the canvas */
+    RESTACK_CHANGE,     /*!< a shape was moved to a free depth */
+    SWAP_CHANGE,        /*!< two shapes swapped depths */
+    CHANGE_TYPES
+};
+
+/*!
+ * @brief AutosaveHeader struct, written at the start of every autosave log
+ */
+struct AutosaveHeader
+{
+    char magic[4];          /*!< always "PLOG" */
+    uint16_t version;       /*!< the autosave log format version */
+    uint16_t recordSize;    /*!< sizeof(ChangeRecord) when the log was written */
+    uint32_t generation;    /*!< the generation of the scene file the log follows */
+    uint32_t reserved;      /*!< 0 */
+};
+
+/*!
+ * @brief ChangeRecord struct, one change as the log holds it
+ */
+struct ChangeRecord
+{
+    ChangeType type;        /*!< what changed */
+    uint8_t reserved[3];    /*!< 0 */
+    uint32_t check;         /*!< checksum of the record taken with this field 0, a torn write fails it */
+    int64_t depth;          /*!< the depth of the changed shape */
+    int64_t to;             /*!< its new depth, or the depth of the shape it swapped with */
+    ShapeRecord shape;      /*!< the shape after an add or a move, zero otherwise */
+};
+
+// rebuilds the shapes from the scene file and log of an autosave, nullptr if there are none
+std::unique_ptr<SceneParts> recoverAutosave(const char *base, Document &doc, std::ostream &out);
+bool startAutosave(const char *base, size_t limit, const SceneSnapshot &scene);  // starts the log with a snapshot
+bool autosaving();                                  // returns true if changes are being logged
+// appends a change to the log, the shape is the one added or moved
+void autosaveChange(ChangeType type, long long depth, long long to = 0, Shape *shape = nullptr);
+bool autosaveDue();                                 // returns true if the log should be compacted
+void autosaveScene(const SceneSnapshot &scene);     // compacts the log into a snapshot of the shapes
+void stopAutosave();                                // writes what is queued and stops the log
+
+#endif
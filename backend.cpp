@@ -0,0 +1,208 @@
+/** ***************************************************************************
+* @file
+* @brief Cpp file including functions for the backend.h, holds the backend
+* registry and the functions which put a recorded frame on screen each way
+******************************************************************************/
+
+#define GL_GLEXT_PROTOTYPES   // glWindowPos, must come before any GL header
+#include "backend.h"
+
+/*!
+ * @brief The backends, one object each, they only keep what they cache
+ * between frames
+ */
+static VboBackend VBO;
+static ImmediateBackend IMMEDIATE;
+static RasterBackend RASTER;
+static NullBackend NONE;
+
+/*!
+ * @brief The backend of each BackendId, in BackendId order
+ */
+static RenderBackend *const REGISTRY[BACKEND_COUNT] = {&VBO, &IMMEDIATE, &RASTER, &NONE};
+
+/** **************************************************************************
+ * @brief Limits drawing to the damaged area and clears it
+ *
+ * @param[in] area - the damaged pixels, inside the window
+ ******************************************************************************/
+static void beginArea(const Box &area)
+{
+   glScissor(area.left, area.bottom, area.right - area.left + 1, area.top - area.bottom + 1);
+   glEnable(GL_SCISSOR_TEST);
+   glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+}
+
+/** **************************************************************************
+ * @brief Lets drawing reach the whole window again and sends the frame off
+ ******************************************************************************/
+static void endArea()
+{
+   glDisable(GL_SCISSOR_TEST);
+   glFlush();
+}
+
+/** **************************************************************************
+ * @brief Returns the name the vertex buffer backend is chosen by
+ ******************************************************************************/
+const char *VboBackend::name() const
+{
+   return "vbo";
+}
+
+/** **************************************************************************
+ * @brief Draws the damaged area of a frame from vertex buffers
+ *
+ * The static layer is rendered offscreen the first time a frame recorded
+ * against it is drawn, after that it is copied into the window in place of
+ * clearing it. The toolbox is kept in its own vertex buffers, which are only
+ * uploaded again when a new layout is published, so each frame it costs two
+ * draw calls and no recording.
+ *
+ * @param[in] layer - the static layer the frame was recorded against
+ * @param[in] version - which static layer it is
+ * @param[in] shapes - the shapes drawn over the layer
+ * @param[in] toolbox - the toolbox, nullptr if the damage does not reach it
+ * @param[in] area - the damaged pixels, inside the window
+ ******************************************************************************/
+void VboBackend::present(const RenderList &layer, unsigned version, const RenderList &shapes,
+                         const RenderList *toolbox, const Box &area)
+{
+   if (version != bakedVersion)
+   {
+      baked.bake(layer);
+      bakedVersion = version;
+   }
+   beginArea(area);
+   baked.composite();
+   shapes.submit();
+   if (toolbox != nullptr)
+      toolbox->submit(true);
+   endArea();
+}
+
+/** **************************************************************************
+ * @brief Returns the name the immediate mode backend is chosen by
+ ******************************************************************************/
+const char *ImmediateBackend::name() const
+{
+   return "immediate";
+}
+
+/** **************************************************************************
+ * @brief Draws the damaged area of a frame one glBegin/glEnd per primitive
+ *
+ * Nothing is cached, the static layer is drawn again every frame
+ *
+ * @param[in] layer - the static layer the frame was recorded against
+ * @param[in] version - which static layer it is, unused
+ * @param[in] shapes - the shapes drawn over the layer
+ * @param[in] toolbox - the toolbox, nullptr if the damage does not reach it
+ * @param[in] area - the damaged pixels, inside the window
+ ******************************************************************************/
+void ImmediateBackend::present(const RenderList &layer, unsigned version, const RenderList &shapes,
+                               const RenderList *toolbox, const Box &area)
+{
+   beginArea(area);
+   layer.submitImmediate();
+   shapes.submitImmediate();
+   if (toolbox != nullptr)
+      toolbox->submitImmediate();
+   endArea();
+}
+
+/** **************************************************************************
+ * @brief Returns the name the software rasterizer backend is chosen by
+ ******************************************************************************/
+const char *RasterBackend::name() const
+{
+   return "raster";
+}
+
+/** **************************************************************************
+ * @brief Draws the damaged area of a frame with the software rasterizer
+ *
+ * The area is rasterized into a framebuffer placed over it, layer, shapes
+ * and toolbox in that order, and copied to the window with one
+ * glDrawPixels. Only the toolbox text is drawn by OpenGL.
+ *
+ * @param[in] layer - the static layer the frame was recorded against
+ * @param[in] version - which static layer it is, unused
+ * @param[in] shapes - the shapes drawn over the layer
+ * @param[in] toolbox - the toolbox, nullptr if the damage does not reach it
+ * @param[in] area - the damaged pixels, inside the window
+ ******************************************************************************/
+void RasterBackend::present(const RenderList &layer, unsigned version, const RenderList &shapes,
+                            const RenderList *toolbox, const Box &area)
+{
+   const uint8_t black[4] = {0, 0, 0, 255};
+   int width = area.right - area.left + 1;
+   int height = area.top - area.bottom + 1;
+   if (pixels.width() != width || pixels.height() != height)
+      pixels.resize(width, height);
+   pixels.place(area.left, area.bottom);
+   pixels.clear(packColor(black));
+   layer.rasterize(pixels);
+   shapes.rasterize(pixels);
+   if (toolbox != nullptr)
+      toolbox->rasterize(pixels);
+
+   glScissor(area.left, area.bottom, width, height);
+   glEnable(GL_SCISSOR_TEST);
+   glWindowPos2i(area.left, area.bottom);
+   glDrawPixels(width, height, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+   if (toolbox != nullptr)
+      toolbox->drawLabels();
+   endArea();
+}
+
+/** **************************************************************************
+ * @brief Returns the name the null backend is chosen by
+ ******************************************************************************/
+const char *NullBackend::name() const
+{
+   return "null";
+}
+
+/** **************************************************************************
+ * @brief Draws nothing
+ *
+ * @param[in] layer - the static layer the frame was recorded against
+ * @param[in] version - which static layer it is
+ * @param[in] shapes - the shapes drawn over the layer
+ * @param[in] toolbox - the toolbox, nullptr if the damage does not reach it
+ * @param[in] area - the damaged pixels, inside the window
+ ******************************************************************************/
+void NullBackend::present(const RenderList &layer, unsigned version, const RenderList &shapes,
+                          const RenderList *toolbox, const Box &area)
+{
+}
+
+/** **************************************************************************
+ * @brief Returns the backend registered under an ID
+ *
+ * @param[in] id - the backend ID, the vertex buffer backend if out of range
+ ******************************************************************************/
+RenderBackend &backendFor(BackendId id)
+{
+   return *REGISTRY[id < BACKEND_COUNT ? id : VBO_BACKEND];
+}
+
+/** **************************************************************************
+ * @brief Looks a backend up by the name it is chosen by
+ *
+ * @param[in] name - the name, i.e. "vbo"
+ * @param[out] id - the ID of the backend, unchanged if none has the name
+ *
+ * @returns true if a backend has the name
+ ******************************************************************************/
+bool findBackend(const char *name, BackendId &id)
+{
+   for (int i = 0; i < BACKEND_COUNT; i++)
+      if (strcmp(REGISTRY[i]->name(), name) == 0)
+      {
+         id = BackendId(i);
+         return true;
+      }
+   return false;
+}
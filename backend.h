@@ -0,0 +1,96 @@
+/** ***************************************************************************
+* @file
+* @brief Header file that holds the render backends, the ways a recorded frame
+* can be put on screen, one object per backend kept in a registry indexed by a
+* backend ID
+******************************************************************************/
+
+#ifndef __BACKEND_H
+#define __BACKEND_H
+
+#include <cstdint>
+#include "renderlist.h"
+#include "raster.h"
+#include "layer.h"
+#include "box.h"
+
+/*!
+ * @brief The render backends, the index of each backend in the registry
+ */
+enum BackendId : uint8_t
+{
+    VBO_BACKEND, IMMEDIATE_BACKEND, RASTER_BACKEND, NULL_BACKEND,
+    BACKEND_COUNT
+};
+
+/*!
+ * @brief RenderBackend class, abstract class for a way of drawing the frames
+ * the scene thread recorded
+ *
+ * Only used from the thread that owns the OpenGL context
+ */
+class RenderBackend
+{
+public:
+    virtual ~RenderBackend() {}
+    virtual const char *name() const = 0;   // returns the name the backend is chosen by
+    /// draws the damaged area of a frame, the rest of the window is kept
+    virtual void present(const RenderList &layer, unsigned version, const RenderList &shapes,
+                         const RenderList *toolbox, const Box &area) = 0;
+};
+
+/*!
+ * @brief VboBackend class, draws from vertex buffers over the static layer
+ * baked offscreen, two draw calls per list
+ */
+class VboBackend : public RenderBackend
+{
+    StaticLayer baked;          /*!< the static layer rendered offscreen */
+    unsigned bakedVersion = 0;  /*!< which static layer was rendered offscreen */
+public:
+    const char *name() const;
+    void present(const RenderList &layer, unsigned version, const RenderList &shapes,
+                 const RenderList *toolbox, const Box &area);
+};
+
+/*!
+ * @brief ImmediateBackend class, the legacy path, draws every primitive of
+ * every list with its own glBegin/glEnd
+ */
+class ImmediateBackend : public RenderBackend
+{
+public:
+    const char *name() const;
+    void present(const RenderList &layer, unsigned version, const RenderList &shapes,
+                 const RenderList *toolbox, const Box &area);
+};
+
+/*!
+ * @brief RasterBackend class, draws the damaged area with the software
+ * rasterizer and copies the pixels to the window, OpenGL only draws the text
+ */
+class RasterBackend : public RenderBackend
+{
+    Framebuffer pixels;     /*!< the damaged area, placed over the window */
+public:
+    const char *name() const;
+    void present(const RenderList &layer, unsigned version, const RenderList &shapes,
+                 const RenderList *toolbox, const Box &area);
+};
+
+/*!
+ * @brief NullBackend class, draws nothing, what is left is the cost of
+ * recording and handing over the frames
+ */
+class NullBackend : public RenderBackend
+{
+public:
+    const char *name() const;
+    void present(const RenderList &layer, unsigned version, const RenderList &shapes,
+                 const RenderList *toolbox, const Box &area);
+};
+
+RenderBackend &backendFor(BackendId id);                // returns the backend registered under an ID
+bool findBackend(const char *name, BackendId &id);      // looks a backend up by name
+
+#endif
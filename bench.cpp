@@ -0,0 +1,718 @@
+/** ***************************************************************************
+* @file
+* @brief Cpp file including functions for the bench.h, holds the microbenchmarks
+*
+* The dispatch benchmark keeps a copy of the old event interface (a heap
+* allocated object per event, one virtual call, four reference arguments) so
+* the per event overhead of the Event variant can be compared against it on
+* the same machine.
+*
+* The render benchmark draws the same frame of shapes with every render
+* backend, it needs a current OpenGL context.
+*
+* The pick benchmark keeps a copy of the old per shape hit tests (a virtual
+* contains() per shape, using pow() and rounding to int) to compare the shape
+* store kernels and the grid against.
+*
+* The snapshot benchmark compares taking a snapshot of the shared record tree
+* against copying every record, and measures what editing after a snapshot
+* costs and keeps alive.
+*
+* The scene benchmark saves a large document to a scene file and times
+* opening it again.
+*
+* The autosave benchmark makes a long run of edits with autosaving on and
+* recovers the shapes from what it wrote.
+******************************************************************************/
+
+#include <chrono>
+#include <iomanip>
+#include "bench.h"
+#include "event.h"
+#include "scene.h"
+#include "stats.h"
+#include "draw.h"
+#include "shapestore.h"
+#include "grid.h"
+#include "snapshot.h"
+#include "document.h"
+#include "scenefile.h"
+#include "autosave.h"
+
+using std::chrono::steady_clock;
+
+/*!
+ * @brief The old abstract event interface, kept only as a benchmark baseline
+ */
+class LegacyEvent
+{
+public:
+    virtual void action(vector<LegacyEvent *> &events, ToolboxLayout &toolbox, vector<Shape *> &shapes, Selections &selected) = 0;
+    virtual ~LegacyEvent() {}
+};
+
+/*!
+ * @brief Baseline mouse move, does the same work as MouseMove::action
+ */
+class LegacyMove : public LegacyEvent
+{
+    int xLoc;   /*!< the x location of the cursor */
+    int yLoc;   /*!< the y location of the cursor */
+public:
+    LegacyMove(int x, int y) : xLoc(x), yLoc(y) {}
+    void action(vector<LegacyEvent *> &events, ToolboxLayout &toolbox, vector<Shape *> &shapes, Selections &selected)
+    {
+        if(xLoc < 100)
+            setWindowTitle("SDSM&T Paint: Toolbox");
+        else
+            setWindowTitle("SDSM&T Paint: Paint Area");
+    }
+};
+
+/*!
+ * @brief Baseline close event, does the same work as CloseEvent::action
+ */
+class LegacyClose : public LegacyEvent
+{
+public:
+    void action(vector<LegacyEvent *> &events, ToolboxLayout &toolbox, vector<Shape *> &shapes, Selections &selected) {}
+};
+
+/*!
+ * @brief The old hit test interface, kept only as a benchmark baseline
+ */
+class LegacyHit
+{
+protected:
+    int xLoc;   /*!< the x location of the shape */
+    int yLoc;   /*!< the y location of the shape */
+    int a;      /*!< the width or x radius */
+    int b;      /*!< the height or y radius */
+public:
+    LegacyHit(int x, int y, int w, int h) : xLoc(x), yLoc(y), a(w), b(h) {}
+    virtual bool contains(int x, int y) = 0;
+    virtual ~LegacyHit() {}
+};
+
+/*!
+ * @brief Baseline line, does the same work as the old Line::contains
+ */
+class LegacyLine : public LegacyHit
+{
+public:
+    using LegacyHit::LegacyHit;
+    bool contains(int x, int y)
+    {
+        float slope = float(b) / float(a);
+        for(int i = 1; i < 8; i++)
+        {
+            if(y + i == int((slope * (float(x) - float(xLoc))) + float(yLoc)))
+                return true;
+            if(y - i == int((slope * (float(x) - float(xLoc))) + float(yLoc)))
+                return true;
+        }
+        return false;
+    }
+};
+
+/*!
+ * @brief Baseline rectangle, does the same work as the old Rectangle::contains
+ */
+class LegacyRectangle : public LegacyHit
+{
+public:
+    using LegacyHit::LegacyHit;
+    bool contains(int x, int y)
+    {
+        if(x > xLoc && x < xLoc + a && y < yLoc && y > yLoc + b)
+            return true;
+        if(x < xLoc && x > xLoc + a && y > yLoc && y < yLoc + b)
+            return true;
+        if(x > xLoc && x < xLoc + a && y > yLoc && y < yLoc + b)
+            return true;
+        if(x < xLoc && x > xLoc + a && y < yLoc && y > yLoc + b)
+            return true;
+        return false;
+    }
+};
+
+/*!
+ * @brief Baseline circle, does the same work as the old Circle::contains
+ */
+class LegacyCircle : public LegacyHit
+{
+public:
+    using LegacyHit::LegacyHit;
+    bool contains(int x, int y)
+    {
+        int xDist = pow(x - xLoc, 2);
+        int yDist = pow(y - yLoc, 2);
+        return xDist + yDist < pow(a, 2);
+    }
+};
+
+/*!
+ * @brief Baseline ellipse, does the same work as the old Ellipse::contains
+ */
+class LegacyEllipse : public LegacyHit
+{
+public:
+    using LegacyHit::LegacyHit;
+    bool contains(int x, int y)
+    {
+        float xDist = pow(float(x - xLoc) / float(a), 2);
+        float yDist = pow(float(y - yLoc) / float(b), 2);
+        return xDist + yDist <= 1;
+    }
+};
+
+/** **************************************************************************
+ * @brief Times event dispatch through the old virtual interface and the variant
+ *
+ * Both loops build and dispatch the same mix of mouse move and close events,
+ * chosen at run time so neither call can be resolved by the compiler. The
+ * loops only differ in how an event is represented and dispatched.
+ *
+ * @param[in] count - the number of events dispatched by each loop
+ * @param[in,out] out - the stream the results are written to
+ *
+ * @returns 0
+ ******************************************************************************/
+int benchmarkDispatch(long count, std::ostream &out)
+{
+   volatile int closeEvery = 16;   // volatile so the event mix is only known at run time
+   int every = closeEvery;
+
+   // the old way: one heap object and one virtual call per event
+   vector<LegacyEvent *> events;
+   vector<Shape *> legacyShapes;   // the old drawing order, a plain vector
+   Document legacy;
+   unsigned long allocations = stats().heapAllocations;
+   steady_clock::time_point start = steady_clock::now();
+   for (long i = 0; i < count; i++)
+   {
+      LegacyEvent *event;
+      if (i % every == 0)
+         event = new LegacyClose();
+      else
+         event = new LegacyMove(int(i & 255), int(i & 127));
+      event->action(events, legacy.toolbox, legacyShapes, legacy.selected);
+      delete event;
+   }
+   std::chrono::duration<double, std::nano> virtualTime = steady_clock::now() - start;
+   unsigned long virtualAllocations = stats().heapAllocations - allocations;
+
+   // the new way: an Event value dispatched by std::visit
+   Document doc;
+   allocations = stats().heapAllocations;
+   start = steady_clock::now();
+   for (long i = 0; i < count; i++)
+   {
+      Event event;
+      if (i % every == 0)
+         event = CloseEvent();
+      else
+         event = MouseMove(int(i & 255), int(i & 127));
+      visit([&doc](const auto &e) { e.action(doc); }, event);
+   }
+   std::chrono::duration<double, std::nano> variantTime = steady_clock::now() - start;
+   unsigned long variantAllocations = stats().heapAllocations - allocations;
+
+   out << std::fixed << std::setprecision(2)
+       << "dispatched " << count << " events per loop\n"
+       << "virtual + heap: " << virtualTime.count() / count << " ns/event, "
+       << double(virtualAllocations) / count << " allocations/event\n"
+       << "variant:        " << variantTime.count() / count << " ns/event, "
+       << double(variantAllocations) / count << " allocations/event\n"
+       << "speedup:        " << virtualTime.count() / variantTime.count() << "x\n";
+   return 0;
+}
+
+/** **************************************************************************
+ * @brief Records a frame of pseudo random shapes of every kind plus the toolbox
+ *
+ * @param[in,out] frame - the sink the frame is drawn into
+ * @param[in] shapes - the shapes to draw, in drawing order
+ * @param[in,out] toolbox - the toolbox layout table
+ ******************************************************************************/
+static void recordFrame(RenderSink &frame, vector<Shape *> &shapes, ToolboxLayout &toolbox)
+{
+   for (size_t i = 0; i < shapes.size(); i++)
+      shapes[i]->draw(frame);
+   mainPalleteDraw(toolbox, frame);
+}
+
+/** **************************************************************************
+ * @brief Times drawing a frame of many shapes with every render backend
+ *
+ * The same shapes are recorded into a RenderList every frame and the whole
+ * window is drawn by each backend in turn. The first line is the shapes
+ * drawn into a CountingSink, the cost of the shapes alone that every backend
+ * pays. glFinish makes each frame include the time the driver spent on it,
+ * so under Mesa's software renderer the numbers cover the whole frame.
+ *
+ * @param[in] count - the number of shapes in the frame
+ * @param[in] frames - the number of frames drawn with each method
+ * @param[in,out] out - the stream the results are written to
+ *
+ * @returns 0
+ ******************************************************************************/
+int benchmarkRender(long count, int frames, std::ostream &out)
+{
+   const float *colors[] = {RED, ORANGE, YELLOW, GREEN, BLUE, PURPLE, GRAY, WHITE};
+   vector<Shape *> shapes;
+   ToolboxLayout toolbox;
+   unsigned seed = 1;
+   for (long i = 0; i < count; i++)
+   {
+      seed = seed * 1103515245 + 12345;
+      int x = 110 + int(seed >> 8) % 520;
+      int y = 10 + int(seed >> 4) % 460;
+      int size = 5 + int(seed >> 12) % 40;
+      const float *border = colors[(seed >> 16) % 8];
+      const float *fill = colors[(seed >> 20) % 8];
+      switch (i % 7)
+      {
+         case 0: shapes.push_back(new Line(x, y, size, size, border)); break;
+         case 1: shapes.push_back(new Rectangle(x, y, size, size, border)); break;
+         case 2: shapes.push_back(new FilledRectangle(x, y, size, size, border, fill)); break;
+         case 3: shapes.push_back(new Circle(x, y, size, border)); break;
+         case 4: shapes.push_back(new FilledCircle(x, y, size, border, fill)); break;
+         case 5: shapes.push_back(new Ellipse(x, y, size, size / 2, border)); break;
+         case 6: shapes.push_back(new FilledEllipse(x, y, size, size / 2, border, fill)); break;
+      }
+   }
+
+   RenderList frame;
+   RenderList layer;   // no static layer, every backend draws the whole frame
+   CountingSink counter;
+   const Box window(0, 0, 639, 479, 0);
+   const int METHODS = BACKEND_COUNT + 1;   // the counting sink, then each backend
+   double times[METHODS];
+   double calls[METHODS];
+   for (int method = 0; method < METHODS; method++)
+   {
+      unsigned long drawCalls = stats().drawCalls;
+      steady_clock::time_point start = steady_clock::now();
+      for (int f = 0; f < frames; f++)
+      {
+         if (method == 0)
+         {
+            counter.clear();
+            recordFrame(counter, shapes, toolbox);
+            continue;
+         }
+         frame.clear();
+         recordFrame(frame, shapes, toolbox);
+         backendFor(BackendId(method - 1)).present(layer, 0, frame, nullptr, window);
+         glFinish();
+      }
+      std::chrono::duration<double, std::milli> spent = steady_clock::now() - start;
+      times[method] = spent.count() / frames;
+      calls[method] = double(stats().drawCalls - drawCalls) / frames;
+   }
+
+   out << std::fixed << std::setprecision(2)
+       << "drew " << count << " shapes (" << counter.primitives() << " primitives, "
+       << counter.vertices() << " vertices) " << frames << " times per method\n"
+       << std::setw(16) << "shapes only" << ": " << times[0] << " ms/frame\n";
+   int fastest = 1;
+   for (int method = 1; method < METHODS; method++)
+   {
+      out << std::setw(16) << backendFor(BackendId(method - 1)).name() << ": " << times[method]
+          << " ms/frame, " << calls[method] << " draw calls/frame\n";
+      if (method - 1 != NULL_BACKEND && times[method] < times[fastest])
+         fastest = method;
+   }
+   out << std::setw(16) << "fastest" << ": " << backendFor(BackendId(fastest - 1)).name() << "\n";
+
+   for (size_t i = 0; i < shapes.size(); i++)
+      delete shapes[i];
+   return 0;
+}
+
+/** **************************************************************************
+ * @brief Times finding the shapes under a point three ways
+ *
+ * Pseudo random shapes of every kind are spread over a 3840x2160 canvas.
+ * Each point is tested with the old virtual contains() called on every shape,
+ * with the shape store kernels run over every shape, and with the grid, which
+ * only hands the store the shapes near the point.
+ *
+ * @param[in] count - the number of shapes
+ * @param[in] picks - the number of points tested by each method
+ * @param[in,out] out - the stream the results are written to
+ *
+ * @returns 0
+ ******************************************************************************/
+int benchmarkPick(long count, int picks, std::ostream &out)
+{
+   vector<Shape *> shapes;
+   vector<LegacyHit *> legacy;
+   ShapeStore store;
+   ShapeGrid grid;
+   unsigned seed = 1;
+   for (long i = 0; i < count; i++)
+   {
+      seed = seed * 1103515245 + 12345;
+      int x = 110 + int(seed >> 8) % 3700;
+      seed = seed * 1103515245 + 12345;
+      int y = 10 + int(seed >> 8) % 2140;
+      int size = 5 + int(seed >> 20) % 60;
+      switch (i % 4)
+      {
+         case 0:
+            shapes.push_back(new Line(x, y, size / 2, size, WHITE));
+            legacy.push_back(new LegacyLine(x, y, size, size / 2));
+            break;
+         case 1:
+            shapes.push_back(new FilledRectangle(x, y, size, size, WHITE, RED));
+            legacy.push_back(new LegacyRectangle(x, y, size, size));
+            break;
+         case 2:
+            shapes.push_back(new Circle(x, y, size, WHITE));
+            legacy.push_back(new LegacyCircle(x, y, size, size));
+            break;
+         default:
+            shapes.push_back(new FilledEllipse(x, y, size, size / 2, WHITE, RED));
+            legacy.push_back(new LegacyEllipse(x, y, size, size / 2));
+            break;
+      }
+      store.add(shapes.back());
+      grid.insert(shapes.back(), i);
+   }
+
+   vector<int> xs, ys;
+   for (int p = 0; p < picks; p++)
+   {
+      seed = seed * 1103515245 + 12345;
+      xs.push_back(int(seed >> 8) % 3840);
+      seed = seed * 1103515245 + 12345;
+      ys.push_back(int(seed >> 8) % 2160);
+   }
+
+   const char *names[] = {"virtual contains", "store kernels", "grid and kernels"};
+   double times[3];
+   long hits[3] = {0, 0, 0};
+   vector<ShapeHandle> found;
+   vector<Shape *> picked;
+   for (int method = 0; method < 3; method++)
+   {
+      steady_clock::time_point start = steady_clock::now();
+      for (int p = 0; p < picks; p++)
+      {
+         if (method == 0)
+         {
+            for (size_t i = 0; i < legacy.size(); i++)
+               hits[0] += legacy[i]->contains(xs[p], ys[p]);
+         }
+         else if (method == 1)
+         {
+            store.scan(xs[p], ys[p], found);
+            hits[1] += long(found.size());
+         }
+         else
+         {
+            grid.query(xs[p], ys[p], store, picked);
+            hits[2] += long(picked.size());
+         }
+      }
+      std::chrono::duration<double, std::micro> spent = steady_clock::now() - start;
+      times[method] = spent.count() / picks;
+   }
+
+   out << std::fixed << std::setprecision(2)
+       << picks << " points tested against " << count << " shapes by each method\n";
+   for (int method = 0; method < 3; method++)
+      out << std::setw(18) << names[method] << ": " << std::setw(9) << times[method]
+          << " us/point, " << hits[method] << " hits\n";
+
+   for (size_t i = 0; i < shapes.size(); i++)
+   {
+      delete shapes[i];
+      delete legacy[i];
+   }
+   return 0;
+}
+
+/** **************************************************************************
+ * @brief Times taking snapshots of the shapes and editing after them
+ *
+ * A tree of pseudo random records is built, then a snapshot is timed against
+ * copying every record into a vector, the way a global copy would. Edits are
+ * timed with no snapshot held, and with a new snapshot held before every edit
+ * so each one has to copy its path. Last, the memory one snapshot keeps alive
+ * after the edits is reported.
+ *
+ * @param[in] count - the number of shapes
+ * @param[in] edits - the number of shapes moved in each timed run
+ * @param[in,out] out - the stream the results are written to
+ *
+ * @returns 0
+ ******************************************************************************/
+int benchmarkSnapshot(long count, int edits, std::ostream &out)
+{
+   SharedScene scene;
+   vector<ShapeRecord> records;
+   unsigned seed = 1;
+   for (long i = 0; i < count; i++)
+   {
+      seed = seed * 1103515245 + 12345;
+      ShapeRecord record = {ShapeType(i % 7), float(int(seed >> 8) % 3840), float(int(seed >> 12) % 2160),
+                            float(5 + i % 60), float(5 + i % 30), 0xffffffffu, 0xff0000ffu};
+      records.push_back(record);
+      scene.put(ShapeHandle(i), record, i);
+   }
+   vector<ShapeHandle> moved;
+   for (int e = 0; e < edits; e++)
+   {
+      seed = seed * 1103515245 + 12345;
+      moved.push_back(ShapeHandle((seed >> 8) % count));
+   }
+
+   const int rounds = 100;
+   steady_clock::time_point start = steady_clock::now();
+   size_t kept = 0;
+   for (int r = 0; r < rounds; r++)
+   {
+      vector<ShapeRecord> copy(records);
+      kept += copy.size();
+   }
+   std::chrono::duration<double, std::micro> copying = steady_clock::now() - start;
+   start = steady_clock::now();
+   for (int r = 0; r < rounds; r++)
+   {
+      SceneSnapshot snap = scene.snapshot();
+      kept += snap.size();
+   }
+   std::chrono::duration<double, std::micro> snapping = steady_clock::now() - start;
+
+   double editTimes[2];
+   for (int held = 0; held < 2; held++)
+   {
+      SceneSnapshot snap;
+      start = steady_clock::now();
+      for (int e = 0; e < edits; e++)
+      {
+         if (held)
+            snap = scene.snapshot();
+         ShapeRecord record = records[moved[e]];
+         record.x += 1.0f;
+         scene.update(moved[e], record);
+      }
+      std::chrono::duration<double, std::micro> spent = steady_clock::now() - start;
+      editTimes[held] = spent.count() / edits;
+   }
+
+   SceneSnapshot snap = scene.snapshot();
+   size_t before = 0;
+   snap.forEach([&](ShapeHandle, const SnapshotEntry &entry) { before += size_t(entry.record.x); });
+   for (int e = 0; e < edits; e++)
+   {
+      ShapeRecord record = records[moved[e]];
+      record.x += 2.0f;
+      scene.update(moved[e], record);
+   }
+   size_t after = 0;
+   snap.forEach([&](ShapeHandle, const SnapshotEntry &entry) { after += size_t(entry.record.x); });
+
+   out << std::fixed << std::setprecision(3)
+       << "snapshots of " << count << " shapes, " << rounds << " times each\n"
+       << std::setw(18) << "copy every record" << ": " << std::setw(10) << copying.count() / rounds << " us\n"
+       << std::setw(18) << "snapshot" << ": " << std::setw(10) << snapping.count() / rounds << " us\n"
+       << edits << " shapes moved\n"
+       << std::setw(18) << "no snapshot held" << ": " << std::setw(10) << editTimes[0] << " us/edit\n"
+       << std::setw(18) << "snapshot per edit" << ": " << std::setw(10) << editTimes[1] << " us/edit\n"
+       << "one snapshot kept over " << edits << " edits retains " << scene.retained(snap)
+       << " bytes, every record is " << count * sizeof(ShapeRecord) << " bytes, "
+       << (before == after ? "unchanged" : "CHANGED") << "\n";
+   return kept == 0;
+}
+
+/** **************************************************************************
+ * @brief Returns true if two lists of shapes hold the same shapes in the same
+ * order, compared field by field since the padding of a record is not set
+ *
+ * @param[in] a - the shapes, back to front
+ * @param[in] b - the shapes to compare with, back to front
+ ******************************************************************************/
+static bool sameShapes(const vector<ShapeRecord> &a, const vector<ShapeRecord> &b)
+{
+   bool same = a.size() == b.size();
+   for (size_t i = 0; same && i < a.size(); i++)
+      same = a[i].type == b[i].type && a[i].x == b[i].x && a[i].y == b[i].y && a[i].a == b[i].a &&
+             a[i].b == b[i].b && a[i].border == b[i].border && a[i].fill == b[i].fill;
+   return same;
+}
+
+/** **************************************************************************
+ * @brief Times saving a document to a scene file and opening it again
+ *
+ * A document of pseudo random shapes is saved, then the file is opened into
+ * new indexes, the file was just written so it is read from the page cache.
+ * Last, the opened shapes are swapped onto the canvas the way the program
+ * opens a file, and their records are checked against the saved ones.
+ *
+ * @param[in] count - the number of shapes
+ * @param[in] path - the scene file to write, removed afterwards
+ * @param[in,out] out - the stream the results are written to
+ *
+ * @returns 0 if the opened shapes match the saved ones
+ ******************************************************************************/
+int benchmarkScene(long count, const char *path, std::ostream &out)
+{
+   const float *colors[] = {RED, ORANGE, YELLOW, GREEN, BLUE, PURPLE, GRAY, WHITE};
+   std::unique_ptr<Document> doc(new Document);
+   doc->history.setBudget(0);   // only the newest change is kept
+   unsigned seed = 1;
+   for (long i = 0; i < count; i++)
+   {
+      seed = seed * 1103515245 + 12345;
+      int x = int(seed >> 8) % 3840;
+      int y = int(seed >> 12) % 2160;
+      int size = 5 + int(seed >> 4) % 60;
+      const float *border = colors[(seed >> 16) % 8];
+      const float *fill = colors[(seed >> 20) % 8];
+      Shape *shape = nullptr;
+      switch (i % 7)
+      {
+         case 0: shape = doc->arena.make<Line>(x, y, size, size, border); break;
+         case 1: shape = doc->arena.make<Rectangle>(x, y, size, size, border); break;
+         case 2: shape = doc->arena.make<FilledRectangle>(x, y, size, size, border, fill); break;
+         case 3: shape = doc->arena.make<Circle>(x, y, size, border); break;
+         case 4: shape = doc->arena.make<FilledCircle>(x, y, size, border, fill); break;
+         case 5: shape = doc->arena.make<Ellipse>(x, y, size, size / 2, border); break;
+         case 6: shape = doc->arena.make<FilledEllipse>(x, y, size, size / 2, border, fill); break;
+      }
+      doc->history.create(*doc, shape);
+   }
+   vector<ShapeRecord> saved;
+   doc->records.snapshot().ordered(saved);
+
+   steady_clock::time_point start = steady_clock::now();
+   bool ok = saveScene(path, *doc);
+   std::chrono::duration<double, std::milli> saving = steady_clock::now() - start;
+   start = steady_clock::now();
+   std::unique_ptr<SceneParts> parts = openScene(path, *doc);
+   std::chrono::duration<double, std::milli> opening = steady_clock::now() - start;
+   remove(path);
+   if (!ok || parts == nullptr)
+   {
+      out << "cannot " << (ok ? "open" : "save") << " scene file " << path << "\n";
+      return 1;
+   }
+   start = steady_clock::now();
+   doc->history.replace(*doc, std::move(parts));
+   std::chrono::duration<double, std::milli> swapping = steady_clock::now() - start;
+
+   vector<ShapeRecord> opened;
+   doc->records.snapshot().ordered(opened);
+   bool same = sameShapes(saved, opened);
+
+   out << std::fixed << std::setprecision(2)
+       << "scene file of " << count << " shapes, " << sizeof(SceneHeader) + count * sizeof(SceneRecord)
+       << " bytes\n"
+       << std::setw(18) << "save" << ": " << std::setw(10) << saving.count() << " ms\n"
+       << std::setw(18) << "open" << ": " << std::setw(10) << opening.count() << " ms\n"
+       << std::setw(18) << "put on canvas" << ": " << std::setw(10) << swapping.count() << " ms\n"
+       << "opened shapes " << (same ? "match" : "DO NOT MATCH") << " the saved ones\n";
+   return same ? 0 : 1;
+}
+
+/** **************************************************************************
+ * @brief Times autosaving a run of edits and recovering the shapes from it
+ *
+ * Pseudo random shapes are drawn, dragged, restacked and deleted, with some
+ * changes undone and redone, all through the history the way the events make
+ * them. The time the edits took on the calling thread includes queueing every
+ * change, the writer thread does the disk work. Once the writer is stopped,
+ * the shapes are recovered into a second document and checked against the
+ * first, and the write amplification, bytes written against the bytes of the
+ * change records, is reported.
+ *
+ * @param[in] count - the number of edits
+ * @param[in] base - the autosave path, the files are removed afterwards
+ * @param[in,out] out - the stream the results are written to
+ *
+ * @returns 0 if the recovered shapes match
+ ******************************************************************************/
+int benchmarkAutosave(long count, const char *base, std::ostream &out)
+{
+   const float *colors[] = {RED, ORANGE, YELLOW, GREEN, BLUE, PURPLE, GRAY, WHITE};
+   std::string sceneFile = std::string(base) + ".pscn", logFile = std::string(base) + ".plog";
+   remove(sceneFile.c_str());
+   remove(logFile.c_str());
+   std::unique_ptr<Document> doc(new Document);
+   startAutosave(base, AUTOSAVE_LIMIT, doc->records.snapshot());
+
+   unsigned seed = 1;
+   steady_clock::time_point start = steady_clock::now();
+   for (long i = 0; i < count; i++)
+   {
+      seed = seed * 1103515245 + 12345;
+      int edit = int(seed >> 24) % 10;
+      Shape *top = doc->shapes.top();
+      if (edit < 4 || top == nullptr)
+      {
+         int x = int(seed >> 8) % 1920, y = int(seed >> 12) % 1080, size = 5 + int(seed >> 4) % 60;
+         const float *border = colors[(seed >> 16) % 8];
+         const float *fill = colors[(seed >> 20) % 8];
+         Shape *shape;
+         if (seed % 2)
+            shape = doc->arena.make<FilledRectangle>(x, y, size, size, border, fill);
+         else
+            shape = doc->arena.make<Ellipse>(x, y, size, size / 2, border);
+         doc->history.create(*doc, shape);
+      }
+      else if (edit < 6)
+      {
+         for (int step = 0; step < 4; step++)   // a drag, logged once it ends
+         {
+            doc->history.move(*doc, top, top->getXLoc() + 3, top->getYLoc() - 2);
+         }
+         doc->history.seal(*doc);
+      }
+      else if (edit == 6)
+         doc->history.restack(*doc, top, seed % 2 ? TO_BACK : LOWER);
+      else if (edit == 7)
+         doc->history.remove(*doc, top);
+      else if (edit == 8)
+         doc->history.undo(*doc);
+      else
+         doc->history.redo(*doc);
+   }
+   std::chrono::duration<double, std::micro> editing = steady_clock::now() - start;
+   start = steady_clock::now();
+   stopAutosave();
+   std::chrono::duration<double, std::milli> draining = steady_clock::now() - start;
+
+   vector<ShapeRecord> edited, recovered;
+   doc->records.snapshot().ordered(edited);
+   std::unique_ptr<Document> copy(new Document);
+   std::unique_ptr<SceneParts> parts = recoverAutosave(base, *copy, out);
+   bool same = parts != nullptr;
+   if (same)
+   {
+      copy->history.replace(*copy, std::move(parts));
+      copy->records.snapshot().ordered(recovered);
+   }
+   remove(sceneFile.c_str());
+   remove(logFile.c_str());
+
+   Stats &s = stats();
+   unsigned long changes = s.autosaveChanges;
+   unsigned long written = s.autosaveLogBytes + s.autosaveSceneBytes;
+   same = same && sameShapes(edited, recovered);
+   out << std::fixed << std::setprecision(2)
+       << count << " edits, " << changes << " changes logged, " << edited.size() << " shapes left\n"
+       << std::setw(18) << "editing" << ": " << std::setw(10) << editing.count() / count << " us/edit\n"
+       << std::setw(18) << "writer drained" << ": " << std::setw(10) << draining.count() << " ms after the last edit\n"
+       << std::setw(18) << "log flushes" << ": " << std::setw(10) << s.autosaveSyncs << "\n"
+       << std::setw(18) << "snapshots" << ": " << std::setw(10) << s.autosaveSnapshots << "\n"
+       << std::setw(18) << "bytes written" << ": " << std::setw(10) << written << " ("
+       << s.autosaveLogBytes << " log, " << s.autosaveSceneBytes << " snapshots)\n"
+       << std::setw(18) << "amplification" << ": " << std::setw(10)
+       << double(written) / double(std::max(changes, 1ul) * sizeof(ChangeRecord)) << "\n"
+       << "recovered shapes " << (same ? "match" : "DO NOT MATCH") << " the edited ones\n";
+   return same ? 0 : 1;
+}
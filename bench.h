@@ -0,0 +1,19 @@
+/** ***************************************************************************
+* @file
+* @brief Header file that holds the microbenchmarks that can be run from the
+* command line instead of opening a window
+******************************************************************************/
+
+#ifndef __BENCH_H
+#define __BENCH_H
+
+#include <iostream>
+
+int benchmarkDispatch(long count, std::ostream &out);   // compares virtual and variant event dispatch
+int benchmarkRender(long count, int frames, std::ostream &out); // compares the render backends
+int benchmarkPick(long count, int picks, std::ostream &out);    // compares virtual hit tests, the store kernels and the grid
+int benchmarkSnapshot(long count, int edits, std::ostream &out);    // compares snapshots against copying the shapes
+int benchmarkScene(long count, const char *path, std::ostream &out);  // times saving and opening a scene file
+int benchmarkAutosave(long count, const char *base, std::ostream &out);   // times autosaving edits and recovering them
+
+#endif
@@ -0,0 +1,68 @@
+/** ***************************************************************************
+* @file
+* @brief Header file that holds the Box struct, an axis aligned rectangle of
+* window pixels used for shape bounds and for the damaged area of a frame
+******************************************************************************/
+
+#ifndef __BOX_H
+#define __BOX_H
+
+#include <climits>
+
+const int BOX_MARGIN = 2;   /*!< pixels added around shape bounds for line rasterization */
+
+/*!
+ * @brief Box struct, the pixels from left to right and bottom to top, inclusive
+ *
+ * A default box is empty, adding boxes to it grows it to cover all of them.
+ * The whole box covers every pixel of any window.
+ */
+struct Box
+{
+    int left = INT_MAX;     /*!< the leftmost pixel column */
+    int bottom = INT_MAX;   /*!< the lowest pixel row */
+    int right = INT_MIN;    /*!< the rightmost pixel column */
+    int top = INT_MIN;      /*!< the highest pixel row */
+
+    Box() {}
+
+    /// the box around two corners in any order, grown by a margin on every side
+    Box(int x0, int y0, int x1, int y1, int margin = BOX_MARGIN)
+    {
+        left = (x0 < x1 ? x0 : x1) - margin;
+        right = (x0 < x1 ? x1 : x0) + margin;
+        bottom = (y0 < y1 ? y0 : y1) - margin;
+        top = (y0 < y1 ? y1 : y0) + margin;
+    }
+
+    /// returns a box covering every pixel
+    static Box whole()
+    {
+        return Box(INT_MIN / 2, INT_MIN / 2, INT_MAX / 2, INT_MAX / 2, 0);
+    }
+
+    /// true if the box holds no pixels
+    bool empty() const { return left > right || bottom > top; }
+
+    /// true if the box covers every pixel
+    bool isWhole() const { return left <= INT_MIN / 2 && bottom <= INT_MIN / 2 &&
+                                  right >= INT_MAX / 2 && top >= INT_MAX / 2; }
+
+    /// true if the two boxes share a pixel
+    bool intersects(const Box &other) const
+    {
+        return left <= other.right && other.left <= right &&
+               bottom <= other.top && other.bottom <= top;
+    }
+
+    /// grows the box to also cover another one
+    void add(const Box &other)
+    {
+        if (other.left < left) left = other.left;
+        if (other.bottom < bottom) bottom = other.bottom;
+        if (other.right > right) right = other.right;
+        if (other.top > top) top = other.top;
+    }
+};
+
+#endif
@@ -3,21 +3,59 @@
 * @brief Cpp file including functions for the callbacks.h, holds all the functions which are used
 * as callback functions for the OpenGL event chain. Examples include keyboard callback, display callback,
 * and mouse click callback
+*
+* Every callback builds its event on the stack and posts its compact record to
+* the scene thread, so no input event ever touches the heap and no callback
+* waits on shape code. Mouse motion goes through an InputCoalescer so that a
+* burst of motion costs one event per frame. The frame timer draws whatever
+* frame the scene thread published last.
 ******************************************************************************/
 
 #include "callbacks.h"
+#include "coalescer.h"
+#include "scene.h"
+
+static InputCoalescer coalescer;   // holds back mouse motion until the next frame
+static bool redrawPosted = false;  // set while a redisplay posted by the frame timer is pending
+static int windowHeight = -1;      // window height from the last reshape, -1 before the first
+
+/** **************************************************************************
+ * @brief Frame timer callback
+ *
+ * Delivers the newest held back mouse motion, applies any new window title and
+ * posts a redisplay if the scene thread published a new frame, then rearms
+ * itself at the frame rate cap
+ *
+ * @param[in] value - unused timer value
+ ******************************************************************************/
+void frameTick(int value)
+{
+   coalescer.flush();
+   updateWindowTitle();
+   if (frameReady())
+   {
+      redrawPosted = true;
+      glutPostRedisplay();
+   }
+   glutTimerFunc(frameInterval(), frameTick, 0);
+}
 
 /** **************************************************************************
  * @brief returns the actual y location 
  *
- * This will take a y value and subtract it from Glut's value of the window
+ * This will take a y value and subtract it from the height of the window
  * This is to transfer glut's y to our own representation
+ *
+ * The height is the one reshape last reported, glut is only asked for it if
+ * an input event arrives before the first reshape
  * 
  * @param[in] y - Our y value/location to be modified according to glut's y location
  ******************************************************************************/
 int actualY(int y)
 {
-   return glutGet(GLUT_WINDOW_HEIGHT) - y;
+   if (windowHeight < 0)
+      windowHeight = glutGet(GLUT_WINDOW_HEIGHT);
+   return windowHeight - y;
 }
 
 /** **************************************************************************
@@ -29,12 +67,15 @@ int actualY(int y)
  ******************************************************************************/
 void keyboard(unsigned char key, int x, int y)
 {
-      if (key == 27)
+   // close program if "ESC", "q" or ctrl-q pressed
+   if (key == 27 || key == 'q' || key == 17)
    {
       glutLeaveMainLoop();
       return;
    }
-   utilityCentral(new KeyPress(key, x, actualY(y)));
+   coalescer.flush();
+   KeyPress press(key, x, actualY(y));
+   postEvent(press);
 }
 
 /** **************************************************************************
@@ -47,29 +88,35 @@ void keyboard(unsigned char key, int x, int y)
  ******************************************************************************/
 void mouseClick(int button, int state, int x, int y)
 {
-   utilityCentral(new MouseClick(button, state, x, actualY(y)));
+   coalescer.flush();
+   MouseClick click(button, state, x, actualY(y));
+   postEvent(click);
 }
 
 /** **************************************************************************
  * @brief Mouse drag callback function
  *
+ * The drag is held back until the next frame, only the newest one is dispatched
+ *
  * @param[in] x - x location where the mouse was dragged to
  * @param[in] y - y location where the mouse was dragged to
  ******************************************************************************/
 void mouseDrag(int x, int y)
 {
-   utilityCentral(new MouseDrag(x, actualY(y)));
+   coalescer.drag(x, actualY(y));
 }
 
 /** **************************************************************************
  * @brief Passive mouse move callback function
  *
+ * The move is held back until the next frame, only the newest one is dispatched
+ *
  * @param[in] x - x location where the mouse is located
  * @param[in] y - y location where the mouse is located
  ******************************************************************************/
 void mouseMove(int x, int y)
 {
-   utilityCentral(new MouseMove(x, actualY(y)));
+   coalescer.move(x, actualY(y));
 }
 
 /** **************************************************************************
@@ -77,11 +124,24 @@ void mouseMove(int x, int y)
  *
  * This event should occur whenever anything is done with the display i.e. a refresh
  * 
- * It will clear the screen, redraw all the stored shapes, redraw the toolbox, and swap buffers
+ * It draws the damaged area of the newest frame published by the scene
+ * thread. It runs once per posted redisplay however many events went into
+ * that frame.
+ *
+ * A frame only redraws what changed, so when the window system asks for a
+ * repaint, i.e. the window was uncovered, a display event is posted and the
+ * scene thread damages the whole canvas for the next frame
  ******************************************************************************/
 void display()
 {
-   utilityCentral(new Display());
+   if (!redrawPosted)
+   {
+      coalescer.flush();
+      Display refresh;
+      postEvent(refresh);
+   }
+   redrawPosted = false;
+   presentFrame();
 }
 
 /** **************************************************************************
@@ -92,6 +152,7 @@ void display()
  ******************************************************************************/
 void reshape(const int w, const int h)
 {
+    windowHeight = h;
     glMatrixMode( GL_PROJECTION );
     glLoadIdentity();
     // project 3d world space into 2d
@@ -99,7 +160,9 @@ void reshape(const int w, const int h)
     // point the camera at the 2d projection
     glViewport(0,0,w,h);
     // dispatch the reshape event
-    utilityCentral(new ReshapeEvent(w, h));
+    coalescer.flush();
+    ReshapeEvent resize(w, h);
+    postEvent(resize);
 }
 
 /** **************************************************************************
@@ -107,5 +170,7 @@ void reshape(const int w, const int h)
  ******************************************************************************/
 void onClose()
 {
-   utilityCentral(new CloseEvent());
+   coalescer.flush();
+   CloseEvent close;
+   postEvent(close);
 }
\ No newline at end of file
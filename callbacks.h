@@ -19,5 +19,6 @@ void mouseDrag(int x, int y);                           // Mouse Drag callback f
 void mouseMove(int x, int y);                           // Mouse Move callback function
 void reshape(const int w, const int h);                 // Window reshape callback function
 void onClose();                                         // Program close callback function
+void frameTick(int value);                              // Frame timer callback that delivers motion and posts redisplays
 
 #endif
\ No newline at end of file
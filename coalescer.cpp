@@ -0,0 +1,78 @@
+/** ***************************************************************************
+* @file
+* @brief Cpp file including functions for the coalescer.h, holds the functions
+* which collapse mouse motion bursts so only the newest position is dispatched
+* each frame
+******************************************************************************/
+
+#include "coalescer.h"
+#include "stats.h"
+#include "scene.h"
+
+/** **************************************************************************
+ * @brief Holds back a mouse drag until the next frame
+ *
+ * @param[in] x - x location where the mouse was dragged to
+ * @param[in] y - y location where the mouse was dragged to
+ ******************************************************************************/
+void InputCoalescer::drag(int x, int y)
+{
+   hold(DRAG, x, y);
+}
+
+/** **************************************************************************
+ * @brief Holds back a passive mouse move until the next frame
+ *
+ * @param[in] x - x location where the mouse is located
+ * @param[in] y - y location where the mouse is located
+ ******************************************************************************/
+void InputCoalescer::move(int x, int y)
+{
+   hold(MOVE, x, y);
+}
+
+/** **************************************************************************
+ * @brief Stores the newest motion, replacing an older one of the same kind
+ *
+ * A motion of a different kind is never dropped, the older one is delivered
+ * first so drags and moves keep their order
+ *
+ * @param[in] kind - the kind of motion being held back
+ * @param[in] x - x location of the motion
+ * @param[in] y - y location of the motion
+ ******************************************************************************/
+void InputCoalescer::hold(Pending kind, int x, int y)
+{
+   stats().motionReceived.fetch_add(1, std::memory_order_relaxed);
+
+   if (pending == kind)
+      stats().motionDropped.fetch_add(1, std::memory_order_relaxed);
+   else
+      flush();
+
+   pending = kind;
+   xLoc = x;
+   yLoc = y;
+}
+
+/** **************************************************************************
+ * @brief Delivers the held back motion to the scene thread
+ *
+ * Called once per frame, and before any click, key press or other event so
+ * that the event order seen by the scene thread is preserved
+ ******************************************************************************/
+void InputCoalescer::flush()
+{
+   if (pending == DRAG)
+   {
+      pending = NONE;
+      MouseDrag drag(xLoc, yLoc);
+      postEvent(drag);
+   }
+   else if (pending == MOVE)
+   {
+      pending = NONE;
+      MouseMove move(xLoc, yLoc);
+      postEvent(move);
+   }
+}
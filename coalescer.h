@@ -0,0 +1,34 @@
+/** ***************************************************************************
+* @file
+* @brief Header file that holds the input coalescer, which sits in front of
+* the scene thread and collapses bursts of mouse motion into one event per frame
+******************************************************************************/
+
+#ifndef __COALESCER_H
+#define __COALESCER_H
+
+#include "event.h"
+
+/*!
+ * @brief InputCoalescer class, keeps only the newest drag or move position until
+ * the next frame while letting clicks and key presses through in order
+ */
+class InputCoalescer
+{
+    /*!
+     * @brief The kind of motion event waiting to be delivered
+     */
+    enum Pending { NONE, DRAG, MOVE };
+
+    Pending pending = NONE; /*!< the kind of motion currently held back */
+    int xLoc = 0;           /*!< the x location of the held back motion */
+    int yLoc = 0;           /*!< the y location of the held back motion */
+public:
+    void drag(int x, int y);    // holds back a drag until the next frame
+    void move(int x, int y);    // holds back a move until the next frame
+    void flush();               // delivers the held back motion, if any, to the scene thread
+private:
+    void hold(Pending kind, int x, int y);  // stores the newest motion of the given kind
+};
+
+#endif
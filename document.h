@@ -0,0 +1,52 @@
+/** ***************************************************************************
+* @file
+* @brief Header file that holds the Document struct, the single context object
+* every event action works on
+******************************************************************************/
+
+#ifndef __DOCUMENT_H
+#define __DOCUMENT_H
+
+#include <vector>
+#include "menu.h"
+#include "shape.h"
+#include "selections.h"
+#include "shapestore.h"
+#include "grid.h"
+#include "shapearena.h"
+#include "zorder.h"
+#include "history.h"
+#include "snapshot.h"
+#include "box.h"
+
+/*!
+ * @brief Document struct, holds all of the state an event action may change
+ */
+struct Document
+{
+    ToolboxLayout toolbox;          /*!< where every color and tool is, for selection */
+    ShapeArena arena;               /*!< owns the shapes, declared first so it outlives them */
+    ZOrder shapes;                  /*!< the shapes in the paint area, back to front */
+    ShapeStore store;               /*!< the shapes as plain numbers, for hit testing */
+    ShapeGrid grid;                 /*!< the shapes bucketed by location, for picking */
+    SharedScene records;            /*!< the shapes as records shared with snapshots, for other threads */
+    Selections selected;            /*!< the selected values for persistence (color fills/tool type) */
+    History history;                /*!< the changes to the shapes, for undo and redo */
+    bool dirty = true;              /*!< set when the canvas no longer matches the last rendered frame */
+    bool previewing = false;        /*!< set while the shape being sized should be drawn on top */
+    bool moving = false;            /*!< set while the top shape is being dragged around */
+    bool restacked = true;          /*!< set when shapes were added, removed or reordered */
+    size_t layered = 0;             /*!< the shapes, from the back, recorded in the static layer */
+    Box damaged;                    /*!< the canvas area changed since the last rendered frame */
+    Box previewed;                  /*!< the area the preview covered in the last rendered frame */
+
+    /// marks the whole canvas as needing a new frame, the shapes may have changed in any way
+    void damage() { damage(Box::whole()); }
+    /// marks an area as needing a new frame, the shapes in it may have changed in any way
+    void damage(const Box &area) { dirty = true; damaged.add(area); previewing = false; moving = false; restacked = true; }
+    /// marks an area as needing a new frame in which only the preview or the top shape changed
+    void damageDrag(bool preview, const Box &area = Box())
+    { dirty = true; damaged.add(area); previewing = preview; moving = !preview; }
+};
+
+#endif
@@ -5,235 +5,220 @@
 ******************************************************************************/
 
 #include "draw.h"
+#include "unitcircle.h"
+
+static int windowWidth = 640;     // last window width reported by reshape
+static int windowHeight = 480;    // last window height reported by reshape
+
+/**
+ * @brief Saves the window size so the toolbox can be laid out without asking glut
+ *
+ * @param[in] width - the width of the window in pixels
+ * @param[in] height - the height of the window in pixels
+ */
+void setWindowSize(int width, int height)
+{
+   windowWidth = width;
+   windowHeight = height;
+}
+
+/**
+ * @brief Returns the window size saved from reshape, 640 by 480 before any
+ *
+ * @param[out] width - the width of the window in pixels
+ * @param[out] height - the height of the window in pixels
+ */
+void getWindowSize(int &width, int &height)
+{
+   width = windowWidth;
+   height = windowHeight;
+}
 
 /**
  * @brief The main toolbox/pallete draw function
  * 
- * It will take in a vector of menu items, then populate that vector after
+ * It will lay the toolbox out for the window size into the layout table,
+ * then draw it from the table
  * 
  * 1 Drawing the pallette framework
- * 2 Drawing the color items and adding them to the menu items
- * 3 Drawing the tool items and adding them to the menu items
+ * 2 Drawing the color items
+ * 3 Drawing the tool items
  * 
  * If the program window shrinks to below its initial size, the toolbox will not scale down anymore
  * This is preferable to unlimited scaling to small sizes
  * 
- * @param[in,out] menuItems - A vector storing all menuitems (colors and tools) for selection
+ * It is only called when the window size changes, the recorded toolbox is
+ * kept and drawn over every frame until then
+ * 
+ * @param[in,out] toolbox - The layout table the cells are looked up in for selection
+ * @param[in,out] list - The sink the toolbox is drawn into
+ *
+ * @returns the pixels the toolbox covers, its title included
  */
-void mainPalleteDraw(vector<MenuItem *> &menuItems)
+Box mainPalleteDraw(ToolboxLayout &toolbox, RenderSink &list)
 {  
-   // clear menu items
-   menuItems.clear();
-
-   // set minimum window height and width for scaling
-   int windowHeight = glutGet(GLUT_WINDOW_HEIGHT);
-   int windowWidth = glutGet(GLUT_WINDOW_WIDTH);
-   if (windowHeight < 480)
-      windowHeight = 480;
-   if (windowWidth < 640)
-      windowWidth = 640;
-   int toolHeight = windowHeight / 13;
+   // set minimum window height for scaling
+   int height = windowHeight;
+   if (height < 480)
+      height = 480;
+   int toolHeight = height / 13;
+   toolbox.layout(toolHeight);
 
    // draw toolbox, colors, and tools
-   DrawPallette(toolHeight);
-   DrawColors(toolHeight, menuItems);
-   DrawTools(toolHeight, menuItems);
+   DrawPallette(toolHeight, list);
+   DrawColors(toolbox, list);
+   DrawTools(toolHeight, list);
+   // the title is one line of 8 by 13 pixel characters and may be wider than the toolbox
+   int titleWidth = int(strlen(TOOLBAR)) * 8;
+   return Box(0, 0, titleWidth > 101 ? titleWidth : 101, 12 * toolHeight + 13);
 }
 
 /** **************************************************************************
  * @brief Draws the framework for the toolbox/pallette
  *
  * @param[in] toolHeight - The height of the menu/tool items in the toolbox
+ * @param[in,out] list - The sink the toolbox is drawn into
  ******************************************************************************/
-void DrawPallette(int toolHeight)
+void DrawPallette(int toolHeight, RenderSink &list)
 {
    // Background
-   glColor3fv(WHITE);
-   glBegin(GL_POLYGON);
-      glVertex2f(0, 0);
-      glVertex2f(101, 0);
-      glVertex2f(101, 12 * toolHeight);
-      glVertex2f(0, 12 * toolHeight);
-   glEnd();
+   list.color(WHITE);
+   list.begin(GL_POLYGON);
+      list.vertex(0, 0);
+      list.vertex(101, 0);
+      list.vertex(101, 12 * toolHeight);
+      list.vertex(0, 12 * toolHeight);
+   list.end();
 
    //Text at top
-   int length = strlen(TOOLBAR);
-   glRasterPos2f(0, 12 * toolHeight);
-   for (int i = 0; i < length; i++)
-   glutBitmapCharacter (GLUT_BITMAP_8_BY_13, TOOLBAR[i]);
+   list.text(0, 12 * toolHeight, TOOLBAR);
 
    //Half Divider
-   glColor3fv(BLACK);
-   glBegin(GL_LINES);
-      glVertex2f(50, 0);
-      glVertex2f(50, 12 * toolHeight);
-   glEnd();
+   list.color(BLACK);
+   list.begin(GL_LINES);
+      list.vertex(50, 0);
+      list.vertex(50, 12 * toolHeight);
+   list.end();
 
    //Tool Brackets
    float dividerHeight = 8 *toolHeight;
    for (int i = 0; i < 4; i++)
    {
-      glBegin(GL_LINES);
-         glVertex2f(0, dividerHeight);
-         glVertex2f(101, dividerHeight);
-      glEnd();
+      list.begin(GL_LINES);
+         list.vertex(0, dividerHeight);
+         list.vertex(101, dividerHeight);
+      list.end();
       dividerHeight += toolHeight;
    }
 }
 
 /**
- * @brief Draws and saves the color items in the toolbox
+ * @brief Draws the color items in the toolbox where the layout table puts them
  *
- * @param[in] toolHeight - The height of the menu/tool items in the toolbox
- * @param[in,out] menuItems - The vector of menuItems where all the color items will be saved
+ * @param[in] toolbox - The layout table holding the cell of every color
+ * @param[in,out] list - The sink the colors are drawn into
  */
-void DrawColors(int toolHeight, vector<MenuItem *> &menuItems)
+void DrawColors(const ToolboxLayout &toolbox, RenderSink &list)
 {
-   // LEFT COLORS
-   drawMenuColor(1,49,0,toolHeight,WHITE,menuItems);
-   drawMenuColor(1,49,toolHeight,2*toolHeight,RED,menuItems);
-   drawMenuColor(1,49,2*toolHeight,3*toolHeight,ORANGE,menuItems);
-   drawMenuColor(1,49,3*toolHeight,4*toolHeight,YELLOW,menuItems);
-   drawMenuColor(1,49,4*toolHeight,5*toolHeight,GREEN,menuItems);
-   drawMenuColor(1,49,5*toolHeight,6*toolHeight,BLUE,menuItems);
-   drawMenuColor(1,49,6*toolHeight,7*toolHeight,PURPLE,menuItems);
-   drawMenuColor(1,49,7*toolHeight,8*toolHeight,GRAY,menuItems);
-   // RIGHT COLORS
-   drawMenuColor(50,100,0,toolHeight,BLACK,menuItems);
-   drawMenuColor(50,100,toolHeight,2*toolHeight,DARKRED,menuItems);
-   drawMenuColor(50,100,2*toolHeight,3*toolHeight,DARKORANGE,menuItems);
-   drawMenuColor(50,100,3*toolHeight,4*toolHeight,DARKYELLOW,menuItems);
-   drawMenuColor(50,100,4*toolHeight,5*toolHeight,DARKGREEN,menuItems);
-   drawMenuColor(50,100,5*toolHeight,6*toolHeight,DARKBLUE,menuItems);
-   drawMenuColor(50,100,6*toolHeight,7*toolHeight,DARKPURPLE,menuItems);
-   drawMenuColor(50,100,7*toolHeight,8*toolHeight,DARKGRAY,menuItems);
+   for (int item = FIRST_COLOR_ITEM; item < FIRST_TOOL_ITEM; item++)
+   {
+      const Box &cell = toolbox.area(PaletteItem(item));
+      drawMenuColor(cell.left, cell.right, cell.bottom, cell.top, itemColor(PaletteItem(item)), list);
+   }
 }
 
 /**
- * @brief Draws a rectangle for the menu colors based off information passed and saves them as a MenuItem
+ * @brief Draws a rectangle for the menu colors based off information passed
  * 
  * @param xStart  - starting x location of the color box
  * @param xEnd    - ending x location of the color box 
  * @param yStart  - starting y location of the color box
  * @param yEnd    - ending y location of the color box
  * @param color   - color value of the drawn color box
- * @param menuItems  - vector containing saved menu items and their locations/properties 
+ * @param list    - sink the color box is drawn into
  */
-void drawMenuColor(int xStart, int xEnd, int yStart, int yEnd, const float color[],vector<MenuItem *> &menuItems)
+void drawMenuColor(int xStart, int xEnd, int yStart, int yEnd, const float color[], RenderSink &list)
 {
-   glColor3fv(color);
-   glBegin(GL_POLYGON);
-      glVertex2f(xStart, yStart);
-      glVertex2f(xEnd, yStart);
-      glVertex2f(xEnd, yEnd);
-      glVertex2f(xStart, yEnd);
-   glEnd();
-   menuItems.push_back(new Color(xStart,xEnd,yStart,yEnd,color));
+   list.color(color);
+   list.begin(GL_POLYGON);
+      list.vertex(xStart, yStart);
+      list.vertex(xEnd, yStart);
+      list.vertex(xEnd, yEnd);
+      list.vertex(xStart, yEnd);
+   list.end();
 }
 
 /** **************************************************************************
- * @brief Draws and saves the tools in the toolbox
+ * @brief Draws the tools in the toolbox
  *
  * @param[in] toolHeight - The height of the menu/tool items in the toolbox
- * @param[in,out] menuItems - The vector of menuItems where all the tool/shape items will be saved
+ * @param[in,out] list - The sink the tools are drawn into
  ******************************************************************************/
-void DrawTools(int toolHeight, vector<MenuItem *> &menuItems)
+void DrawTools(int toolHeight, RenderSink &list)
 {
-      glColor3fv( BLACK );       // Unfilled Square
-   glBegin(GL_LINE_LOOP);
-      glVertex2f(5, 8 * toolHeight + 4);
-      glVertex2f(45, 8 * toolHeight + 4);
-      glVertex2f(45, 8 * toolHeight + (toolHeight / 1.15));
-      glVertex2f(5, 8 * toolHeight + (toolHeight / 1.15));
-      glVertex2f(5, 8 * toolHeight + 4);
-      glVertex2f(5, 8 * toolHeight + (toolHeight / 1.15));
-      glVertex2f(45, 8 * toolHeight + (toolHeight / 1.15));
-      glVertex2f(45, 8 * toolHeight + 4);           
-   glEnd();
-   menuItems.push_back(new Tool(0,49,8 * toolHeight,9 * toolHeight,"unfilledSquare"));
-
-      glColor3fv(GRAY);             // Filled Square
-   glBegin(GL_POLYGON);
-      glVertex2f(55, 8 * toolHeight + 4);
-      glVertex2f(95, 8 * toolHeight + 4);
-      glVertex2f(95, 8 * toolHeight + (toolHeight / 1.15));
-      glVertex2f(55, 8 * toolHeight + (toolHeight / 1.15));
-   glEnd();
-
-      glColor3fv( RED );   
-   glBegin(GL_LINE_LOOP);
-      glVertex2f(55, 8 * toolHeight + 4);
-      glVertex2f(95, 8 * toolHeight + 4);
-      glVertex2f(95, 8 * toolHeight + (toolHeight / 1.15));
-      glVertex2f(55, 8 * toolHeight + (toolHeight / 1.15));
-      glVertex2f(55, 8 * toolHeight + 4);
-      glVertex2f(55, 8 * toolHeight + (toolHeight / 1.15));
-      glVertex2f(95, 8 * toolHeight + (toolHeight / 1.15));
-      glVertex2f(95, 8 * toolHeight + 4);           
-   glEnd();
-   menuItems.push_back(new Tool(50,100,8 * toolHeight,9 * toolHeight,"filledSquare"));
-
-   float theta;                
-      glColor3fv(BLACK);      // Unfilled Circle
-   glBegin(GL_LINE_LOOP);
-   for(int i = 0; i < 360; i++)
-   {
-      theta = i * 3.142 / 180;
-      glVertex2f(25 + 15*cos(theta), (9 * toolHeight + (toolHeight / 2)) + 15*sin(theta));
-   }
-   glEnd();
-   menuItems.push_back(new Tool(0,49,9 * toolHeight,10 * toolHeight,"unfilledCircle"));
-
-      glColor3fv(GRAY); // Filled Circle
-   glBegin(GL_POLYGON);
-   for(int i = 0; i < 360; i++)
-   {
-      theta = i * 3.142 / 180;
-      glVertex2f(75 + 15*cos(theta), (9 * toolHeight + (toolHeight / 2)) + 15*sin(theta));
-   }
-   glEnd();
-      glColor3fv(RED);
-   glBegin(GL_LINE_LOOP);
-   for(int i = 0; i < 360; i++)
-   {
-      theta = i * 3.142 / 180;
-      glVertex2f(75 + 15*cos(theta), (9 * toolHeight + (toolHeight / 2)) + 15*sin(theta));
-   }
-   glEnd();
-   menuItems.push_back(new Tool(50,100,9 * toolHeight,10 * toolHeight,"filledCircle"));
+      list.color( BLACK );       // Unfilled Square
+   list.begin(GL_LINE_LOOP);
+      list.vertex(5, 8 * toolHeight + 4);
+      list.vertex(45, 8 * toolHeight + 4);
+      list.vertex(45, 8 * toolHeight + (toolHeight / 1.15));
+      list.vertex(5, 8 * toolHeight + (toolHeight / 1.15));
+      list.vertex(5, 8 * toolHeight + 4);
+      list.vertex(5, 8 * toolHeight + (toolHeight / 1.15));
+      list.vertex(45, 8 * toolHeight + (toolHeight / 1.15));
+      list.vertex(45, 8 * toolHeight + 4);           
+   list.end();
+
+      list.color(GRAY);             // Filled Square
+   list.begin(GL_POLYGON);
+      list.vertex(55, 8 * toolHeight + 4);
+      list.vertex(95, 8 * toolHeight + 4);
+      list.vertex(95, 8 * toolHeight + (toolHeight / 1.15));
+      list.vertex(55, 8 * toolHeight + (toolHeight / 1.15));
+   list.end();
+
+      list.color( RED );   
+   list.begin(GL_LINE_LOOP);
+      list.vertex(55, 8 * toolHeight + 4);
+      list.vertex(95, 8 * toolHeight + 4);
+      list.vertex(95, 8 * toolHeight + (toolHeight / 1.15));
+      list.vertex(55, 8 * toolHeight + (toolHeight / 1.15));
+      list.vertex(55, 8 * toolHeight + 4);
+      list.vertex(55, 8 * toolHeight + (toolHeight / 1.15));
+      list.vertex(95, 8 * toolHeight + (toolHeight / 1.15));
+      list.vertex(95, 8 * toolHeight + 4);           
+   list.end();
+
+      list.color(BLACK);      // Unfilled Circle
+   list.begin(GL_LINE_LOOP);
+      traceEllipse(list, 25, 9 * toolHeight + (toolHeight / 2), 15, 15);
+   list.end();
+
+      list.color(GRAY); // Filled Circle
+   list.begin(GL_POLYGON);
+      traceEllipse(list, 75, 9 * toolHeight + (toolHeight / 2), 15, 15);
+   list.end();
+      list.color(RED);
+   list.begin(GL_LINE_LOOP);
+      traceEllipse(list, 75, 9 * toolHeight + (toolHeight / 2), 15, 15);
+   list.end();
               
-      glColor3fv(BLACK);      // Unfilled Ellipse
-   glBegin(GL_LINE_LOOP);
-   for(int i = 0; i < 360; i++)
-   {
-      theta = i * 3.142 / 180;
-      glVertex2f(25 + 22*cos(theta), (10 * toolHeight + (toolHeight / 2)) + 15*sin(theta));
-   }
-   glEnd();
-   menuItems.push_back(new Tool(0,49,10 * toolHeight,11 * toolHeight,"unfilledEllipse"));
-
-      glColor3fv(GRAY); // Filled Ellipse
-   glBegin(GL_POLYGON);
-   for(int i = 0; i < 360; i++)
-   {
-      theta = i * 3.142 / 180;
-      glVertex2f(75 + 22*cos(theta), (10 * toolHeight + (toolHeight / 2)) + 15*sin(theta));
-   }
-   glEnd();
-      glColor3fv(RED);
-   glBegin(GL_LINE_LOOP);
-   for(int i = 0; i < 360; i++)
-   {
-      theta = i * 3.142 / 180;
-      glVertex2f(75 + 22*cos(theta), (10* toolHeight + (toolHeight / 2)) + 15*sin(theta));
-   }
-   glEnd();
-   menuItems.push_back(new Tool(50,100,10 * toolHeight,11 * toolHeight,"filledEllipse"));
-
-      glColor3fv(BLACK);   // Line
-   glBegin(GL_LINE_LOOP);
-      glVertex2f(3, 12 * toolHeight - 3);
-      glVertex2f( 47, 11 * toolHeight + 3);          
-   glEnd();
-   menuItems.push_back(new Tool(0,50,11 * toolHeight,12 * toolHeight,"line"));
+      list.color(BLACK);      // Unfilled Ellipse
+   list.begin(GL_LINE_LOOP);
+      traceEllipse(list, 25, 10 * toolHeight + (toolHeight / 2), 22, 15);
+   list.end();
+
+      list.color(GRAY); // Filled Ellipse
+   list.begin(GL_POLYGON);
+      traceEllipse(list, 75, 10 * toolHeight + (toolHeight / 2), 22, 15);
+   list.end();
+      list.color(RED);
+   list.begin(GL_LINE_LOOP);
+      traceEllipse(list, 75, 10 * toolHeight + (toolHeight / 2), 22, 15);
+   list.end();
+
+      list.color(BLACK);   // Line
+   list.begin(GL_LINE_LOOP);
+      list.vertex(3, 12 * toolHeight - 3);
+      list.vertex( 47, 11 * toolHeight + 3);          
+   list.end();
 }
@@ -10,13 +10,17 @@
 
 #include "menu.h"
 #include "graphics.h"
+#include "rendersink.h"
+#include "box.h"
 
-void mainPalleteDraw(vector<MenuItem *> &menuItems);               // main function that draws the toolbox
-void DrawPallette(int toolHeight);                                 // draws the frame for the toolbox
-void DrawColors(int toolHeight, vector<MenuItem *> &menuItems);    // draws and sets the colors in the toolbox
-void DrawTools(int toolHeight, vector<MenuItem *> &menuItems);     // draws and sets the tools in the toolbox
-// draws rectangles for the menu colors and saves them
-void drawMenuColor(int xStart, int xEnd, int yStart, int yEnd, const float color[],vector<MenuItem *> &menuItems);
+void setWindowSize(int width, int height);                          // saves the window size reported by reshape
+void getWindowSize(int &width, int &height);                        // returns the saved window size
+Box mainPalleteDraw(ToolboxLayout &toolbox, RenderSink &list);      // lays out and draws the toolbox
+void DrawPallette(int toolHeight, RenderSink &list);                // draws the frame for the toolbox
+void DrawColors(const ToolboxLayout &toolbox, RenderSink &list);    // draws the colors in the toolbox
+void DrawTools(int toolHeight, RenderSink &list);                   // draws the tools in the toolbox
+// draws rectangles for the menu colors
+void drawMenuColor(int xStart, int xEnd, int yStart, int yEnd, const float color[], RenderSink &list);
 
 
 #endif
@@ -5,49 +5,109 @@
 ******************************************************************************/
 
 #include "event.h"
+#include "scene.h"
+#include "scenefile.h"
 
 /** **************************************************************************
- * @brief Default constructor for the abstract event class
- ******************************************************************************/
-Event::Event () {}
-
-/** **************************************************************************
- * @brief The pure virtual event action function
+ * @brief Records the damaged part of the canvas and hands it to the glut thread
+ *
+ * The frame holds the stored shapes that overlap the damaged area, then the
+ * shape being sized (if any). The glut thread only redraws that area, the
+ * rest of the window keeps what the earlier frames drew. The toolbox is not
+ * part of the frame, it is kept separately and drawn on top.
+ * Actions never call this, they only mark the document as damaged, and the
+ * frame scheduler calls it at most once per frame however many events
+ * arrived in between.
+ *
+ * The preview is damage of its own, where it was in the last frame and
+ * where it is now, so sizing a shape only redraws around it.
  *
- * It will be used to force every inherited class to make a version of the action function
+ * While a shape is sized or moved the shapes that stay put are recorded once
+ * into a static layer, which the glut thread renders into an offscreen
+ * buffer. Every drag frame after that only records the live shape, so its
+ * cost does not depend on how many shapes are on the canvas.
  *
- * @param[in,out] events - A vector storing various program events to be saved and called
- * @param[in,out] menuItems - A vector storing all menuitems (colors and tools) for selection
- * @param[in,out] selected - A class which holds all selected values for persistence (color fills/tool type)
- * @param[in,out] shapes - A vector of storing shapes and their properties in the paint area
+ * @param[in,out] doc - The document holding the menu items, shapes and selections
  ******************************************************************************/
-void Event::action(vector<Event *> &events, vector<MenuItem *> &menuItems, vector<Shape *> &shapes, Selections &selected) {}
+void renderScene(Document &doc)
+{
+   ZOrder &shapes = doc.shapes;
+   size_t still = 0;   // shapes, from the back, that do not change this frame
+   if(doc.previewing)
+      still = shapes.size();
+   else if(doc.moving && shapes.size() != 0)
+      still = shapes.size() - 1;
+
+   Box preview;
+   const Tool *tool = doc.previewing ? toolFor(doc.selected.getTool()) : nullptr;
+   ToolDrag drag = doc.selected.getDrag();
+   if(tool != nullptr)
+      preview = tool->preview(drag, nullptr);
+   doc.damaged.add(doc.previewed);   // erase the preview where it was
+   doc.damaged.add(preview);
+   doc.previewed = preview;
+
+   if(still == 0 ? doc.layered != 0 : doc.restacked || still != doc.layered)
+   {
+      RenderList &layer = beginLayer();
+      size_t i = 0;
+      for(ZOrder::const_iterator at = shapes.begin(); i < still; ++at, i++)
+         (*at)->draw(layer);
+      publishLayer();
+      doc.layered = still;
+      doc.restacked = false;
+   }
+
+   Box area = doc.damaged;
+   RenderList &frame = beginFrame(area);
+   bool whole = area.isWhole();
+   size_t i = 0;
+   for(Shape *shape : shapes)   // draw the shapes not in the layer
+      if(i++ >= doc.layered && (whole || shape->bounds().intersects(area)))
+         shape->draw(frame);
+   if(tool != nullptr)
+      tool->preview(drag, &frame);
+   publishFrame();
+   doc.damaged = Box();
+   doc.dirty = false;
+}
 
 /** **************************************************************************
- * @brief Default destructor for the abstract shape class
+ * @brief Lays out the toolbox for the current window size and hands it over
+ *
+ * Only needed when the window size changes, every frame in between draws the
+ * same toolbox from the buffers it was uploaded to
+ *
+ * @param[in,out] doc - The document holding the menu items, shapes and selections
  ******************************************************************************/
-Event::~Event() {} // Base Deconstructor
+static void layoutToolbox(Document &doc)
+{
+   RenderList &toolbox = beginToolbox();
+   publishToolbox(mainPalleteDraw(doc.toolbox, toolbox));
+}
 
 /** **************************************************************************
  * @brief The display action
  *
  * This event should occur whenever anything is done with the display i.e. a refresh
  * 
- * It will clear the screen, redraw all the stored shapes, redraw the toolbox, and swap buffers
+ * It marks the whole canvas as damaged, the next frame redraws all the stored
+ * shapes and the toolbox
  *
- * @param[in,out] events - A vector storing various program events to be saved and called
- * @param[in,out] menuItems - A vector storing all menuitems (colors and tools) for selection
- * @param[in,out] selected - A class which holds all selected values for persistence (color fills/tool type)
- * @param[in,out] shapes - A vector of storing shapes and their properties in the paint area
+ * @param[in,out] doc - The document holding the menu items, shapes and selections
  ******************************************************************************/
-void Display::action(vector<Event *> &events, vector<MenuItem *> &menuItems, vector<Shape *> &shapes, Selections &selected)
+void Display::action(Document &doc) const
 {
-   glClear(GL_COLOR_BUFFER_BIT);          // clear screen
-   for(int i = 0; i < int(shapes.size()); i++)  // redraw all the shapes
-      shapes[i]->draw();
+   doc.damage();      // redraw all the shapes and menu items
+}
 
-   mainPalleteDraw(menuItems);            // redraw all the menu items
-   glFlush();                     // swap the buffers 
+/** **************************************************************************
+ * @brief Returns the compact record of the display event
+ ******************************************************************************/
+EventRecord Display::record() const
+{
+   EventRecord rec = {0, DISPLAY_EVENT, 0, 0, 0, 0, 0};
+   return rec;
 }  
 
 /** **************************************************************************
@@ -58,21 +118,29 @@ void Display::action(vector<Event *> &events, vector<MenuItem *> &menuItems, vec
  * @param[in] c - columns (in pixels) of the window
  * @param[in] r - rows (in pixels) of the window
  ******************************************************************************/
-Init::Init(int r, int c) : columns(c), rows(r) {}
+Init::Init(int c, int r) : columns(c), rows(r) {}
 
 /** **************************************************************************
  * @brief The program initialization action
  *
  * This event should only happen once on initial startup. Clears the buffer/screen
  *
- * @param[in,out] events - A vector storing various program events to be saved and called
- * @param[in,out] menuItems - A vector storing all menuitems (colors and tools) for selection
- * @param[in,out] selected - A class which holds all selected values for persistence (color fills/tool type)
- * @param[in,out] shapes - A vector of storing shapes and their properties in the paint area
+ * @param[in,out] doc - The document holding the menu items, shapes and selections
  ******************************************************************************/
-void Init::action(vector<Event *> &events, vector<MenuItem *> &menuItems, vector<Shape *> &shapes, Selections &selected)
+void Init::action(Document &doc) const
 {
-   glClear(GL_COLOR_BUFFER_BIT); // clear screen on initialization
+   setWindowSize(columns, rows); // the window starts at the requested size
+   layoutToolbox(doc);
+   doc.damage();  // empty paint area
+}
+
+/** **************************************************************************
+ * @brief Returns the compact record of the initialization event
+ ******************************************************************************/
+EventRecord Init::record() const
+{
+   EventRecord rec = {0, INIT_EVENT, 0, 0, 0, columns, rows};
+   return rec;
 }
 
 /** **************************************************************************
@@ -90,12 +158,23 @@ ReshapeEvent::ReshapeEvent(int w, int h) : width(w), height(h) {}
  *
  * This action will occur when the screen is resized
  *
- * @param[in,out] events - A vector storing various program events to be saved and called
- * @param[in,out] menuItems - A vector storing all menuitems (colors and tools) for selection
- * @param[in,out] selected - A class which holds all selected values for persistence (color fills/tool type)
- * @param[in,out] shapes - A vector of storing shapes and their properties in the paint area
+ * @param[in,out] doc - The document holding the menu items, shapes and selections
  ******************************************************************************/
-void ReshapeEvent::action(vector<Event *> &events, vector<MenuItem *> &menuItems, vector<Shape *> &shapes, Selections &selected) {}
+void ReshapeEvent::action(Document &doc) const
+{
+   setWindowSize(width, height);    // remember the size so nothing else has to ask glut
+   layoutToolbox(doc);  // the toolbox scales with the window
+   doc.damage();
+}
+
+/** **************************************************************************
+ * @brief Returns the compact record of the reshape event
+ ******************************************************************************/
+EventRecord ReshapeEvent::record() const
+{
+   EventRecord rec = {0, RESHAPE_EVENT, 0, 0, 0, width, height};
+   return rec;
+}
 
 /** **************************************************************************
  * @brief Constructor for the key press action
@@ -111,26 +190,24 @@ KeyPress::KeyPress(unsigned char k, int x, int y) : key(k), xLoc(x), yLoc(y) {}
  *
  * This event checks for the key that was pressed.
  * If c:        Clear screen
- * If q or ESC: Exit program
+ * If d:        Delete the selected shape
+ * If b:        Send the selected shape to the back
+ * If [ or ]:   Lower or raise the selected shape by one
+ * If z or y:   Undo or redo the last change to the shapes (also ctrl+z, ctrl+y)
+ * If s:        Save the shapes to the scene file
  *
- * @param[in,out] events - A vector storing various program events to be saved and called
- * @param[in,out] menuItems - A vector storing all menuitems (colors and tools) for selection
- * @param[in,out] selected - A class which holds all selected values for persistence (color fills/tool type)
- * @param[in,out] shapes - A vector of storing shapes and their properties in the paint area
+ * @param[in,out] doc - The document holding the menu items, shapes and selections
  ******************************************************************************/
-void KeyPress::action(vector<Event *> &events, vector<MenuItem *> &menuItems, vector<Shape *> &shapes, Selections &selected)
+void KeyPress::action(Document &doc) const
 {
-   // close program if "ESC" or "q" pressed
-   if (key == 17 || key == 113)
-      glutLeaveMainLoop();
+   ZOrder &shapes = doc.shapes;
+
+   // "ESC" and "q" close the program in the keyboard callback, on the glut thread
    // clear shapes if "c" pressed
-   else if (key == 'c')
+   if (key == 'c')
    {
-      events.clear();
-      shapes.clear();
-      glClear(GL_COLOR_BUFFER_BIT);
-      mainPalleteDraw(menuItems);
-      glFlush();
+      doc.history.clear(doc);   // the shapes are kept, not copied, until it can not be undone
+      doc.damage();
       return;
    }
    // delete selected shape if "d" pressed
@@ -138,26 +215,51 @@ void KeyPress::action(vector<Event *> &events, vector<MenuItem *> &menuItems, ve
    {
       if(shapes.size() != 0)
       {
-         shapes.pop_back();
-         glClear(GL_COLOR_BUFFER_BIT);
-         mainPalleteDraw(menuItems);
-         for(int i = 0; i < int(shapes.size()); i++)  // redraw all the shapes
-            shapes[i]->draw();
-         glFlush();
+         doc.damage(doc.history.remove(doc, shapes.top()));   // only the area it covered changes
+      }
+   }
+   // restack the selected shape if "b", "[" or "]" pressed
+   else if (key == 'b' || key == '[' || key == ']')
+   {
+      Shape *shape = doc.selected.getSelectedShape(doc.arena);
+      if(shape != nullptr && shapes.contains(shape))
+      {
+         Restack how = key == 'b' ? TO_BACK : key == ']' ? RAISE : LOWER;
+         doc.damage(doc.history.restack(doc, shape, how));   // only where it overlaps others changes
       }
    }
+   // save the shapes if "s" pressed, nothing on the canvas changes
+   else if (key == 's')
+   {
+      if(!saveScene(scenePath(), doc))
+         cerr << "cannot save scene " << scenePath() << "\n";
+   }
+   // undo or redo if "z" or "y" (or ctrl+z, ctrl+y) pressed
+   else if (key == 'z' || key == 26)
+   {
+      doc.damage(doc.history.undo(doc));
+   }
+   else if (key == 'y' || key == 25)
+   {
+      doc.damage(doc.history.redo(doc));
+   }
    // if any other key pressed, refresh
    else
    {
-      glClear(GL_COLOR_BUFFER_BIT);
-      mainPalleteDraw(menuItems);
-      for(int i = 0; i < int(shapes.size()); i++)  // redraw all the shapes
-         shapes[i]->draw();
-      glFlush();
+      doc.damage();
    }
 
 }
 
+/** **************************************************************************
+ * @brief Returns the compact record of the key press event
+ ******************************************************************************/
+EventRecord KeyPress::record() const
+{
+   EventRecord rec = {0, KEY_EVENT, key, 0, 0, xLoc, yLoc};
+   return rec;
+}
+
 /** **************************************************************************
  * @brief Constructor for the mouse click action
  *
@@ -177,17 +279,17 @@ button(but), state(stat), xLoc(x), yLoc(y) {}
  * Left clicking in paint area draws the selected shape with selected colors
  * Right clicking in toolbox selects border color
  *
- * @param[in,out] events - A vector storing various program events to be saved and called
- * @param[in,out] menuItems - A vector storing all menuitems (colors and tools) for selection
- * @param[in,out] selected - A class which holds all selected values for persistence (color fills/tool type)
- * @param[in,out] shapes - A vector of storing shapes and their properties in the paint area
+ * @param[in,out] doc - The document holding the menu items, shapes and selections
  ******************************************************************************/
-void MouseClick::action(vector<Event *> &events, vector<MenuItem *> &menuItems, vector<Shape *> &shapes, Selections &selected)
+void MouseClick::action(Document &doc) const
 {
+   ZOrder &shapes = doc.shapes;
+   Selections &selected = doc.selected;
+
    int startX = selected.getStartX();        // set starting x loc
    int startY = selected.getStartY();        // set starting y loc
-   int xSize = selected.getEndX() - startX;  // set end location to the end x minus the start x
-   int ySize = selected.getEndY() - startY;  // set end location to the end Y minus the start Y
+   Box area;   // the canvas area the click changed, if any
+   doc.history.seal(doc);   // a drag ends, or a new one starts
 
    /************************************************************************
     *                         MOUSE CLICK DOWN
@@ -200,21 +302,18 @@ void MouseClick::action(vector<Event *> &events, vector<MenuItem *> &menuItems,
       {
          selected.setLeftCLickStatus(true);
 
-         for (int i = 0; i < int(menuItems.size()); i++)
-         {
-            if(menuItems[i]->contains(xLoc,yLoc) && menuItems[i]->getType() == "color")  // If color was selected, set border
-               selected.setBorderColor(menuItems[i]->getColor());
+         PaletteItem item = doc.toolbox.itemAt(xLoc, yLoc);
+         if(isColorItem(item))  // If color was selected, set border
+            selected.setBorderColor(itemColor(item));
 
-            if(menuItems[i]->contains(xLoc,yLoc) && menuItems[i]->getType() != "color")  // If tool was selected, set tool
-            {
-               selected.setTool(menuItems[i]->getType()); // set selected tool type
-            }
+         if(isToolItem(item))  // If tool was selected, set tool
+         {
+            selected.setTool(itemTool(item)); // set selected tool type
+         }
 
-            if(xLoc > 100)
-            {
-               selected.setStartX(xLoc); selected.setStartY(yLoc);
-            }
-               
+         if(xLoc > 100)
+         {
+            selected.setStartX(xLoc); selected.setStartY(yLoc);
          }
       }
       // ************RIGHT CLICK******************
@@ -223,12 +322,10 @@ void MouseClick::action(vector<Event *> &events, vector<MenuItem *> &menuItems,
          // Right Click to save Fill Color if on toolbox
          if(xLoc < 100)
          {
-            for (int i = 0; i < int(menuItems.size()); i++)
+            PaletteItem item = doc.toolbox.itemAt(xLoc, yLoc);
+            if(isColorItem(item))
             {
-               if(menuItems[i]->contains(xLoc,yLoc) && menuItems[i]->getType() == "color")
-               {
-                  selected.setFillColor(menuItems[i]->getColor());
-               }    
+               selected.setFillColor(itemColor(item));
             }
          }
          else           // if outside toolbox, bring shape to front if clicked
@@ -236,9 +333,16 @@ void MouseClick::action(vector<Event *> &events, vector<MenuItem *> &menuItems,
             // if no shapes, return to prevent segfault
             if(shapes.size() == 0)
                return;
-            selected.bringToFront(shapes, xLoc, yLoc);
-            selected.setStartX(xLoc - selected.getSelectedShape()->getXLoc());
-            selected.setStartY(yLoc - selected.getSelectedShape()->getYLoc());
+            Shape *picked = selected.pick(doc.grid, doc.store, xLoc, yLoc);
+            if(picked != nullptr)
+               doc.history.restack(doc, picked, TO_FRONT);
+            area = shapes.top()->bounds();   // the shape brought to the front is drawn over its area
+            Shape *shape = selected.getSelectedShape(doc.arena);
+            if(shape != nullptr)   // nothing is selected once the selected shape is deleted
+            {
+               selected.setStartX(xLoc - shape->getXLoc());
+               selected.setStartY(yLoc - shape->getYLoc());
+            }
          }
       }
     
@@ -253,59 +357,20 @@ void MouseClick::action(vector<Event *> &events, vector<MenuItem *> &menuItems,
       {
          if(startX != selected.getEndX() && startY != selected.getEndY() && selected.getDragStatus() == true)
          {
+            const Tool *tool = toolFor(selected.getTool());
+            Shape *made = nullptr;   // the shape the drag sized, if the tool makes one
+            if(tool != nullptr)
+               made = tool->commit(selected.getDrag(), doc.arena);
 
-            if(selected.getTool() == "line")
-            {
-               // xSize = selected.getEndX();
-               // ySize = selected.getEndY();
-               Line line(startX, startY, ySize, xSize, selected.getBorderColor());
-               shapes.push_back(new Line(startX, startY, ySize, xSize, selected.getBorderColor()));
-               line.draw();
-            }
-
-            if(selected.getTool() == "unfilledSquare")
-            {
-               Rectangle box(startX, startY, ySize, xSize, selected.getBorderColor());
-               shapes.push_back(new Rectangle(startX, startY, ySize, xSize, selected.getBorderColor()));
-               box.draw();
-            }
-            if(selected.getTool() == "filledSquare")
-            {
-               FilledRectangle box(startX, startY, ySize, xSize, selected.getBorderColor(), selected.getFillColor());
-               shapes.push_back(new FilledRectangle(startX, startY, ySize, xSize, selected.getBorderColor(), selected.getFillColor()));
-               box.draw();
-            }
-
-            if(selected.getTool() == "unfilledCircle")
-            {
-               Circle circle(startX, startY, sqrt((pow(startX - xLoc,2) + pow(startY - yLoc,2))) ,selected.getBorderColor());
-               shapes.push_back(new Circle(startX, startY, sqrt((pow(startX - xLoc,2) + pow(startY - yLoc,2))) ,selected.getBorderColor()));
-               circle.draw();
-            }
-            if(selected.getTool() == "filledCircle")
-            {
-               FilledCircle filledCircle(startX, startY, sqrt((pow(startX - xLoc,2) + pow(startY - yLoc,2))),selected.getBorderColor(), selected.getFillColor());
-               shapes.push_back(new FilledCircle(startX, startY, sqrt((pow(startX - xLoc,2) + pow(startY - yLoc,2))),selected.getBorderColor(), selected.getFillColor()));
-               filledCircle.draw();
-            }
-
-            if(selected.getTool() == "unfilledEllipse")
-            {
-               Ellipse ellipse(selected.getEndX(), selected.getEndY(), xSize, ySize, selected.getBorderColor());
-               shapes.push_back(new Ellipse(selected.getEndX(), selected.getEndY(), xSize, ySize, selected.getBorderColor()));
-               ellipse.draw();
-            }
-            if(selected.getTool() == "filledEllipse")
-            {
-               FilledEllipse filledEllipse(selected.getEndX(), selected.getEndY(), xSize, ySize, selected.getBorderColor(), selected.getFillColor());
-               shapes.push_back(new FilledEllipse(selected.getEndX(), selected.getEndY(), xSize, ySize, selected.getBorderColor(), selected.getFillColor()));
-               filledEllipse.draw();
-            }
-
+            if(made != nullptr)   // a shape was made, put it in front and index it for picking
+               doc.history.create(doc, made);
 
             selected.setDragStatus(false);
             if(shapes.size() != 0)
-               selected.setSelectedShape(shapes.back());
+            {
+               selected.setSelectedShape(shapes.top());
+               area = shapes.top()->bounds();
+            }
 
          }
          selected.setLeftCLickStatus(false);
@@ -315,11 +380,19 @@ void MouseClick::action(vector<Event *> &events, vector<MenuItem *> &menuItems,
          selected.setDragStatus(false);
       }
    }
-   mainPalleteDraw(menuItems);
-   glFlush();
+   doc.damage(area);   // also ends any preview, its old area is erased
 
 }
 
+/** **************************************************************************
+ * @brief Returns the compact record of the mouse click event
+ ******************************************************************************/
+EventRecord MouseClick::record() const
+{
+   EventRecord rec = {0, CLICK_EVENT, uint8_t(button), uint8_t(state), 0, xLoc, yLoc};
+   return rec;
+}
+
 /** **************************************************************************
  * @brief Constructor for the mouse drag action
  *
@@ -332,17 +405,12 @@ MouseDrag::MouseDrag(int x, int y) : xLoc(x), yLoc(y) {}
  *
  * This event will occur when the mouse is clicked and dragged across the screen
  *
- * @param[in,out] events - A vector storing various program events to be saved and called
- * @param[in,out] menuItems - A vector storing all menuitems (colors and tools) for selection
- * @param[in,out] selected - A class which holds all selected values for persistence (color fills/tool type)
- * @param[in,out] shapes - A vector of storing shapes and their properties in the paint area
+ * @param[in,out] doc - The document holding the menu items, shapes and selections
  ******************************************************************************/
-void MouseDrag::action(vector<Event *> &events, vector<MenuItem *> &menuItems, vector<Shape *> &shapes, Selections &selected) 
+void MouseDrag::action(Document &doc) const
 {
-   int startX = selected.getStartX();        // set starting x location
-   int startY = selected.getStartY();        // set starting y location
-   int xSize = selected.getEndX() - startX;  // set dragged x location
-   int ySize = selected.getEndY() - startY;  // set dragged y location
+   ZOrder &shapes = doc.shapes;
+   Selections &selected = doc.selected;
 
    /************************************************************************
     *                         LEFT CLICK DRAG
@@ -352,119 +420,12 @@ void MouseDrag::action(vector<Event *> &events, vector<MenuItem *> &menuItems, v
          selected.setDragStatus(true);
 
          selected.setEndX(xLoc); selected.setEndY(yLoc);
-         
-         // If tool is line, prevent distance subtraction to draw
-         if(selected.getTool() == "line")
-         {
-            // xSize = selected.getEndX();
-            // ySize = selected.getEndY();
-            Line line(startX, startY, ySize, xSize, selected.getBorderColor());
-
-            glClear(GL_COLOR_BUFFER_BIT);
 
-            for(int i = 0; i < int(shapes.size()); i++)  // redraw all the shapes
-                  shapes[i]->draw();
-
-            line.draw();
-            mainPalleteDraw(menuItems);
-            glFlush();   
-         }
-
-         // UNFILLED RECTANGLE
-         if(selected.getTool() == "unfilledSquare")
+         // *** If no tools were selected, there is nothing to preview ***
+         if(toolFor(selected.getTool()) != nullptr)
          {
-            Rectangle box(startX, startY, ySize, xSize, selected.getBorderColor());
-
-            glClear(GL_COLOR_BUFFER_BIT);
-
-            for(int i = 0; i < int(shapes.size()); i++)  // redraw all the shapes
-                  shapes[i]->draw();
-
-            box.draw();
-            mainPalleteDraw(menuItems);
-            glFlush();   
+            doc.damageDrag(true);   // the next frame draws the sized shape on top
          }
-         // FILLED RECTANGLE
-         else if(selected.getTool() == "filledSquare")
-         {
-            FilledRectangle box(startX, startY, ySize, xSize, selected.getBorderColor(), selected.getFillColor());
-
-            glClear(GL_COLOR_BUFFER_BIT);
-            
-            for(int i = 0; i < int(shapes.size()); i++)  // redraw all the shapes
-                  shapes[i]->draw();
-
-            box.draw();
-            mainPalleteDraw(menuItems);
-            glFlush();   
-         }
-         // UNFILLED CIRCLE
-         else if(selected.getTool() == "unfilledCircle")
-         {
-            Circle circle(startX, startY, sqrt((pow(startX - xLoc,2) + pow(startY - yLoc,2))) ,selected.getBorderColor());
-
-            glClear(GL_COLOR_BUFFER_BIT);
-            
-            for(int i = 0; i < int(shapes.size()); i++)  // redraw all the shapes
-                  shapes[i]->draw();
-
-            circle.draw();
-            mainPalleteDraw(menuItems);
-            glFlush();   
-         }
-         // FILLED CIRCLE
-         else if(selected.getTool() == "filledCircle")
-         {
-            FilledCircle filledCircle(startX, startY, sqrt((pow(startX - xLoc,2) + pow(startY - yLoc,2))),selected.getBorderColor(), selected.getFillColor());
-
-            glClear(GL_COLOR_BUFFER_BIT);
-            
-            for(int i = 0; i < int(shapes.size()); i++)  // redraw all the shapes
-                  shapes[i]->draw();
-
-            filledCircle.draw();
-            mainPalleteDraw(menuItems);
-            glFlush();   
-         }
-         // UNFILLED ELLIPSE
-         else if(selected.getTool() == "unfilledEllipse")
-         {
-            Ellipse ellipse(xLoc, yLoc, xSize, ySize, selected.getBorderColor());
-
-            glClear(GL_COLOR_BUFFER_BIT);
-
-            for(int i = 0; i < int(shapes.size()); i++)  // redraw all the shapes
-                  shapes[i]->draw();
-
-            ellipse.draw();
-            mainPalleteDraw(menuItems);
-
-            glFlush();   
-         }
-         // FILLED ELLIPSE
-         else if(selected.getTool() == "filledEllipse")
-         {
-            FilledEllipse filledEllipse(xLoc, yLoc, xSize, ySize, selected.getBorderColor(), selected.getFillColor());
-
-            glClear(GL_COLOR_BUFFER_BIT);
-            
-            for(int i = 0; i < int(shapes.size()); i++)  // redraw all the shapes
-                  shapes[i]->draw();
-
-            filledEllipse.draw();
-            mainPalleteDraw(menuItems);
-
-
-            glFlush();   
-         }
-         // *** If no tools were selected, just return ***
-         else
-         {
-            return;
-         }
-         
-         
-
       }
 
 
@@ -478,28 +439,27 @@ void MouseDrag::action(vector<Event *> &events, vector<MenuItem *> &menuItems, v
          {
             if(selected.getDragStatus() == false)  // if first drag call, bring dragged shape to front
             {
-               selected.bringToFront(shapes, xLoc, yLoc);
-               selected.setStartX(xLoc - selected.getSelectedShape()->getXLoc());
-               selected.setStartY(yLoc - selected.getSelectedShape()->getYLoc());
-               if(selected.getSelectedShape()->contains(xLoc, yLoc))
+               Shape *picked = selected.pick(doc.grid, doc.store, xLoc, yLoc);
+               // only a shape that was not on top changes the shapes under the dragged one
+               if(picked != nullptr && !doc.history.restack(doc, picked, TO_FRONT).empty())
+                  doc.restacked = true;
+               Shape *shape = selected.getSelectedShape(doc.arena);
+               if(shape != nullptr)
                {
-                  selected.setDragStatus(true);
+                  selected.setStartX(xLoc - shape->getXLoc());
+                  selected.setStartY(yLoc - shape->getYLoc());
+                  if(doc.store.contains(shape->getHandle(), xLoc, yLoc))
+                  {
+                     selected.setDragStatus(true);
+                  }
                }
             }
          }
-         // move the shape and redraw
+         // move the shape and redraw, only the top shape changes
          if(selected.getLeftClickStatus() == false)
          {
-            selected.moveShape(shapes, xLoc, yLoc);
-            glClear(GL_COLOR_BUFFER_BIT);
-
-            // redraw all the shapes
-            for(int i = 0; i < int(shapes.size()); i++)  
-               shapes[i]->draw();
-            
-            shapes.back()->draw();
-            mainPalleteDraw(menuItems);
-            glFlush();
+            Box area = doc.history.move(doc, shapes.top(), xLoc - selected.getStartX(), yLoc - selected.getStartY());
+            doc.damageDrag(false, area);
          }
                   
       }
@@ -507,6 +467,15 @@ void MouseDrag::action(vector<Event *> &events, vector<MenuItem *> &menuItems, v
 
 }
 
+/** **************************************************************************
+ * @brief Returns the compact record of the mouse drag event
+ ******************************************************************************/
+EventRecord MouseDrag::record() const
+{
+   EventRecord rec = {0, DRAG_EVENT, 0, 0, 0, xLoc, yLoc};
+   return rec;
+}
+
 /** **************************************************************************
  * @brief Constructor for the passive mouse move action
  *
@@ -520,37 +489,52 @@ MouseMove::MouseMove(int x, int y) : xLoc(x), yLoc(y) {}
  * This event keeps track of the location of the mouse when passive
  * It displays the location of the mouse (Either toolbox or paint area) in the top of window
  *
- * @param[in,out] events - A vector storing various program events to be saved and called
- * @param[in,out] menuItems - A vector storing all menuitems (colors and tools) for selection
- * @param[in,out] selected - A class which holds all selected values for persistence (color fills/tool type)
- * @param[in,out] shapes - A vector of storing shapes and their properties in the paint area
+ * @param[in,out] doc - The document holding the menu items, shapes and selections
  ******************************************************************************/
-void MouseMove::action(vector<Event *> &events, vector<MenuItem *> &menuItems, vector<Shape *> &shapes, Selections &selected)
+void MouseMove::action(Document &doc) const
 {
    // if located on toolbox set area to tool box, otherwise, set area to paint area
-   stringstream ss;
    if(xLoc < 100)
-      ss << "SDSM&T Paint: Toolbox";
+      setWindowTitle("SDSM&T Paint: Toolbox");
    else
-      ss << "SDSM&T Paint: Paint Area";
-
-   glutSetWindowTitle(ss.str().c_str());
+      setWindowTitle("SDSM&T Paint: Paint Area");
 }
 
 /** **************************************************************************
- * @brief Constructor for the program close event action
+ * @brief Returns the compact record of the mouse move event
  ******************************************************************************/
-CloseEvent::CloseEvent() {}
+EventRecord MouseMove::record() const
+{
+   EventRecord rec = {0, MOVE_EVENT, 0, 0, 0, xLoc, yLoc};
+   return rec;
+}
+
 /** **************************************************************************
  * @brief The program close action
  *
  * This event occurs at the closing of the paint program, it does nothing
  *
- * @param[in,out] events - A vector storing various program events to be saved and called
- * @param[in,out] menuItems - A vector storing all menuitems (colors and tools) for selection
- * @param[in,out] selected - A class which holds all selected values for persistence (color fills/tool type)
- * @param[in,out] shapes - A vector of storing shapes and their properties in the paint area
+ * @param[in,out] doc - The document holding the menu items, shapes and selections
+ ******************************************************************************/
+void CloseEvent::action(Document &doc) const
+{
+}
+
+/** **************************************************************************
+ * @brief Returns the compact record of the program close event
+ ******************************************************************************/
+EventRecord CloseEvent::record() const
+{
+   EventRecord rec = {0, CLOSE_EVENT, 0, 0, 0, 0, 0};
+   return rec;
+}
+
+/** **************************************************************************
+ * @brief Returns the compact record of whichever event the variant holds
+ *
+ * @param[in] event - the event to record
  ******************************************************************************/
-void CloseEvent::action(vector<Event *> &events, vector<MenuItem *> &menuItems, vector<Shape *> &shapes, Selections &selected)
+EventRecord recordOf(const Event &event)
 {
+   return visit([](const auto &e) { return e.record(); }, event);
 }
@@ -1,7 +1,7 @@
 /** ***************************************************************************
 * @file
-* @brief Header file that contains class declarations for Event abstract base class and 
-* all others
+* @brief Header file that contains the event structs and the Event variant that
+* holds any one of them by value
 ******************************************************************************/
 
 #ifndef _EVENT_H_
@@ -12,76 +12,92 @@
 #include <sstream>
 #include <vector>
 #include <string>
+#include <cstdint>
+#include <variant>
 
-#include "menu.h"
-#include "shape.h"
+#include "document.h"
 #include "draw.h"
-#include "selections.h"
 
 
 using namespace std;
 
 /*!
- * @brief Abstract Base Event class, calls a virtual action and has a default constructor for program events
+ * @brief The kind of event stored in an EventRecord
  */
-class Event
+enum EventType : uint8_t
 {
-    public:
-        Event();    // Default constructor for program event
-        virtual void action(vector<Event *> &events, vector<MenuItem *> &menuItems, vector<Shape *> &shapes, Selections &selected) = 0; // does action with event, pure virtual function
-        virtual ~Event();
+    INIT_EVENT, DISPLAY_EVENT, RESHAPE_EVENT, KEY_EVENT,
+    CLICK_EVENT, DRAG_EVENT, MOVE_EVENT, CLOSE_EVENT
+};
+
+/*!
+ * @brief Compact, fixed size copy of an event, used to journal and replay events
+ */
+struct EventRecord
+{
+    uint32_t time;      /*!< microseconds since the previous record */
+    uint8_t type;       /*!< the EventType of the event */
+    uint8_t button;     /*!< the mouse button, or the key pressed */
+    uint8_t state;      /*!< the mouse button state */
+    uint8_t pad;        /*!< unused, keeps the record 16 bytes */
+    int32_t x;          /*!< the x location, or the width for size events */
+    int32_t y;          /*!< the y location, or the height for size events */
 };
 
 /*!
- * @brief Initialization Event Class
+ * @brief Initialization Event
  */
-class Init : public Event
+class Init
 {
     int columns; /*!< the columns of pixels to be initialized */
     int rows;   /*!< the rows of pixels to be initialized */
     public: 
         Init(int c, int r);
-        void action(vector<Event *> &events, vector<MenuItem *> &menuItems, vector<Shape *> &shapes, Selections &selected);
+        void action(Document &doc) const;
+        EventRecord record() const;
 };
 
 /*!
- * @brief Display Event Class
+ * @brief Display Event
  */
-class Display : public Event
+class Display
 {
     public:
-        void action(vector<Event *> &events, vector<MenuItem *> &menuItems, vector<Shape *> &shapes, Selections &selected); // refreshes the program's display
+        void action(Document &doc) const; // refreshes the program's display
+        EventRecord record() const;
 };
 
 /*!
- * @brief Window Resize Event Class
+ * @brief Window Resize Event
  */
-class ReshapeEvent : public Event
+class ReshapeEvent
 {
    int width;   /*!< the resize width in pixels */
    int height;  /*!< the resize height in pixels */
 public:
    ReshapeEvent(int w, int h);
-   void action(vector<Event *> &events, vector<MenuItem *> &menuItems, vector<Shape *> &shapes, Selections &selected);
+   void action(Document &doc) const;
+   EventRecord record() const;
 };
 
 /*!
- * @brief Keyboard Key Press Event Class
+ * @brief Keyboard Key Press Event
  */
-class KeyPress : public Event
+class KeyPress
 {
     unsigned char key;  /*!< The key pressed */
     int xLoc;           /*!< the x location of the key */
     int yLoc;           /*!< the y location of the key */
 public:
     KeyPress(unsigned char k, int x, int y); // constructor
-    void action(vector<Event *> &events, vector<MenuItem *> &menuItems, vector<Shape *> &shapes, Selections &selected);  // key action
+    void action(Document &doc) const;  // key action
+    EventRecord record() const;
 };
 
 /*!
- * @brief Mouse Click Event Class
+ * @brief Mouse Click Event
  */
-class MouseClick : public Event
+class MouseClick
 {
     int button; /*!< the mouse button that was clicked */
     int state; /*!< the button state of the click */
@@ -89,40 +105,55 @@ class MouseClick : public Event
     int yLoc; /*!< the y location of the click */
 public:
    MouseClick( int but, int stat, int x, int y); // constructor for mouse
-   void action(vector<Event *> &events, vector<MenuItem *> &menuItems, vector<Shape *> &shapes, Selections &selected);
+   void action(Document &doc) const;
+   EventRecord record() const;
 };
 
 /*!
- * @brief Mouse Drag Event Class
+ * @brief Mouse Drag Event
  */
-class MouseDrag : public Event
+class MouseDrag
 {
     int xLoc;   /*!< the x location of the drag */
     int yLoc;   /*!< the x location of the drag */
 public:
     MouseDrag(int x, int y);
-    void action(vector<Event *> &events, vector<MenuItem *> &menuItems, vector<Shape *> &shapes, Selections &selected);
+    void action(Document &doc) const;
+    EventRecord record() const;
 };
 
 /*!
- * @brief Mouse Move Event Class
+ * @brief Mouse Move Event
  */
-class MouseMove : public Event
+class MouseMove
 {
     int xLoc;   /*!< the x location of the cursor */
     int yLoc;   /*!< the x location of the cursor */
 public:
     MouseMove(int x, int y);
-    void action(vector<Event *> &events, vector<MenuItem *> &menuItems, vector<Shape *> &shapes, Selections &selected);
+    void action(Document &doc) const;
+    EventRecord record() const;
 };
 
 /*!
- * @brief Program Close Event Class
+ * @brief Program Close Event
  */
-class CloseEvent : public Event
+class CloseEvent
 {
 public:
-    CloseEvent();   // Close event constructor
-    void action(vector<Event *> &events, vector<MenuItem *> &menuItems, vector<Shape *> &shapes, Selections &selected);
+    void action(Document &doc) const;
+    EventRecord record() const;
 };
+
+/*!
+ * @brief Any one program event, held by value
+ *
+ * Dispatching with std::visit picks the action at compile time, so an event
+ * needs no heap object and no virtual call. Display is listed first so an
+ * Event can be default constructed, i.e. in the slots of a queue.
+ */
+typedef variant<Display, Init, ReshapeEvent, KeyPress, MouseClick, MouseDrag, MouseMove, CloseEvent> Event;
+
+EventRecord recordOf(const Event &event);   // returns the compact record of any event
+void renderScene(Document &doc);            // records the whole document into a frame and publishes it
 #endif
\ No newline at end of file
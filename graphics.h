@@ -31,5 +31,13 @@ const float GRAY[3] = {0.5, 0.5, 0.5};      /*!<Gray color value */
 const float DARKGRAY[3] = {0.2, 0.2, 0.2};  /*!<Dark Gray color value */
 const char TOOLBAR[20] = " Paint Tools ";   /*!<Tool character string */
 
+/*!
+ * @brief Returns whether glut has been initialized, false when running headless
+ */
+inline bool windowOpen()
+{
+    return glutGet(GLUT_INIT_STATE) != 0;
+}
+
 
 #endif
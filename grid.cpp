@@ -0,0 +1,282 @@
+/** ***************************************************************************
+* @file
+* @brief Cpp file including functions for the grid.h, holds the functions which
+* keep the shapes bucketed by location and find the shapes under a point
+******************************************************************************/
+
+#include <algorithm>
+#include "grid.h"
+
+/** **************************************************************************
+ * @brief Returns the cell a pixel coordinate falls in along one axis
+ *
+ * Rounds down for negative coordinates too, then wraps around the grid
+ *
+ * @param[in] pixel - the x or y coordinate
+ ******************************************************************************/
+static int cellOf(int pixel)
+{
+   int cell = pixel >= 0 ? pixel / GRID_CELL : -((-pixel - 1) / GRID_CELL) - 1;
+   cell %= GRID_CELLS;
+   return cell < 0 ? cell + GRID_CELLS : cell;
+}
+
+/** **************************************************************************
+ * @brief Returns the area in which a shape may contain a picked point
+ *
+ * @param[in] shape - the shape
+ ******************************************************************************/
+static Box pickArea(Shape *shape)
+{
+   Box bounds = shape->bounds();
+   return Box(bounds.left, bounds.bottom, bounds.right, bounds.top, PICK_MARGIN);
+}
+
+/** **************************************************************************
+ * @brief Constructor for an empty grid
+ ******************************************************************************/
+ShapeGrid::ShapeGrid() : cells(GRID_CELLS * GRID_CELLS) {}
+
+/** **************************************************************************
+ * @brief Calls a function with every cell a bounding box overlaps
+ *
+ * A box wider or taller than the grid overlaps every cell along that axis,
+ * each cell is visited once
+ *
+ * @param[in] bounds - the bounding box
+ * @param[in] visit - called with each overlapped cell
+ ******************************************************************************/
+template <typename Visit>
+void ShapeGrid::forCells(const Box &bounds, Visit visit)
+{
+   if(bounds.empty())
+      return;
+   long spanX = long(bounds.right) / GRID_CELL - long(bounds.left) / GRID_CELL + 2;
+   long spanY = long(bounds.top) / GRID_CELL - long(bounds.bottom) / GRID_CELL + 2;
+   int columns = spanX >= GRID_CELLS ? GRID_CELLS : int(spanX);
+   int rows = spanY >= GRID_CELLS ? GRID_CELLS : int(spanY);
+   int left = cellOf(bounds.left);
+   int bottom = cellOf(bounds.bottom);
+   int right = cellOf(bounds.right);
+   int top = cellOf(bounds.top);
+
+   for(int r = 0, y = bottom; r < rows; r++, y = (y + 1) % GRID_CELLS)
+   {
+      for(int c = 0, x = left; c < columns; c++, x = (x + 1) % GRID_CELLS)
+      {
+         visit(cells[y * GRID_CELLS + x]);
+         if(x == right && columns < GRID_CELLS)
+            break;
+      }
+      if(y == top && rows < GRID_CELLS)
+         break;
+   }
+}
+
+/** **************************************************************************
+ * @brief Adds a shape to every cell its bounding box overlaps
+ *
+ * @param[in] shape - the shape to add
+ * @param[in] where - its bounding box and depth
+ ******************************************************************************/
+void ShapeGrid::bucket(Shape *shape, const Placement &where)
+{
+   Entry entry = {shape, shape->getHandle(), where.bounds, where.depth};
+   forCells(where.bounds, [&](std::vector<Entry> &cell) { cell.push_back(entry); });
+}
+
+/** **************************************************************************
+ * @brief Removes a shape from every cell it was added to
+ *
+ * The order within a cell does not matter, the last entry takes its place
+ *
+ * @param[in] shape - the shape to remove
+ * @param[in] where - the bounding box it was added with
+ ******************************************************************************/
+void ShapeGrid::unbucket(Shape *shape, const Placement &where)
+{
+   forCells(where.bounds, [&](std::vector<Entry> &cell)
+   {
+      for(size_t i = 0; i < cell.size(); i++)
+         if(cell[i].shape == shape)
+         {
+            cell[i] = cell.back();
+            cell.pop_back();
+            break;
+         }
+   });
+}
+
+/** **************************************************************************
+ * @brief Adds a shape to the grid
+ *
+ * @param[in] shape - the shape, just added to the drawing order
+ * @param[in] depth - its depth in the drawing order
+ ******************************************************************************/
+void ShapeGrid::insert(Shape *shape, long long depth)
+{
+   Placement where = {pickArea(shape), depth};
+   placed[shape] = where;
+   bucket(shape, where);
+}
+
+/** **************************************************************************
+ * @brief Adds every shape of a drawing order to the grid at its depth
+ *
+ * The shapes are only listed, fill buckets them a batch at a time, anything
+ * else that needs them buckets the rest first.
+ *
+ * @param[in] order - the shapes, none already in the grid
+ ******************************************************************************/
+void ShapeGrid::insert(const ZOrder &order)
+{
+   placed.reserve(placed.size() + unplaced.size() + order.size());
+   unplaced.reserve(unplaced.size() + order.size());
+   for(ZOrder::const_iterator at = order.begin(); at != order.end(); ++at)
+      unplaced.emplace_back(*at, at.depth());
+}
+
+/** **************************************************************************
+ * @brief Buckets some of the shapes added in bulk, front ones first
+ *
+ * @param[in] count - the most shapes to bucket
+ *
+ * @returns true if shapes are left to bucket
+ ******************************************************************************/
+bool ShapeGrid::fill(size_t count)
+{
+   for(; count > 0 && !unplaced.empty(); count--)
+   {
+      insert(unplaced.back().first, unplaced.back().second);
+      unplaced.pop_back();
+   }
+   if(unplaced.empty())
+      unplaced.shrink_to_fit();
+   return !unplaced.empty();
+}
+
+/** **************************************************************************
+ * @brief Buckets every shape added in bulk, before they are changed or
+ * looked for
+ ******************************************************************************/
+void ShapeGrid::settle()
+{
+   fill(unplaced.size());
+}
+
+/** **************************************************************************
+ * @brief Moves a shape to the cells of its current bounding box
+ *
+ * @param[in] shape - the shape that moved or changed size
+ ******************************************************************************/
+void ShapeGrid::update(Shape *shape)
+{
+   settle();
+   auto found = placed.find(shape);
+   if(found == placed.end())
+      return;
+   Box bounds = pickArea(shape);
+   Placement &where = found->second;
+   if(bounds.left == where.bounds.left && bounds.bottom == where.bounds.bottom &&
+      bounds.right == where.bounds.right && bounds.top == where.bounds.top)
+      return;
+   unbucket(shape, where);
+   where.bounds = bounds;
+   bucket(shape, where);
+}
+
+/** **************************************************************************
+ * @brief Gives a shape its new depth after it was restacked
+ *
+ * @param[in] shape - the shape, just moved in the drawing order
+ * @param[in] depth - its new depth in the drawing order
+ ******************************************************************************/
+void ShapeGrid::restack(Shape *shape, long long depth)
+{
+   settle();
+   auto found = placed.find(shape);
+   if(found == placed.end() || found->second.depth == depth)
+      return;
+   found->second.depth = depth;
+   forCells(found->second.bounds, [&](std::vector<Entry> &cell)
+   {
+      for(size_t i = 0; i < cell.size(); i++)
+         if(cell[i].shape == shape)
+            cell[i].depth = depth;
+   });
+}
+
+/** **************************************************************************
+ * @brief Takes a shape out of the grid
+ *
+ * @param[in] shape - the shape, just removed from the document
+ ******************************************************************************/
+void ShapeGrid::remove(Shape *shape)
+{
+   settle();
+   auto found = placed.find(shape);
+   if(found == placed.end())
+      return;
+   unbucket(shape, found->second);
+   placed.erase(found);
+}
+
+/** **************************************************************************
+ * @brief Takes every shape out of the grid, the cells keep their memory
+ ******************************************************************************/
+void ShapeGrid::clear()
+{
+   for(size_t i = 0; i < cells.size(); i++)
+      cells[i].clear();
+   placed.clear();
+   unplaced.clear();
+}
+
+/** **************************************************************************
+ * @brief Finds the shapes that contain a point
+ *
+ * Only the cell under the point is looked at. The shapes whose pick area
+ * holds the point are tested against it by the store, in blocks.
+ *
+ * @param[in] x - the x location of the point
+ * @param[in] y - the y location of the point
+ * @param[in] store - the shape store holding every shape in the grid
+ * @param[out] found - the shapes containing the point, front to back, replaced
+ ******************************************************************************/
+void ShapeGrid::query(int x, int y, const ShapeStore &store, std::vector<Shape *> &found)
+{
+   settle();
+   near.clear();
+   tested.clear();
+   const std::vector<Entry> &cell = cells[cellOf(y) * GRID_CELLS + cellOf(x)];
+   for(size_t i = 0; i < cell.size(); i++)
+   {
+      const Box &bounds = cell[i].bounds;
+      if(x >= bounds.left && x <= bounds.right && y >= bounds.bottom && y <= bounds.top)
+      {
+         near.push_back(cell[i]);
+         tested.push_back(cell[i].handle);
+      }
+   }
+   hits.resize(tested.size());
+   store.hitTest(x, y, tested.data(), tested.size(), hits.data());
+
+   size_t kept = 0;
+   for(size_t i = 0; i < near.size(); i++)
+      if(hits[i])
+         near[kept++] = near[i];
+   near.resize(kept);
+   std::sort(near.begin(), near.end(), [](const Entry &a, const Entry &b) { return a.depth > b.depth; });
+
+   found.clear();
+   for(size_t i = 0; i < near.size(); i++)
+      found.push_back(near[i].shape);
+}
+
+/** **************************************************************************
+ * @brief Returns the number of shapes in the grid
+ ******************************************************************************/
+size_t ShapeGrid::size() const
+{
+   return placed.size() + unplaced.size();
+}
@@ -0,0 +1,90 @@
+/** ***************************************************************************
+* @file
+* @brief Header file that holds the ShapeGrid class, a uniform grid over the
+* bounding boxes of the shapes used to find the shapes under a point
+******************************************************************************/
+
+#ifndef __GRID_H
+#define __GRID_H
+
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "shapestore.h"
+#include "zorder.h"
+
+const int GRID_CELL = 32;       /*!< the width and height of a grid cell in pixels */
+const int GRID_CELLS = 128;     /*!< cells along each axis, the grid wraps around past them */
+const int PICK_MARGIN = 8;      /*!< pixels outside its bounding box a shape may still be picked, lines allow 7 */
+const size_t GRID_BATCH = 2048; /*!< shapes added in bulk that fill buckets at a time */
+
+/*!
+ * @brief ShapeGrid class, buckets every shape into the grid cells its bounding
+ * box overlaps so a point only has to be tested against the shapes near it
+ *
+ * The boxes are grown by PICK_MARGIN, the pick area, since a line can be
+ * picked a few pixels off it.
+ *
+ * The grid wraps around, a cell also holds the shapes of the cells a multiple
+ * of GRID_CELLS away, so any canvas size or shape location fits in a fixed
+ * number of cells. Shapes that share a cell only by wrapping are dropped by
+ * their bounding box before they are returned.
+ *
+ * Each shape carries its depth in the drawing order, updated whenever it is
+ * restacked, so the shapes under a point come back front to back without
+ * walking the drawing order. Shapes must be in the shape store before they
+ * are added, the store tests them against the point.
+ *
+ * Shapes added in bulk, a whole opened file, are only listed. They are
+ * bucketed GRID_BATCH at a time by fill, and all at once by the first other
+ * change or query that needs them, so an open does not wait on the grid.
+ */
+class ShapeGrid
+{
+    /*!
+     * @brief One shape in a grid cell
+     */
+    struct Entry
+    {
+        Shape *shape;           /*!< the shape overlapping the cell */
+        ShapeHandle handle;     /*!< its handle in the shape store */
+        Box bounds;             /*!< its pick area, so candidates are checked without it */
+        long long depth;        /*!< its depth in the drawing order, larger is in front */
+    };
+
+    /*!
+     * @brief Where a shape was put in the grid
+     */
+    struct Placement
+    {
+        Box bounds;             /*!< the pick area it was bucketed by */
+        long long depth;        /*!< its depth in the drawing order */
+    };
+
+    std::vector<std::vector<Entry>> cells;              /*!< the shapes of each cell, row by row */
+    std::unordered_map<Shape *, Placement> placed;      /*!< every shape in the grid */
+    std::vector<std::pair<Shape *, long long>> unplaced; /*!< shapes added in bulk not bucketed yet, with their depths */
+    mutable std::vector<Entry> near;                    /*!< query scratch space, kept to not allocate */
+    mutable std::vector<ShapeHandle> tested;            /*!< query scratch space, the handles of near */
+    mutable std::vector<uint8_t> hits;                  /*!< query scratch space, the hit test results */
+
+    template <typename Visit>
+    void forCells(const Box &bounds, Visit visit);      // calls visit with every cell a box overlaps
+    void bucket(Shape *shape, const Placement &where);  // adds a shape to its cells
+    void unbucket(Shape *shape, const Placement &where); // removes a shape from its cells
+    void settle();                                      // buckets every shape added in bulk
+public:
+    ShapeGrid();
+    void insert(Shape *shape, long long depth);     // adds a shape at its depth in the drawing order
+    void insert(const ZOrder &order);               // lists every shape of a drawing order to be bucketed
+    bool fill(size_t count);                        // buckets some of the shapes added in bulk
+    void update(Shape *shape);                      // rebuckets a shape after it moved or changed size
+    void restack(Shape *shape, long long depth);    // gives a shape its new depth in the drawing order
+    void remove(Shape *shape);                      // takes a shape out of the grid
+    void clear();                                   // takes every shape out of the grid
+    // finds the shapes that contain a point, front to back
+    void query(int x, int y, const ShapeStore &store, std::vector<Shape *> &found);
+    size_t size() const;                            // returns the number of shapes in the grid
+};
+
+#endif
@@ -0,0 +1,636 @@
+/** ***************************************************************************
+* @file
+* @brief Cpp file including functions for the history.h, holds the functions
+* which make, undo and redo the changes to the shapes
+******************************************************************************/
+
+#include <algorithm>
+#include <utility>
+#include "history.h"
+#include "document.h"
+#include "stats.h"
+#include "autosave.h"
+#include "reaper.h"
+
+/** **************************************************************************
+ * @brief Appends a change to the autosave log, and compacts the log into a
+ * snapshot of the shapes once it is due
+ *
+ * @param[in,out] doc - the document, the change already applied
+ * @param[in] type - what changed
+ * @param[in] depth - the depth of the changed shape
+ * @param[in] to - its new depth, or the depth of the shape it swapped with
+ * @param[in] shape - the shape added or moved, nullptr for other changes
+ ******************************************************************************/
+static void logChange(Document &doc, ChangeType type, long long depth, long long to = 0, Shape *shape = nullptr)
+{
+   if(!autosaving())
+      return;
+   autosaveChange(type, depth, to, shape);
+   if(autosaveDue())
+      autosaveScene(doc.records.snapshot());
+}
+
+/** **************************************************************************
+ * @brief Puts a shape back on the canvas at a depth
+ *
+ * @param[in,out] doc - the document
+ * @param[in,out] shape - the shape, not on the canvas
+ * @param[in] depth - its depth in the drawing order, free
+ *
+ * @returns the area the shape covers
+ ******************************************************************************/
+static Box attach(Document &doc, Shape *shape, long long depth)
+{
+   doc.store.add(shape);
+   doc.records.put(shape->getHandle(), shape->toRecord(), depth);
+   doc.shapes.insert(shape, depth);
+   doc.grid.insert(shape, depth);
+   logChange(doc, ADD_CHANGE, depth, 0, shape);
+   return shape->bounds();
+}
+
+/** **************************************************************************
+ * @brief Takes a shape off the canvas, it stays in the arena
+ *
+ * @param[in,out] doc - the document
+ * @param[in,out] shape - the shape, on the canvas
+ *
+ * @returns the area the shape covered
+ ******************************************************************************/
+static Box detach(Document &doc, Shape *shape)
+{
+   long long depth = doc.shapes.depthOf(shape);
+   doc.grid.remove(shape);
+   doc.records.erase(shape->getHandle());
+   doc.store.remove(shape);
+   doc.shapes.remove(shape);
+   logChange(doc, ERASE_CHANGE, depth);
+   return shape->bounds();
+}
+
+/** **************************************************************************
+ * @brief Puts a shape at a location and reindexes it
+ *
+ * @param[in,out] doc - the document
+ * @param[in,out] shape - the shape, on the canvas
+ * @param[in] x - its new x location
+ * @param[in] y - its new y location
+ *
+ * @returns the area the shape covered and covers now
+ ******************************************************************************/
+static Box place(Document &doc, Shape *shape, int x, int y)
+{
+   Box area = shape->bounds();
+   shape->setXLoc(x);
+   shape->setYLoc(y);
+   doc.store.update(shape);
+   doc.records.update(shape->getHandle(), shape->toRecord());
+   doc.grid.update(shape);
+   area.add(shape->bounds());
+   return area;
+}
+
+/** **************************************************************************
+ * @brief Moves a shape by a distance and reindexes it
+ *
+ * @param[in,out] doc - the document
+ * @param[in,out] shape - the shape, on the canvas
+ * @param[in] dx - how far to move it right
+ * @param[in] dy - how far to move it up
+ *
+ * @returns the area the shape covered and covers now
+ ******************************************************************************/
+static Box shift(Document &doc, Shape *shape, int dx, int dy)
+{
+   Box area = place(doc, shape, shape->getXLoc() + dx, shape->getYLoc() + dy);
+   logChange(doc, MOVE_CHANGE, doc.shapes.depthOf(shape), 0, shape);
+   return area;
+}
+
+/** **************************************************************************
+ * @brief Hands the depth of a restacked shape on to the grid and the records
+ *
+ * @param[in,out] doc - the document
+ * @param[in] shape - the shape, on the canvas
+ ******************************************************************************/
+static void restacked(Document &doc, Shape *shape)
+{
+   long long depth = doc.shapes.depthOf(shape);
+   doc.grid.restack(shape, depth);
+   doc.records.restack(shape->getHandle(), depth);
+}
+
+/** **************************************************************************
+ * @brief Takes the drawn shape off the canvas
+ ******************************************************************************/
+Box CreateCommand::undo(Document &doc)
+{
+   return detach(doc, shape);
+}
+
+/** **************************************************************************
+ * @brief Puts the drawn shape back on the canvas
+ ******************************************************************************/
+Box CreateCommand::redo(Document &doc)
+{
+   return attach(doc, shape, depth);
+}
+
+/** **************************************************************************
+ * @brief Frees the drawn shape if it was undone, nothing else can bring it back
+ *
+ * @param[in,out] doc - the document
+ * @param[in] applied - set if the command is applied
+ ******************************************************************************/
+void CreateCommand::drop(Document &doc, bool applied)
+{
+   if(!applied)
+      doc.arena.release(shape);
+}
+
+/** **************************************************************************
+ * @brief Returns the bytes the command may keep alive, the shape and its
+ * outline once undone
+ ******************************************************************************/
+size_t CreateCommand::bytes() const
+{
+   return sizeof(Command) + SHAPE_SLOT_SIZE + shape->heapBytes();
+}
+
+/** **************************************************************************
+ * @brief Puts the deleted shape back on the canvas
+ ******************************************************************************/
+Box DeleteCommand::undo(Document &doc)
+{
+   return attach(doc, shape, depth);
+}
+
+/** **************************************************************************
+ * @brief Takes the deleted shape off the canvas again
+ ******************************************************************************/
+Box DeleteCommand::redo(Document &doc)
+{
+   return detach(doc, shape);
+}
+
+/** **************************************************************************
+ * @brief Frees the deleted shape if it is still deleted
+ *
+ * @param[in,out] doc - the document
+ * @param[in] applied - set if the command is applied
+ ******************************************************************************/
+void DeleteCommand::drop(Document &doc, bool applied)
+{
+   if(applied)
+      doc.arena.release(shape);
+}
+
+/** **************************************************************************
+ * @brief Returns the bytes the command may keep alive, the deleted shape and
+ * its outline
+ ******************************************************************************/
+size_t DeleteCommand::bytes() const
+{
+   return sizeof(Command) + SHAPE_SLOT_SIZE + shape->heapBytes();
+}
+
+/** **************************************************************************
+ * @brief Moves the shape back to where the drag started
+ ******************************************************************************/
+Box MoveCommand::undo(Document &doc)
+{
+   return shift(doc, shape, -dx, -dy);
+}
+
+/** **************************************************************************
+ * @brief Moves the shape to where the drag ended
+ ******************************************************************************/
+Box MoveCommand::redo(Document &doc)
+{
+   return shift(doc, shape, dx, dy);
+}
+
+/** **************************************************************************
+ * @brief Does nothing, the command owns no shape
+ ******************************************************************************/
+void MoveCommand::drop(Document &doc, bool applied)
+{
+}
+
+/** **************************************************************************
+ * @brief Returns the bytes the command keeps
+ ******************************************************************************/
+size_t MoveCommand::bytes() const
+{
+   return sizeof(Command);
+}
+
+/** **************************************************************************
+ * @brief Puts the shape back at its old depth
+ ******************************************************************************/
+Box RestackCommand::undo(Document &doc)
+{
+   if(other != nullptr)   // a swap undoes itself
+      return redo(doc);
+   doc.shapes.moveTo(shape, from);
+   restacked(doc, shape);
+   logChange(doc, RESTACK_CHANGE, to, from);
+   return shape->bounds();
+}
+
+/** **************************************************************************
+ * @brief Puts the shape at its new depth again
+ ******************************************************************************/
+Box RestackCommand::redo(Document &doc)
+{
+   if(other != nullptr)
+   {
+      doc.shapes.exchange(shape, other);
+      restacked(doc, other);
+      logChange(doc, SWAP_CHANGE, from, to);
+   }
+   else
+   {
+      doc.shapes.moveTo(shape, to);
+      logChange(doc, RESTACK_CHANGE, from, to);
+   }
+   restacked(doc, shape);
+   return shape->bounds();
+}
+
+/** **************************************************************************
+ * @brief Does nothing, the command owns no shape
+ ******************************************************************************/
+void RestackCommand::drop(Document &doc, bool applied)
+{
+}
+
+/** **************************************************************************
+ * @brief Returns the bytes the command keeps
+ ******************************************************************************/
+size_t RestackCommand::bytes() const
+{
+   return sizeof(Command);
+}
+
+/** **************************************************************************
+ * @brief Swaps the cleared shapes back onto the canvas
+ ******************************************************************************/
+Box ClearCommand::undo(Document &doc)
+{
+   return redo(doc);   // the canvas is empty again, swapping restores it
+}
+
+/** **************************************************************************
+ * @brief Swaps the shapes on the canvas for empty indexes
+ ******************************************************************************/
+Box ClearCommand::redo(Document &doc)
+{
+   std::swap(doc.shapes, parts->shapes);
+   std::swap(doc.store, parts->store);
+   std::swap(doc.grid, parts->grid);
+   std::swap(doc.records, parts->records);
+   if(autosaving())
+      autosaveScene(doc.records.snapshot());   // every shape changed, the log starts over
+   return Box::whole();
+}
+
+/** **************************************************************************
+ * @brief Retires the indexes the command holds, their shapes are off the
+ * canvas either way and are freed a batch at a time
+ *
+ * Applied, those are the cleared shapes. Undone, they are the shapes an open
+ * put on the canvas, or none after a clear.
+ *
+ * @param[in,out] doc - the document
+ * @param[in] applied - set if the command is applied
+ ******************************************************************************/
+void ClearCommand::drop(Document &doc, bool applied)
+{
+   doc.history.retire(std::move(parts));
+}
+
+/** **************************************************************************
+ * @brief Returns the bytes the command may keep alive, the cleared shapes,
+ * their outlines and their indexes
+ ******************************************************************************/
+size_t ClearCommand::bytes() const
+{
+   size_t cells = GRID_CELLS * GRID_CELLS * sizeof(std::vector<int>);
+   return sizeof(Command) + sizeof(SceneParts) + cells + heap + count * (SHAPE_SLOT_SIZE + SCENE_BYTES_PER_SHAPE);
+}
+
+/** **************************************************************************
+ * @brief Adds a command just applied to the history
+ *
+ * The undone commands are dropped first, they can not be redone after a new
+ * change. Then the oldest commands are dropped until the rest fit the budget.
+ *
+ * @param[in,out] doc - the document
+ * @param[in] command - the applied command
+ ******************************************************************************/
+void History::record(Document &doc, Command &&command)
+{
+   auto drop = [&](Command &old, bool done)
+   {
+      used -= visit([](const auto &c) { return c.bytes(); }, old);
+      visit([&](auto &c) { c.drop(doc, done); }, old);
+   };
+   while(commands.size() > applied)
+   {
+      drop(commands.back(), false);
+      commands.pop_back();
+   }
+   used += visit([](const auto &c) { return c.bytes(); }, command);
+   commands.push_back(std::move(command));
+   applied++;
+   merging = false;
+   while(used > budget && commands.size() > 1)
+   {
+      drop(commands.front(), true);
+      commands.pop_front();
+      applied--;
+   }
+   reclaim(doc);
+   publish();
+}
+
+/** **************************************************************************
+ * @brief Queues the indexes of a dropped clear, their shapes are released by
+ * reclaim
+ *
+ * @param[in] parts - the indexes, holding shapes no command can bring back
+ ******************************************************************************/
+void History::retire(std::unique_ptr<SceneParts> parts)
+{
+   retired.push_back(std::move(parts));
+   if(retired.size() == 1)
+      reclaimed = retired.front()->shapes.begin();
+}
+
+/** **************************************************************************
+ * @brief Releases up to RECLAIM_BATCH shapes of the dropped clears
+ *
+ * Indexes whose shapes are all released go to the reaper thread, which
+ * destroys them. Called after every recorded change and by the scene thread
+ * when it has no events waiting, so a large clear is freed over many calls
+ * that each cost the same.
+ *
+ * @param[in,out] doc - the document
+ *
+ * @returns true if shapes are left to release
+ ******************************************************************************/
+bool History::reclaim(Document &doc)
+{
+   size_t released = 0;
+   while(!retired.empty() && released < RECLAIM_BATCH)
+   {
+      ZOrder::const_iterator end = retired.front()->shapes.end();
+      for(; reclaimed != end && released < RECLAIM_BATCH; ++reclaimed, released++)
+         doc.arena.release(*reclaimed);
+      if(reclaimed != end)
+         break;
+      reapParts(std::move(retired.front()));
+      retired.pop_front();
+      if(!retired.empty())
+         reclaimed = retired.front()->shapes.begin();
+   }
+   return !retired.empty();
+}
+
+/** **************************************************************************
+ * @brief Copies the history counts into the program wide counters
+ ******************************************************************************/
+void History::publish() const
+{
+   stats().undoSteps.store(commands.size(), std::memory_order_relaxed);
+   stats().undoBytes.store(used, std::memory_order_relaxed);
+}
+
+/** **************************************************************************
+ * @brief Puts a shape just made in front of the others
+ *
+ * @param[in,out] doc - the document
+ * @param[in,out] shape - the shape, made in the arena of the document
+ *
+ * @returns the area the shape covers
+ ******************************************************************************/
+Box History::create(Document &doc, Shape *shape)
+{
+   settle(doc);
+   CreateCommand command = {shape, doc.shapes.add(shape)};
+   doc.store.add(shape);
+   doc.records.put(shape->getHandle(), shape->toRecord(), command.depth);
+   doc.grid.insert(shape, command.depth);
+   logChange(doc, ADD_CHANGE, command.depth, 0, shape);
+   record(doc, command);
+   return shape->bounds();
+}
+
+/** **************************************************************************
+ * @brief Takes a shape off the canvas, it is freed once it can not be undone
+ *
+ * @param[in,out] doc - the document
+ * @param[in,out] shape - the shape, on the canvas
+ *
+ * @returns the area the shape covered
+ ******************************************************************************/
+Box History::remove(Document &doc, Shape *shape)
+{
+   settle(doc);
+   DeleteCommand command = {shape, doc.shapes.depthOf(shape)};
+   Box area = command.redo(doc);
+   record(doc, command);
+   return area;
+}
+
+/** **************************************************************************
+ * @brief Takes every shape off the canvas without visiting them
+ *
+ * @param[in,out] doc - the document
+ *
+ * @returns the whole canvas, or nothing if there were no shapes
+ ******************************************************************************/
+Box History::clear(Document &doc)
+{
+   settle(doc);
+   if(doc.shapes.empty())
+      return Box();
+   ClearCommand command = {std::unique_ptr<SceneParts>(new SceneParts), doc.shapes.size(), doc.shapes.heapBytes()};
+   Box area = command.redo(doc);
+   record(doc, std::move(command));
+   return area;
+}
+
+/** **************************************************************************
+ * @brief Puts a set of shapes on the canvas in place of the ones there
+ *
+ * The shapes of the canvas are kept by the command like a clear, undoing
+ * swaps them back.
+ *
+ * @param[in,out] doc - the document
+ * @param[in] parts - the indexes of the new shapes, made in the arena of the document
+ *
+ * @returns the whole canvas
+ ******************************************************************************/
+Box History::replace(Document &doc, std::unique_ptr<SceneParts> parts)
+{
+   settle(doc);
+   size_t count = std::max(doc.shapes.size(), parts->shapes.size());
+   size_t heap = std::max(doc.shapes.heapBytes(), parts->shapes.heapBytes());
+   ClearCommand command = {std::move(parts), count, heap};
+   Box area = command.redo(doc);
+   record(doc, std::move(command));
+   return area;
+}
+
+/** **************************************************************************
+ * @brief Changes the depth of a shape in the drawing order
+ *
+ * @param[in,out] doc - the document
+ * @param[in,out] shape - the shape, on the canvas
+ * @param[in] how - where it goes
+ *
+ * @returns the area the shape covers, nothing if it did not move
+ ******************************************************************************/
+Box History::restack(Document &doc, Shape *shape, Restack how)
+{
+   settle(doc);
+   ZOrder &shapes = doc.shapes;
+   RestackCommand command = {shape, nullptr, shapes.depthOf(shape), 0};
+   if(how == TO_FRONT)
+      command.to = shapes.bringToFront(shape);
+   else if(how == TO_BACK)
+      command.to = shapes.sendToBack(shape);
+   else
+   {
+      command.other = how == RAISE ? shapes.raise(shape) : shapes.lower(shape);
+      command.to = shapes.depthOf(shape);
+      if(command.other != nullptr)
+         restacked(doc, command.other);
+   }
+   if(command.to == command.from)
+      return Box();
+   restacked(doc, shape);
+   logChange(doc, command.other != nullptr ? SWAP_CHANGE : RESTACK_CHANGE, command.from, command.to);
+   record(doc, command);
+   return shape->bounds();
+}
+
+/** **************************************************************************
+ * @brief Moves a shape to a location, a step of a drag
+ *
+ * The steps of one drag add up in a single command, logged to the autosave
+ * once the drag ends
+ *
+ * @param[in,out] doc - the document
+ * @param[in,out] shape - the shape, on the canvas
+ * @param[in] x - its new x location
+ * @param[in] y - its new y location
+ *
+ * @returns the area the shape covered and covers now, nothing if it did not move
+ ******************************************************************************/
+Box History::move(Document &doc, Shape *shape, int x, int y)
+{
+   int dx = x - shape->getXLoc();
+   int dy = y - shape->getYLoc();
+   if(dx == 0 && dy == 0)
+      return Box();
+   Box area = place(doc, shape, x, y);
+   MoveCommand *last = merging ? std::get_if<MoveCommand>(&commands.back()) : nullptr;
+   if(last != nullptr && last->shape == shape)
+   {
+      last->dx += dx;
+      last->dy += dy;
+      return area;
+   }
+   settle(doc);
+   record(doc, MoveCommand{shape, dx, dy});
+   merging = true;
+   return area;
+}
+
+/** **************************************************************************
+ * @brief Ends the drag whose moves are being merged, where it left the shape
+ * is logged to the autosave
+ *
+ * @param[in,out] doc - the document
+ ******************************************************************************/
+void History::settle(Document &doc)
+{
+   MoveCommand *last = merging ? std::get_if<MoveCommand>(&commands.back()) : nullptr;
+   if(last != nullptr)
+      logChange(doc, MOVE_CHANGE, doc.shapes.depthOf(last->shape), 0, last->shape);
+   merging = false;
+}
+
+/** **************************************************************************
+ * @brief Ends the drag whose moves are being merged, the next move starts a
+ * new command
+ *
+ * @param[in,out] doc - the document
+ ******************************************************************************/
+void History::seal(Document &doc)
+{
+   settle(doc);
+}
+
+/** **************************************************************************
+ * @brief Undoes the last applied command
+ *
+ * @param[in,out] doc - the document
+ *
+ * @returns the area the command changed, nothing if there was none
+ ******************************************************************************/
+Box History::undo(Document &doc)
+{
+   settle(doc);
+   if(applied == 0)
+      return Box();
+   applied--;
+   return visit([&](auto &c) { return c.undo(doc); }, commands[applied]);
+}
+
+/** **************************************************************************
+ * @brief Redoes the last undone command
+ *
+ * @param[in,out] doc - the document
+ *
+ * @returns the area the command changed, nothing if there was none
+ ******************************************************************************/
+Box History::redo(Document &doc)
+{
+   settle(doc);
+   if(applied == commands.size())
+      return Box();
+   applied++;
+   return visit([&](auto &c) { return c.redo(doc); }, commands[applied - 1]);
+}
+
+/** **************************************************************************
+ * @brief Sets the bytes the commands may keep alive, checked as commands are
+ * recorded
+ *
+ * @param[in] bytes - the budget
+ ******************************************************************************/
+void History::setBudget(size_t bytes)
+{
+   budget = bytes;
+}
+
+/** **************************************************************************
+ * @brief Returns the number of commands kept, applied or undone
+ ******************************************************************************/
+size_t History::size() const
+{
+   return commands.size();
+}
+
+/** **************************************************************************
+ * @brief Returns the bytes the commands keep alive
+ ******************************************************************************/
+size_t History::memory() const
+{
+   return used;
+}
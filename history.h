@@ -0,0 +1,186 @@
+/** ***************************************************************************
+* @file
+* @brief Header file that holds the History class, the log of the changes made
+* to the shapes, which undoes and redoes them one command at a time
+******************************************************************************/
+
+#ifndef __HISTORY_H
+#define __HISTORY_H
+
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <variant>
+#include "shape.h"
+#include "shapestore.h"
+#include "grid.h"
+#include "zorder.h"
+#include "snapshot.h"
+#include "box.h"
+
+struct Document;
+
+const size_t UNDO_BUDGET = 64 << 20;        /*!< bytes the history may keep alive by default */
+const size_t SCENE_BYTES_PER_SHAPE = 256;   /*!< about what the order, store and grid keep per shape */
+const size_t RECLAIM_BATCH = 4096;          /*!< shapes of a dropped clear released at a time */
+
+/*!
+ * @brief The ways a shape can be restacked
+ */
+enum Restack { TO_FRONT, TO_BACK, RAISE, LOWER };
+
+/*!
+ * @brief CreateCommand struct, a shape was drawn
+ */
+struct CreateCommand
+{
+    Shape *shape;       /*!< the shape drawn */
+    long long depth;    /*!< its depth in the drawing order */
+
+    Box undo(Document &doc);
+    Box redo(Document &doc);
+    void drop(Document &doc, bool applied);
+    size_t bytes() const;
+};
+
+/*!
+ * @brief DeleteCommand struct, a shape was deleted
+ */
+struct DeleteCommand
+{
+    Shape *shape;       /*!< the shape deleted, kept alive while it can be undone */
+    long long depth;    /*!< the depth it had in the drawing order */
+
+    Box undo(Document &doc);
+    Box redo(Document &doc);
+    void drop(Document &doc, bool applied);
+    size_t bytes() const;
+};
+
+/*!
+ * @brief MoveCommand struct, a shape was dragged, stored as how far it went
+ */
+struct MoveCommand
+{
+    Shape *shape;       /*!< the shape moved */
+    int dx;             /*!< how far it moved right */
+    int dy;             /*!< how far it moved up */
+
+    Box undo(Document &doc);
+    Box redo(Document &doc);
+    void drop(Document &doc, bool applied);
+    size_t bytes() const;
+};
+
+/*!
+ * @brief RestackCommand struct, a shape was given a new depth, or swapped
+ * depths with a neighbour
+ */
+struct RestackCommand
+{
+    Shape *shape;       /*!< the shape restacked */
+    Shape *other;       /*!< the shape it swapped depths with, nullptr if none */
+    long long from;     /*!< its depth before */
+    long long to;       /*!< its depth after */
+
+    Box undo(Document &doc);
+    Box redo(Document &doc);
+    void drop(Document &doc, bool applied);
+    size_t bytes() const;
+};
+
+/*!
+ * @brief SceneParts struct, the indexes of a whole set of shapes
+ */
+struct SceneParts
+{
+    ZOrder shapes;          /*!< the shapes back to front */
+    ShapeStore store;       /*!< the shapes as plain numbers */
+    ShapeGrid grid;         /*!< the shapes bucketed by location */
+    SharedScene records;    /*!< the shapes as records, for snapshots */
+};
+
+/*!
+ * @brief ClearCommand struct, every shape was cleared, or replaced by the
+ * shapes of an opened file
+ *
+ * Clearing swaps the indexes of the document with empty ones and keeps the
+ * full ones here, undoing swaps them back, so neither copies a shape. Opening
+ * swaps in the indexes of the file the same way.
+ *
+ * The cleared shapes stay in the arena while the command can be undone. Once
+ * it is dropped its indexes are retired to the history, which releases the
+ * shapes RECLAIM_BATCH at a time, then hands the indexes to the reaper thread
+ * to be destroyed, so no edit waits on the number of shapes cleared.
+ */
+struct ClearCommand
+{
+    std::unique_ptr<SceneParts> parts;  /*!< the shapes off the canvas, empty indexes after a clear is undone */
+    size_t count;                       /*!< the number of shapes it holds at most */
+    size_t heap;                        /*!< the bytes their outlines hold at most */
+
+    Box undo(Document &doc);
+    Box redo(Document &doc);
+    void drop(Document &doc, bool applied);
+    size_t bytes() const;
+};
+
+/*!
+ * @brief A change to the shapes, as the history keeps it
+ */
+typedef std::variant<CreateCommand, DeleteCommand, MoveCommand, RestackCommand, ClearCommand> Command;
+
+/*!
+ * @brief History class, the commands applied to the shapes, oldest first,
+ * followed by the ones undone
+ *
+ * Every change to the shapes goes through here, which makes it, records it
+ * and returns the area it changed. Undoing or redoing a step runs one command,
+ * each touches one or two shapes, or swaps the indexes for a clear, so a step
+ * costs the same on any size of canvas.
+ *
+ * Shapes taken off the canvas stay in the arena while a command can put them
+ * back. A command no longer in the history frees them, when it is dropped
+ * from the redo end by a new change or from the oldest end once the memory
+ * the commands keep alive is past the budget. The newest command is always
+ * kept. The shapes of a dropped clear are freed a batch at a time, by each
+ * new change and by the scene thread between events.
+ *
+ * The steps of one drag are merged into one move, until the mouse button is
+ * pressed or released or another command is recorded.
+ *
+ * While autosaving, every change made, undone or redone is also appended to
+ * the autosave log, a drag once it ends.
+ */
+class History
+{
+    std::deque<Command> commands;   /*!< the applied commands then the undone ones */
+    size_t applied = 0;             /*!< the commands applied, from the front */
+    size_t used = 0;                /*!< bytes the commands keep alive */
+    size_t budget = UNDO_BUDGET;    /*!< bytes the commands may keep alive */
+    bool merging = false;           /*!< set while moves of the same shape are merged */
+    std::deque<std::unique_ptr<SceneParts>> retired;    /*!< indexes of dropped clears, their shapes not all released */
+    ZOrder::const_iterator reclaimed;   /*!< the next shape of the oldest retired indexes to release */
+
+    void record(Document &doc, Command &&command);  // adds an applied command, dropping any undone ones
+    void retire(std::unique_ptr<SceneParts> parts); // queues the indexes of a dropped clear to be freed
+    void settle(Document &doc);                     // ends merging, logging where the drag left its shape
+    void publish() const;                           // copies the counts into the program wide counters
+    friend struct ClearCommand;
+public:
+    Box create(Document &doc, Shape *shape);        // puts a new shape in front
+    Box remove(Document &doc, Shape *shape);        // takes a shape off the canvas
+    Box clear(Document &doc);                       // takes every shape off the canvas
+    Box replace(Document &doc, std::unique_ptr<SceneParts> parts);  // puts other shapes on the canvas
+    Box restack(Document &doc, Shape *shape, Restack how);     // changes the depth of a shape
+    Box move(Document &doc, Shape *shape, int x, int y);       // moves a shape, a step of a drag
+    void seal(Document &doc);                       // ends merging the moves of a drag
+    bool reclaim(Document &doc);                    // frees a batch of the shapes of dropped clears
+    Box undo(Document &doc);                        // undoes the last applied command
+    Box redo(Document &doc);                        // redoes the last undone command
+    void setBudget(size_t bytes);                   // sets the bytes the commands may keep alive
+    size_t size() const;                            // returns the number of commands kept
+    size_t memory() const;                          // returns the bytes the commands keep alive
+};
+
+#endif
@@ -0,0 +1,183 @@
+/** ***************************************************************************
+* @file
+* @brief Cpp file including functions for the journal.h, holds the functions
+* which record events to a binary journal and feed a journal back through
+* the same Event::action code with no window, timing every event
+******************************************************************************/
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <iomanip>
+#include "journal.h"
+#include "util.h"
+#include "scene.h"
+
+using std::chrono::steady_clock;
+
+static const uint16_t JOURNAL_VERSION = 1;  // current journal format version
+
+static FILE *journal = nullptr;             // the journal being recorded, if any
+static steady_clock::time_point lastEvent;  // time of the previously recorded event
+
+/** **************************************************************************
+ * @brief Starts recording every dispatched event to a journal file
+ *
+ * @param[in] path - the file the journal is written to
+ *
+ * @returns true if the journal file could be created
+ ******************************************************************************/
+bool startJournal(const char *path)
+{
+   stopJournal();
+   journal = fopen(path, "wb");
+   if (journal == nullptr)
+      return false;
+
+   JournalHeader header = {{'P', 'J', 'N', 'L'}, JOURNAL_VERSION, sizeof(EventRecord)};
+   fwrite(&header, sizeof(header), 1, journal);
+   lastEvent = steady_clock::now();
+   return true;
+}
+
+/** **************************************************************************
+ * @brief Appends an event to the journal, does nothing if not recording
+ *
+ * The record is buffered by stdio so recording does not cost a write per event
+ *
+ * @param[in] event - the event about to be dispatched
+ ******************************************************************************/
+void journalEvent(const Event &event)
+{
+   if (journal == nullptr)
+      return;
+
+   steady_clock::time_point now = steady_clock::now();
+   EventRecord rec = recordOf(event);
+   rec.time = uint32_t(std::chrono::duration_cast<std::chrono::microseconds>(now - lastEvent).count());
+   lastEvent = now;
+   fwrite(&rec, sizeof(rec), 1, journal);
+}
+
+/** **************************************************************************
+ * @brief Flushes and closes the journal, if recording
+ ******************************************************************************/
+void stopJournal()
+{
+   if (journal == nullptr)
+      return;
+   fclose(journal);
+   journal = nullptr;
+}
+
+/** **************************************************************************
+ * @brief Returns the microsecond value at the given fraction of sorted timings
+ *
+ * @param[in,out] times - the timings, partially reordered by the call
+ * @param[in] fraction - the percentile wanted, 0 to 1
+ ******************************************************************************/
+static double percentile(vector<double> &times, double fraction)
+{
+   size_t index = size_t(fraction * (times.size() - 1));
+   std::nth_element(times.begin(), times.begin() + index, times.end());
+   return times[index];
+}
+
+/** **************************************************************************
+ * @brief Replays a journal through utilityCentral without opening a window
+ *
+ * Every record is turned back into its event and dispatched as fast as
+ * possible. Frames are rendered on the recorded clock, at most once per frame
+ * interval of the frame rate cap, exactly as the scene thread would have
+ * rendered them during the session. The time spent in each dispatch, plus any
+ * frame rendered after it, is reported per event type along with the total,
+ * so changes to the event and shape code can be compared on the exact same
+ * workload.
+ *
+ * @param[in] path - the journal file to replay
+ * @param[in,out] out - the stream the timing report is written to
+ *
+ * @returns 0 if the journal was replayed, 1 if it could not be read
+ ******************************************************************************/
+int replayJournal(const char *path, std::ostream &out)
+{
+   static const char *names[] = {"init", "display", "reshape", "key",
+                                 "click", "drag", "move", "close"};
+   const int TYPES = sizeof(names) / sizeof(names[0]);
+
+   FILE *file = fopen(path, "rb");
+   if (file == nullptr)
+   {
+      out << "cannot open journal " << path << "\n";
+      return 1;
+   }
+
+   JournalHeader header;
+   if (fread(&header, sizeof(header), 1, file) != 1 || memcmp(header.magic, "PJNL", 4) != 0 ||
+       header.version != JOURNAL_VERSION || header.recordSize != sizeof(EventRecord))
+   {
+      out << path << " is not a version " << JOURNAL_VERSION << " journal\n";
+      fclose(file);
+      return 1;
+   }
+
+   vector<EventRecord> records;
+   EventRecord rec;
+   while (fread(&rec, sizeof(rec), 1, file) == 1)
+      records.push_back(rec);
+   fclose(file);
+
+   vector<double> times[TYPES];   // microseconds spent dispatching, per event type
+   double recorded = 0;           // microseconds the recorded session lasted
+   double nextFrame = 0;          // recorded time the next frame may be rendered at
+   long rendered = 0;             // frames rendered during the replay
+   steady_clock::time_point begin = steady_clock::now();
+
+   for (size_t i = 0; i < records.size(); i++)
+   {
+      if (records[i].type >= TYPES)
+         continue;
+      recorded += records[i].time;
+      steady_clock::time_point start = steady_clock::now();
+      dispatchRecord(records[i]);
+      if (recorded >= nextFrame && renderDamage())
+      {
+         presentFrame();
+         nextFrame = recorded + frameInterval() * 1000.0;
+         rendered++;
+      }
+      std::chrono::duration<double, std::micro> spent = steady_clock::now() - start;
+      times[records[i].type].push_back(spent.count());
+   }
+   if (renderDamage())   // the last events may still be owed a frame
+   {
+      presentFrame();
+      rendered++;
+   }
+
+   std::chrono::duration<double, std::milli> total = steady_clock::now() - begin;
+
+   out << std::fixed << std::setprecision(2)
+       << "replayed " << records.size() << " events in " << total.count() << " ms"
+       << " (recorded session " << recorded / 1000.0 << " ms), rendered " << rendered << " frames\n"
+       << std::setw(8) << "event" << std::setw(10) << "count" << std::setw(12) << "total ms"
+       << std::setw(10) << "mean us" << std::setw(10) << "p50 us" << std::setw(10) << "p99 us"
+       << std::setw(10) << "max us" << "\n";
+   for (int type = 0; type < TYPES; type++)
+   {
+      vector<double> &t = times[type];
+      if (t.empty())
+         continue;
+      double sum = 0;
+      for (size_t i = 0; i < t.size(); i++)
+         sum += t[i];
+      double mean = sum / t.size();
+      double p50 = percentile(t, 0.50);
+      double p99 = percentile(t, 0.99);
+      double max = *std::max_element(t.begin(), t.end());
+      out << std::setw(8) << names[type] << std::setw(10) << t.size() << std::setw(12) << sum / 1000.0
+          << std::setw(10) << mean << std::setw(10) << p50 << std::setw(10) << p99
+          << std::setw(10) << max << "\n";
+   }
+   return 0;
+}
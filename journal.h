@@ -0,0 +1,28 @@
+/** ***************************************************************************
+* @file
+* @brief Header file that holds the event journal, which records every event
+* reaching utilityCentral to a compact binary file and replays it without a window
+******************************************************************************/
+
+#ifndef __JOURNAL_H
+#define __JOURNAL_H
+
+#include <iostream>
+#include "event.h"
+
+/*!
+ * @brief Header written at the start of every journal file
+ */
+struct JournalHeader
+{
+    char magic[4];          /*!< always "PJNL" */
+    uint16_t version;       /*!< the journal format version */
+    uint16_t recordSize;    /*!< sizeof(EventRecord) when the journal was written */
+};
+
+bool startJournal(const char *path);                    // starts recording dispatched events to a file
+void journalEvent(const Event &event);                  // appends an event to the journal, if recording
+void stopJournal();                                     // flushes and closes the journal
+int replayJournal(const char *path, std::ostream &out); // replays a journal headless and reports timings
+
+#endif
@@ -0,0 +1,86 @@
+/** ***************************************************************************
+* @file
+* @brief Cpp file including functions for the layer.h, holds the functions
+* which render the static layer offscreen and copy it into the window
+******************************************************************************/
+
+#define GL_GLEXT_PROTOTYPES   // framebuffer functions, must come before any GL header
+#include "layer.h"
+#include "stats.h"
+
+/** **************************************************************************
+ * @brief Destructor, deletes the framebuffer and its renderbuffers if the
+ * layer was ever baked
+ ******************************************************************************/
+StaticLayer::~StaticLayer()
+{
+   if (framebuffer == 0)
+      return;
+   glDeleteFramebuffers(1, &framebuffer);
+   glDeleteRenderbuffers(1, &color);
+   glDeleteRenderbuffers(1, &depth);
+}
+
+/** **************************************************************************
+ * @brief Renders a render list into the offscreen framebuffer
+ *
+ * The framebuffer follows the size of the viewport and is only reallocated
+ * when that changes. An empty list leaves nothing to composite.
+ *
+ * @param[in] list - the shapes that stay put, back to front
+ ******************************************************************************/
+void StaticLayer::bake(const RenderList &list)
+{
+   GLint viewport[4] = {0, 0, 0, 0};
+   empty = true;
+   if (list.primitives() == 0)
+      return;
+
+   glGetIntegerv(GL_VIEWPORT, viewport);
+   if (viewport[2] <= 0 || viewport[3] <= 0)   // no OpenGL context
+      return;
+   if (framebuffer == 0)
+   {
+      glGenFramebuffers(1, &framebuffer);
+      glGenRenderbuffers(1, &color);
+      glGenRenderbuffers(1, &depth);
+   }
+   glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+   if (viewport[2] != width || viewport[3] != height)
+   {
+      width = viewport[2];
+      height = viewport[3];
+      glBindRenderbuffer(GL_RENDERBUFFER, color);
+      glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+      glBindRenderbuffer(GL_RENDERBUFFER, depth);
+      glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, width, height);
+      glBindRenderbuffer(GL_RENDERBUFFER, 0);
+      glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, color);
+      glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, depth);
+   }
+
+   if (glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE)
+   {
+      glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+      list.submit();
+      empty = false;
+      stats().layerBakes.fetch_add(1, std::memory_order_relaxed);
+   }
+   glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+/** **************************************************************************
+ * @brief Copies the baked layer over the whole window
+ *
+ * Meant to replace clearing the window, whatever is drawn after it lands on
+ * top of the layer
+ ******************************************************************************/
+void StaticLayer::composite() const
+{
+   if (empty)
+      return;
+   glBindFramebuffer(GL_READ_FRAMEBUFFER, framebuffer);
+   glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+   glBlitFramebuffer(0, 0, width, height, 0, 0, width, height, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+   glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+}
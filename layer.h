@@ -0,0 +1,35 @@
+/** ***************************************************************************
+* @file
+* @brief Header file that holds the StaticLayer class, an offscreen copy of the
+* shapes that stay put while another shape is dragged
+******************************************************************************/
+
+#ifndef __LAYER_H
+#define __LAYER_H
+
+#include "renderlist.h"
+
+/*!
+ * @brief StaticLayer class, renders a render list once into an offscreen
+ * framebuffer the size of the window and copies it to the window every frame
+ *
+ * Only used from the thread that owns the OpenGL context
+ */
+class StaticLayer
+{
+    GLuint framebuffer = 0;     /*!< the offscreen framebuffer, 0 until first baked */
+    GLuint color = 0;           /*!< the color renderbuffer of the framebuffer */
+    GLuint depth = 0;           /*!< the depth renderbuffer the render list needs */
+    int width = 0;              /*!< the width of the renderbuffers */
+    int height = 0;             /*!< the height of the renderbuffers */
+    bool empty = true;          /*!< true when there is nothing to copy to the window */
+public:
+    StaticLayer() = default;
+    ~StaticLayer();                     // deletes the framebuffer and renderbuffers
+    StaticLayer(const StaticLayer &other) = delete;
+    StaticLayer &operator=(const StaticLayer &other) = delete;
+    void bake(const RenderList &list);  // renders the list into the offscreen framebuffer
+    void composite() const;             // copies the baked layer to the window
+};
+
+#endif
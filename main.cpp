@@ -35,6 +35,9 @@
  * 
  * These shapes can be selected with the right mouse button and dragged around. 
  * If a shape is selected, the d key will delete it from the paint area
+ * The b key sends the selected shape to the back, [ and ] lower or raise it by one
+ * The z key (or ctrl+z) undoes the last change to the shapes, y (or ctrl+y) redoes it
+ * The s key saves the shapes to the scene file, drawing.pscn unless --open names another
  * 
  * If escape or q is pressed, the program will close immediately. 
  * If c is pressed, it will clear all objects from the paint area
@@ -51,8 +54,60 @@
  * @par Usage:
    @verbatim
    ./paint
+   ./paint --open drawing.pscn
+   ./paint --autosave autosave [--autosave-limit 4096]
+   ./paint --record session.pjnl
+   ./paint --fps 30
+   ./paint --backend immediate
+   ./paint --undo-budget 64
+   ./paint --replay session.pjnl
+   ./paint --render session.pjnl canvas.ppm [scale] [threads]
+   ./paint --bench-dispatch [count]
+   ./paint --bench-render [shapes]
+   ./paint --bench-pick [shapes]
+   ./paint --bench-snapshot [shapes]
+   ./paint --bench-scene [shapes]
+   ./paint --bench-autosave [changes]
    @endverbatim
  *
+ * --record writes every event to a binary journal while painting, --replay
+ * feeds a journal back through the program with no window and reports how
+ * long each kind of event took. --render replays a journal the same way and
+ * saves the canvas it leaves as a PPM image, drawn by the software rasterizer
+ * without OpenGL or a display. The image is the window size times the scale
+ * (1 by default), drawn in tiles on the given number of threads (every core
+ * by default), and how long the tiles took is reported. --bench-dispatch compares the per event
+ * cost of the old virtual event dispatch against the Event variant.
+ * --bench-render times a frame of many shapes drawn by each backend, to pick
+ * the fastest one for the host (LIBGL_ALWAYS_SOFTWARE=1 measures Mesa's
+ * software renderer).
+ * --bench-pick times finding the shapes under a point with the old virtual
+ * hit tests, with the shape store kernels and with the grid.
+ * --bench-snapshot times taking a snapshot of the shapes against copying
+ * them, and reports what editing after a snapshot costs and keeps alive.
+ * --bench-scene times saving a document of many shapes to a scene file and
+ * opening it again.
+ * --open puts the shapes of a scene file on the canvas, the s key saves them
+ * back to it. A file that does not exist yet is created on the first save.
+ * --autosave logs every change to the shapes to autosave.plog on a
+ * background thread, and compacts the log into the scene file autosave.pscn
+ * once it is past --autosave-limit kilobytes (4096 by default). If the two
+ * files are there at startup, after a crash or a clean exit, the shapes they
+ * hold are put back first and the time that took is reported.
+ * --bench-autosave makes many changes with autosaving on, then recovers them
+ * and reports the recovery time and the write amplification.
+ * --fps caps how many frames are rendered per second (60 by default), it can
+ * be combined with --record and --replay.
+ * --backend picks how frames are drawn: vbo (vertex buffers over the static
+ * layer, the default), immediate (one glBegin/glEnd per primitive), raster
+ * (the software rasterizer, copied to the window) or null (nothing drawn).
+ * --undo-budget sets how many megabytes of deleted and cleared shapes the undo
+ * history may keep alive (64 by default), the oldest changes are forgotten
+ * past it.
+ * An option the program does not know, one missing its value, a count that
+ * is not a whole number greater than 0 or an argument past the ones a mode
+ * takes prints the usage and exits with 1.
+ *
  * @section todo_bugs_modification_section Todo, Bugs, and Modifications
  *
  * @bug None
@@ -65,7 +120,115 @@
  *
  *****************************************************************************/
 
+#include <cerrno>
+#include <cstdlib>
 #include "util.h"
+#include "stats.h"
+#include "journal.h"
+#include "scene.h"
+#include "bench.h"
+#include "autosave.h"
+
+/*!
+ * @brief The options the program is started with, each takes a value
+ */
+static const char *const OPTIONS[] = {"--fps", "--undo-budget", "--backend", "--open", "--autosave",
+                                      "--autosave-limit", "--replay", "--record"};
+
+/** **************************************************************************
+ * @brief Returns true if an argument is one of the options
+ *
+ * @param[in] arg - the argument
+ *****************************************************************************/
+static bool isOption(const char *arg)
+{
+   for (const char *option : OPTIONS)
+      if (strcmp(arg, option) == 0)
+         return true;
+   return false;
+}
+
+/** **************************************************************************
+ * @brief Reads a count of things a benchmark makes from an argument
+ *
+ * @param[in] arg - the argument, a whole decimal number
+ * @param[out] count - the count, unchanged if the argument is not one
+ *
+ * @returns true if the argument is a number greater than 0
+ *****************************************************************************/
+static bool parseCount(const char *arg, long &count)
+{
+   char *end = nullptr;
+   errno = 0;
+   long value = strtol(arg, &end, 10);
+   if (end == arg || *end != '\0' || errno != 0 || value <= 0)
+      return false;
+   count = value;
+   return true;
+}
+
+/** **************************************************************************
+ * @brief Reads the scale an image is rendered at from an argument
+ *
+ * @param[in] arg - the argument, a decimal number
+ * @param[out] scale - the scale, unchanged if the argument is not one
+ *
+ * @returns true if the argument is a number greater than 0
+ *****************************************************************************/
+static bool parseScale(const char *arg, float &scale)
+{
+   char *end = nullptr;
+   errno = 0;
+   float value = strtof(arg, &end);
+   if (end == arg || *end != '\0' || errno != 0 || !(value > 0.0f))
+      return false;
+   scale = value;
+   return true;
+}
+
+/** **************************************************************************
+ * @brief Reads the count a benchmark was started with, the only argument
+ * allowed after its option
+ *
+ * @param[in] argc - the number of arguments
+ * @param[in] argv - the arguments, the benchmark option first
+ * @param[in,out] count - the default count, replaced by the one given
+ *
+ * @returns false, after saying why, if the count is not a number greater
+ *          than 0 or more arguments follow it
+ *****************************************************************************/
+static bool benchCount(int argc, char **argv, long &count)
+{
+   if (argc > 3)
+   {
+      cerr << "unexpected argument " << argv[3] << " after " << argv[1] << "\n";
+      return false;
+   }
+   if (argc == 3 && !parseCount(argv[2], count))
+   {
+      cerr << "invalid count " << argv[2] << ", it must be a whole number greater than 0\n";
+      return false;
+   }
+   return true;
+}
+
+/** **************************************************************************
+ * @brief Writes how the program is started and returns the error exit code
+ *
+ * @param[in] program - the name the program was started by
+ *
+ * @returns 1, so an option error ends the program
+ *****************************************************************************/
+static int usage(const char *program)
+{
+   cerr << "usage: " << program << " [--open file.pscn] [--autosave base] [--autosave-limit KB]\n"
+        << "       [--record file.pjnl | --replay file.pjnl] [--fps n] [--undo-budget MB]\n"
+        << "       [--backend vbo|immediate|raster|null]\n"
+        << "   or: " << program << " --render file.pjnl image.ppm [scale] [threads]\n"
+        << "   or: " << program << " --bench-dispatch|--bench-render|--bench-pick|--bench-snapshot|"
+        << "--bench-scene|--bench-autosave [count]\n";
+   return 1;
+}
 
 /** **************************************************************************
  * @author Elijah & Vytaus
@@ -85,9 +248,154 @@
  *****************************************************************************/
 int main(int argc, char** argv)
 {
+   if (argc >= 2 && strcmp(argv[1], "--bench-dispatch") == 0)
+   {
+      long count = 10000000;
+      if (!benchCount(argc, argv, count))
+         return usage(argv[0]);
+      return benchmarkDispatch(count, cout);
+   }
+   if (argc >= 2 && strcmp(argv[1], "--bench-pick") == 0)
+   {
+      long count = 20000;
+      if (!benchCount(argc, argv, count))
+         return usage(argv[0]);
+      return benchmarkPick(count, 2000, cout);
+   }
+   if (argc >= 2 && strcmp(argv[1], "--bench-snapshot") == 0)
+   {
+      long count = 100000;
+      if (!benchCount(argc, argv, count))
+         return usage(argv[0]);
+      return benchmarkSnapshot(count, 1000, cout);
+   }
+   if (argc >= 2 && strcmp(argv[1], "--bench-autosave") == 0)
+   {
+      long count = 100000;
+      if (!benchCount(argc, argv, count))
+         return usage(argv[0]);
+      return benchmarkAutosave(count, "bench-autosave", cout);
+   }
+   if (argc >= 2 && strcmp(argv[1], "--bench-scene") == 0)
+   {
+      long count = 1000000;
+      if (!benchCount(argc, argv, count))
+         return usage(argv[0]);
+      return benchmarkScene(count, "bench.pscn", cout);
+   }
+   if (argc >= 2 && strcmp(argv[1], "--render") == 0)
+   {
+      long threads = std::thread::hardware_concurrency();
+      float scale = 1.0f;
+      if (argc < 4 || argc > 6)
+      {
+         cerr << "--render needs a journal and an image, then an optional scale and thread count\n";
+         return usage(argv[0]);
+      }
+      if ((argc >= 5 && !parseScale(argv[4], scale)) || (argc == 6 && !parseCount(argv[5], threads)))
+      {
+         cerr << "invalid scale or thread count, both must be numbers greater than 0\n";
+         return usage(argv[0]);
+      }
+      int result = replayJournal(argv[2], cerr);
+      if (result != 0)
+         return result;
+      TileRenderer tiles(static_cast<unsigned>(threads));
+      Framebuffer image;
+      renderImage(image, tiles, scale);
+      tiles.report(cerr);
+      if (!image.writePPM(argv[3]))
+      {
+         cerr << "cannot write image " << argv[3] << "\n";
+         return 1;
+      }
+      return 0;
+   }
+   if (argc >= 2 && strcmp(argv[1], "--bench-render") == 0)
+   {
+      long count = 5000;
+      if (!benchCount(argc, argv, count))
+         return usage(argv[0]);
+      // the render benchmark needs a window for its OpenGL context, it is never shown
+      glutInit(&argc, argv);
+      glutInitDisplayMode(GLUT_SINGLE | GLUT_RGBA | GLUT_DEPTH);
+      glutInitWindowSize(640, 480);
+      glutCreateWindow(argv[0]);
+      glMatrixMode(GL_PROJECTION);
+      gluOrtho2D(0.0, 640, 0.0, 480);
+      return benchmarkRender(count, 50, cout);
+   }
+
+   const char *replay = nullptr;   // journal to replay instead of opening a window
+   const char *scene = nullptr;    // scene file to open
+   const char *autosave = nullptr; // autosave to recover and keep
+   size_t autosaveLimit = AUTOSAVE_LIMIT;
+   for (int i = 1; i < argc; i += 2)
+   {
+      if (!isOption(argv[i]))
+      {
+         cerr << "unknown option " << argv[i] << "\n";
+         return usage(argv[0]);
+      }
+      if (i + 1 == argc)
+      {
+         cerr << "missing value for " << argv[i] << "\n";
+         return usage(argv[0]);
+      }
+      if (strcmp(argv[i], "--fps") == 0)
+         setFrameRate(atoi(argv[i + 1]));
+      else if (strcmp(argv[i], "--undo-budget") == 0)
+         setUndoBudget(size_t(atol(argv[i + 1])) << 20);
+      else if (strcmp(argv[i], "--backend") == 0)
+      {
+         BackendId id;
+         if (!findBackend(argv[i + 1], id))
+         {
+            cerr << "unknown backend " << argv[i + 1] << ", use vbo, immediate, raster or null\n";
+            return 1;
+         }
+         setBackend(id);
+      }
+      else if (strcmp(argv[i], "--open") == 0)
+         scene = argv[i + 1];
+      else if (strcmp(argv[i], "--autosave") == 0)
+         autosave = argv[i + 1];
+      else if (strcmp(argv[i], "--autosave-limit") == 0)
+         autosaveLimit = size_t(atol(argv[i + 1])) << 10;
+      else if (strcmp(argv[i], "--replay") == 0)
+         replay = argv[i + 1];
+      else if (strcmp(argv[i], "--record") == 0 && !startJournal(argv[i + 1]))
+      {
+         cerr << "cannot create journal " << argv[i + 1] << "\n";
+         return 1;
+      }
+   }
+   if (scene != nullptr && !openDocument(scene))
+   {
+      cerr << "cannot open scene " << scene << "\n";
+      return 1;
+   }
+   if (autosave != nullptr && !resumeAutosave(autosave, autosaveLimit))
+   {
+      cerr << "cannot recover autosave " << autosave << ", move it away to start a new one\n";
+      return 1;
+   }
+   if (replay != nullptr)
+   {
+      int result = replayJournal(replay, cout);
+      stopAutosave();
+      reportStats(cerr);
+      return result;
+   }
+
    initOpenGL(argc, argv, 640, 480);
 
    glutMainLoop();
+
+   stopScene();
+   stopJournal();
+   stopAutosave();
+   reportStats(cerr);
    
    return 0;
 }
\ No newline at end of file
@@ -1,123 +1,155 @@
 /** ***************************************************************************
 * @file
-* @brief Cpp file including functions for the menu.cpp, holds all the functions which access
-* and alter the MenuItem, Color, and Tool information
+* @brief Cpp file including functions for the menu.h, holds the toolbox layout
+* table and the functions which look palette cells up in it
 ******************************************************************************/
 
 #include "menu.h"
-// Menu Item
-MenuItem::MenuItem(){}
+#include "graphics.h"
 
-/** **************************************************************************
- * @brief Constructor for a menu item
- *
- * @param[in] xmin - the minimum x location of the menu item selection square
- * @param[in] xmax - the mmaximum x location of the menu item selection square
- * @param[in] ymin - the minimum y location of the menu item selection square
- * @param[in] ymax - the maximum y location of the menu item selection square
- * @param[in] ty - the type of menu item
- ******************************************************************************/
-MenuItem::MenuItem(int xmin, int xmax, int ymin, int ymax, std::string ty)
-: xMin(xmin), xMax(xmax), yMin(ymin), yMax(ymax), type(ty)
-{}
+/*!
+ * @brief The item in every cell, by row from the bottom then column
+ */
+static const PaletteItem CELLS[PALETTE_ROWS][PALETTE_COLUMNS] =
+{
+    {WHITE_ITEM, BLACK_ITEM},
+    {RED_ITEM, DARKRED_ITEM},
+    {ORANGE_ITEM, DARKORANGE_ITEM},
+    {YELLOW_ITEM, DARKYELLOW_ITEM},
+    {GREEN_ITEM, DARKGREEN_ITEM},
+    {BLUE_ITEM, DARKBLUE_ITEM},
+    {PURPLE_ITEM, DARKPURPLE_ITEM},
+    {GRAY_ITEM, DARKGRAY_ITEM},
+    {UNFILLED_SQUARE_ITEM, FILLED_SQUARE_ITEM},
+    {UNFILLED_CIRCLE_ITEM, FILLED_CIRCLE_ITEM},
+    {UNFILLED_ELLIPSE_ITEM, FILLED_ELLIPSE_ITEM},
+    {LINE_ITEM, NO_ITEM}
+};
+
+/*!
+ * @brief The color of each color item, in PaletteItem order
+ */
+static const float *const COLORS[FIRST_TOOL_ITEM - FIRST_COLOR_ITEM] =
+{
+    WHITE, RED, ORANGE, YELLOW, GREEN, BLUE, PURPLE, GRAY,
+    BLACK, DARKRED, DARKORANGE, DARKYELLOW, DARKGREEN, DARKBLUE, DARKPURPLE, DARKGRAY
+};
+
+/*!
+ * @brief The tool of each tool item, in PaletteItem order
+ */
+static const ToolId TOOLS[PALETTE_ITEMS - FIRST_TOOL_ITEM] =
+{
+    UNFILLED_SQUARE_TOOL, FILLED_SQUARE_TOOL, UNFILLED_CIRCLE_TOOL, FILLED_CIRCLE_TOOL,
+    UNFILLED_ELLIPSE_TOOL, FILLED_ELLIPSE_TOOL, LINE_TOOL
+};
 
 /** **************************************************************************
- * @brief Determines if the point is located in the menu item
+ * @brief Returns true if the item is one of the colors
  *
- * @param[in] xLoc - the x location of the point 
- * @param[in] yLoc - the y location of the point
+ * @param[in] item - the palette item
  ******************************************************************************/
-bool MenuItem::contains(int xLoc, int yLoc)
+bool isColorItem(PaletteItem item)
 {
-    if (xLoc >= xMin && xLoc <= xMax && yLoc >= yMin && yLoc <= yMax)
-    {
-        return true;
-    }
-    return false;
+    return item >= FIRST_COLOR_ITEM && item < FIRST_TOOL_ITEM;
 }
 
 /** **************************************************************************
- * @brief Sets the color value associated with the menu item
- ******************************************************************************/
-void MenuItem::selectCol(float *col) {}
-
-/** **************************************************************************
- * @brief Returns the color value of the menu item
+ * @brief Returns true if the item is one of the tools
+ *
+ * @param[in] item - the palette item
  ******************************************************************************/
-float *MenuItem::getColor() { return {0}; }
+bool isToolItem(PaletteItem item)
+{
+    return item >= FIRST_TOOL_ITEM && item < PALETTE_ITEMS;
+}
 
 /** **************************************************************************
- * @brief sets the menu item's selected tool
- * 
- * @param [in] xloc - x location of the selected tool
- * @param [in] yloc - y location of the selected tool
+ * @brief Returns the color value of a color item
+ *
+ * @param[in] item - the palette item, must be a color
  ******************************************************************************/
-std::string MenuItem::selectTool(int xloc, int yloc) {return "";}
+const float *itemColor(PaletteItem item)
+{
+    return COLORS[item - FIRST_COLOR_ITEM];
+}
 
 /** **************************************************************************
- * @brief Returns the type of the menu item
+ * @brief Returns the tool a tool item selects
+ *
+ * @param[in] item - the palette item, must be a tool
  ******************************************************************************/
-std::string MenuItem::getType()
+ToolId itemTool(PaletteItem item)
 {
-    return type;
+    return TOOLS[item - FIRST_TOOL_ITEM];
 }
 
-// Color
 /** **************************************************************************
- * @brief Constructor for a menu item
+ * @brief Computes where every cell is for a row height
  *
- * @param[in] xmin - the minimum x location of the color item selection square
- * @param[in] xmax - the mmaximum x location of the color item selection square
- * @param[in] ymin - the minimum y location of the color item selection square
- * @param[in] ymax - the maximum y location of the color item selection square
- * @param[in] col - the color value of the color item
+ * Colors are inset by a pixel on the left, the line tool spans one pixel
+ * past its column, as the toolbox has always been drawn
+ *
+ * @param[in] rowHeight - the height of a row of cells in pixels
  ******************************************************************************/
-Color::Color(int xmin, int xmax, int ymin, int ymax, const float col[])
+void ToolboxLayout::layout(int rowHeight)
 {
-    xMax = xmax; 
-    xMin = xmin; 
-    yMax = ymax; 
-    yMin = ymin;
-    type = "color";
-
-    for(int i = 0; i < 3; i++)
-        color[i] = col[i];
+    toolHeight = rowHeight;
+    for (int row = 0; row < PALETTE_ROWS; row++)
+    {
+        for (int column = 0; column < PALETTE_COLUMNS; column++)
+        {
+            PaletteItem item = CELLS[row][column];
+            int left = column * PALETTE_COLUMN;
+            int right = column == 0 ? PALETTE_COLUMN - 1 : PALETTE_WIDTH;
+            if (isColorItem(item) && column == 0)
+                left = 1;
+            if (item == LINE_ITEM)
+                right = PALETTE_COLUMN;
+            areas[item] = Box(left, row * rowHeight, right, (row + 1) * rowHeight, 0);
+        }
+    }
+    areas[NO_ITEM] = Box();
 }
 
 /** **************************************************************************
- * @brief Returns the color value of the color item
+ * @brief Returns the height of a row of cells, 0 before the first layout
  ******************************************************************************/
-float* Color::getColor()
+int ToolboxLayout::rowHeight() const
 {
-    return color;
+    return toolHeight;
 }
 
 /** **************************************************************************
- * @brief Sets the provided color value to the color value of the color item
- * 
- * @param[in,out] selection - the color value being modified by the color of tool
+ * @brief Returns the item under a point
+ *
+ * @param[in] x - the x location of the point
+ * @param[in] y - the y location of the point
+ *
+ * @returns the item, NO_ITEM if the point is on no cell
  ******************************************************************************/
-void Color::selectCol(float selection[])
+PaletteItem ToolboxLayout::itemAt(int x, int y) const
 {
-    for(int i = 0; i < 3; i++)
-        selection[i] = color[i];
+    if (toolHeight <= 0 || x < 0 || x > PALETTE_WIDTH || y < 0)
+        return NO_ITEM;
+    int row = y / toolHeight;
+    if (row == PALETTE_ROWS && y == PALETTE_ROWS * toolHeight)   // the top edge of the last row
+        row--;
+    if (row >= PALETTE_ROWS)
+        return NO_ITEM;
+    PaletteItem item = CELLS[row][x < PALETTE_COLUMN ? 0 : 1];
+    if (item == NO_ITEM)   // a cell may reach past its column
+        item = CELLS[row][0];
+    const Box &cell = areas[item];
+    return x >= cell.left && x <= cell.right ? item : NO_ITEM;
 }
 
-// Tool
 /** **************************************************************************
- * @brief Constructor for a tool item
+ * @brief Returns the pixels an item covers, empty for NO_ITEM
  *
- * @param[in] xmin - the minimum x location of the tool item selection square
- * @param[in] xmax - the mmaximum x location of the tool item selection square
- * @param[in] ymin - the minimum y location of the tool item selection square
- * @param[in] ymax - the maximum y location of the tool item selection square
- * @param[in] ty - the type of tool
+ * @param[in] item - the palette item
  ******************************************************************************/
-Tool::Tool(int xmin, int xmax, int ymin, int ymax, std::string ty)
+const Box &ToolboxLayout::area(PaletteItem item) const
 {
-    xMax = xmax; 
-    xMin = xmin; 
-    yMax = ymax; 
-    yMin = ymin;
-    type = ty;
+    return areas[item];
 }
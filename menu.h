@@ -1,58 +1,61 @@
 /** ***************************************************************************
 * @file
-* @brief Header file that holds the MenuItem abstract class and it's inherited 
-*         successor classes
+* @brief Header file that holds the toolbox layout table, which names every
+*         palette cell and finds the cell under a point by arithmetic
 ******************************************************************************/
 
 #ifndef __MENU_H
 #define __MENU_H
 
-#include <string>
-#include <iostream>
+#include <cstdint>
+#include "box.h"
+#include "tools.h"
 
 /*!
- * @brief MenuItem class, abstract class that holds location and values for menu item
+ * @brief The items of the toolbox, the colors first then the tools
  */
-class MenuItem
+enum PaletteItem : uint8_t
 {
-    protected:
-        int xMin;           /*!< the minimum x position of the menu item box */
-        int xMax;           /*!< the maximum x position of the menu item box */
-        int yMin;           /*!< the minimum y position of the menu item box */
-        int yMax;           /*!< the maximum y position of the menu item box */
-        std::string type;   /*!< the type/name of menu item */
-    public:
-        MenuItem(); // Base Constructor for MenuItem
-        MenuItem(int xmin, int xmax, int ymin, int ymax, std::string ty);   // Primary constructor for MenuItem
-
-        bool contains(int xLoc, int yLoc);                  // checks to see if the menu item contains the provided point
-
-        virtual void selectCol(float *color);               // sets the selected color
-        virtual float* getColor();                          // returns the selected color
-        virtual std::string selectTool(int xloc, int yloc); // selects the tool
-
-        std::string getType();                              // returns the type of menu item
+    NO_ITEM,
+    WHITE_ITEM, RED_ITEM, ORANGE_ITEM, YELLOW_ITEM,
+    GREEN_ITEM, BLUE_ITEM, PURPLE_ITEM, GRAY_ITEM,
+    BLACK_ITEM, DARKRED_ITEM, DARKORANGE_ITEM, DARKYELLOW_ITEM,
+    DARKGREEN_ITEM, DARKBLUE_ITEM, DARKPURPLE_ITEM, DARKGRAY_ITEM,
+    UNFILLED_SQUARE_ITEM, FILLED_SQUARE_ITEM, UNFILLED_CIRCLE_ITEM,
+    FILLED_CIRCLE_ITEM, UNFILLED_ELLIPSE_ITEM, FILLED_ELLIPSE_ITEM, LINE_ITEM,
+    PALETTE_ITEMS
 };
 
-/*!
- * @brief Color class, inherited from MenuItem, holds a chooseable color value
- */
-class Color : public MenuItem 
-{    
-    protected:
-        float color[3];   /*!< The color value tied to the color MenuItem */                                                  // the color value of the color item
-    public:        
-        Color(int xmin, int xmax, int ymin, int ymax, const float col[]);   // constructs a color item
-        float* getColor();                                                  // returns the color value
-        void selectCol(float selection[]);                                  // selects the color value
-};
+const PaletteItem FIRST_COLOR_ITEM = WHITE_ITEM;            /*!< the first color in PaletteItem */
+const PaletteItem FIRST_TOOL_ITEM = UNFILLED_SQUARE_ITEM;   /*!< the first tool in PaletteItem */
+const int PALETTE_ROWS = 12;        /*!< rows of cells, eight of colors then four of tools */
+const int PALETTE_COLUMNS = 2;      /*!< cells in a row */
+const int PALETTE_COLUMN = 50;      /*!< the width of a column of cells in pixels */
+const int PALETTE_WIDTH = 100;      /*!< the rightmost pixel of the cells */
+
+bool isColorItem(PaletteItem item);         // returns true if the item is a color
+bool isToolItem(PaletteItem item);          // returns true if the item is a tool
+const float *itemColor(PaletteItem item);   // returns the color of a color item
+ToolId itemTool(PaletteItem item);          // returns the tool of a tool item
 
 /*!
- * @brief Tool Class, inherited form MenuItem, holds a tool type
+ * @brief ToolboxLayout class, where every palette cell is for the current window size
+ *
+ * The cells are rows of equal height from the bottom of the window, two to
+ * a row, so the cell under a point is found by dividing by the row height
+ * and looking the row and column up in a fixed table, then checking the
+ * point against that one cell. A point on the edge between two rows belongs
+ * to the upper one.
  */
-class Tool : public MenuItem
+class ToolboxLayout
 {
-    public:
-        Tool (int xmin, int xmax, int ymin, int ymax, std::string ty);      // constructs a tool item
+    int toolHeight = 0;         /*!< the height of a row of cells, 0 before the first layout */
+    Box areas[PALETTE_ITEMS];   /*!< the pixels each item covers */
+public:
+    void layout(int rowHeight);                 // computes the cells for a row height
+    int rowHeight() const;                      // returns the height of a row of cells
+    PaletteItem itemAt(int x, int y) const;     // returns the item under a point, NO_ITEM if none
+    const Box &area(PaletteItem item) const;    // returns the pixels an item covers
 };
-#endif
\ No newline at end of file
+
+#endif
@@ -0,0 +1,331 @@
+/** ***************************************************************************
+* @file
+* @brief Cpp file including functions for the raster.h, holds the software
+* rasterizer which fills spans, triangles and lines of a framebuffer
+*
+* The span fill is the only loop that touches many pixels. Its inner loop
+* writes RASTER_LANES pixels with a fixed trip count and no branches, so the
+* compiler turns it into vector stores, the rest only works out which spans
+* to fill.
+******************************************************************************/
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include "raster.h"
+
+/** **************************************************************************
+ * @brief Constructor for a framebuffer cleared to 0
+ *
+ * @param[in] width - the width in pixels
+ * @param[in] height - the height in pixels
+ ******************************************************************************/
+Framebuffer::Framebuffer(int width, int height)
+{
+   resize(width, height);
+}
+
+/** **************************************************************************
+ * @brief Changes the size of the framebuffer, every pixel is set to 0
+ *
+ * @param[in] width - the width in pixels
+ * @param[in] height - the height in pixels
+ ******************************************************************************/
+void Framebuffer::resize(int width, int height)
+{
+   columns = std::max(width, 0);
+   rows = std::max(height, 0);
+   pixels.assign(size_t(columns) * rows, 0);
+}
+
+/** **************************************************************************
+ * @brief Places the framebuffer over part of a larger image, drawing is
+ * given in image pixels from then on
+ *
+ * @param[in] x - the image column of its left column
+ * @param[in] y - the image row of its bottom row
+ ******************************************************************************/
+void Framebuffer::place(int x, int y)
+{
+   originX = x;
+   originY = y;
+}
+
+/** **************************************************************************
+ * @brief Copies the pixels of an image that this framebuffer covers
+ *
+ * @param[in] image - the image, placed like this framebuffer or at 0, 0
+ ******************************************************************************/
+void Framebuffer::load(const Framebuffer &image)
+{
+   int left = std::max(originX, image.originX);
+   int right = std::min(originX + columns, image.originX + image.columns);
+   int bottom = std::max(originY, image.originY);
+   int top = std::min(originY + rows, image.originY + image.rows);
+   for (int y = bottom; y < top && left < right; y++)
+      std::copy_n(&image.pixels[size_t(y - image.originY) * image.columns + left - image.originX],
+                  right - left, &pixels[size_t(y - originY) * columns + left - originX]);
+}
+
+/** **************************************************************************
+ * @brief Copies the pixels of this framebuffer into an image it covers
+ *
+ * @param[in,out] image - the image, the pixels outside this one are kept
+ ******************************************************************************/
+void Framebuffer::store(Framebuffer &image) const
+{
+   int left = std::max(originX, image.originX);
+   int right = std::min(originX + columns, image.originX + image.columns);
+   int bottom = std::max(originY, image.originY);
+   int top = std::min(originY + rows, image.originY + image.rows);
+   for (int y = bottom; y < top && left < right; y++)
+      std::copy_n(&pixels[size_t(y - originY) * columns + left - originX],
+                  right - left, &image.pixels[size_t(y - image.originY) * image.columns + left - image.originX]);
+}
+
+/** **************************************************************************
+ * @brief Sets every pixel to a color
+ *
+ * @param[in] color - the packed color
+ ******************************************************************************/
+void Framebuffer::clear(uint32_t color)
+{
+   for (int y = originY; y < originY + rows; y++)
+      fillSpan(y, originX, originX + columns, color);
+}
+
+/** **************************************************************************
+ * @brief Returns the width in pixels
+ ******************************************************************************/
+int Framebuffer::width() const
+{
+   return columns;
+}
+
+/** **************************************************************************
+ * @brief Returns the height in pixels
+ ******************************************************************************/
+int Framebuffer::height() const
+{
+   return rows;
+}
+
+/** **************************************************************************
+ * @brief Returns the pixels, bottom row first, each row width() pixels long
+ ******************************************************************************/
+const uint32_t *Framebuffer::data() const
+{
+   return pixels.data();
+}
+
+/** **************************************************************************
+ * @brief Returns a pixel
+ *
+ * @param[in] x - the image column
+ * @param[in] y - the image row, 0 at the bottom
+ *
+ * @returns the packed color, 0 outside the framebuffer
+ ******************************************************************************/
+uint32_t Framebuffer::pixel(int x, int y) const
+{
+   x -= originX;
+   y -= originY;
+   if (x < 0 || y < 0 || x >= columns || y >= rows)
+      return 0;
+   return pixels[size_t(y) * columns + x];
+}
+
+/** **************************************************************************
+ * @brief Fills part of a row with a color, clipped to the framebuffer
+ *
+ * @param[in] y - the image row, 0 at the bottom
+ * @param[in] x0 - the first image column filled
+ * @param[in] x1 - the image column after the last one filled
+ * @param[in] color - the packed color
+ ******************************************************************************/
+void Framebuffer::fillSpan(int y, int x0, int x1, uint32_t color)
+{
+   y -= originY;
+   if (y < 0 || y >= rows)
+      return;
+   x0 = std::max(x0 - originX, 0);
+   x1 = std::min(x1 - originX, columns);
+   if (x0 >= x1)
+      return;
+
+   uint32_t *out = &pixels[size_t(y) * columns + x0];
+   int n = x1 - x0;
+   int i = 0;
+   for (; i + RASTER_LANES <= n; i += RASTER_LANES)
+      for (int lane = 0; lane < RASTER_LANES; lane++)
+         out[i + lane] = color;
+   for (; i < n; i++)
+      out[i] = color;
+}
+
+/** **************************************************************************
+ * @brief Fills the pixels whose center is inside a triangle
+ *
+ * Each row is filled between the two edges its center crosses. An edge
+ * counts for the centers from its lower end up to, not including, its upper
+ * end, and a span runs from its left edge up to, not including, its right
+ * edge, so triangles sharing an edge, as the fans of a polygon do, never
+ * fill a pixel twice or leave a gap.
+ *
+ * @param[in] x - the x locations of the corners
+ * @param[in] y - the y locations of the corners
+ * @param[in] color - the packed color
+ ******************************************************************************/
+void Framebuffer::fillTriangle(const float x[3], const float y[3], uint32_t color)
+{
+   if (std::max(x[0], std::max(x[1], x[2])) < originX ||
+       std::min(x[0], std::min(x[1], x[2])) > originX + columns)
+      return;   // beside the framebuffer, i.e. a tile
+   float low = std::min(y[0], std::min(y[1], y[2]));
+   float high = std::max(y[0], std::max(y[1], y[2]));
+   int top = originY + rows;
+   int first = std::max(int(std::ceil(std::max(low, originY - 1.0f) - 0.5f)), originY);
+   int last = std::min(int(std::ceil(std::min(high, top + 1.0f) - 0.5f)), top);
+
+   float step[3];   // x change per row of each edge
+   for (int e = 0; e < 3; e++)
+   {
+      int next = (e + 1) % 3;
+      step[e] = y[next] != y[e] ? (x[next] - x[e]) / (y[next] - y[e]) : 0.0f;
+   }
+
+   for (int row = first; row < last; row++)
+   {
+      float center = row + 0.5f;
+      float left = INFINITY;
+      float right = -INFINITY;
+      for (int e = 0; e < 3; e++)
+      {
+         int next = (e + 1) % 3;
+         if ((y[e] <= center) != (y[next] <= center))
+         {
+            float at = x[e] + (center - y[e]) * step[e];
+            left = std::min(left, at);
+            right = std::max(right, at);
+         }
+      }
+      if (left >= right)
+         continue;
+      left = std::max(left, originX - 1.0f);
+      right = std::min(right, originX + columns + 1.0f);
+      fillSpan(row, int(std::ceil(left - 0.5f)), int(std::ceil(right - 0.5f)), color);
+   }
+}
+
+/** **************************************************************************
+ * @brief Draws a line one pixel wide, without its last pixel
+ *
+ * The line is walked along its longer axis one pixel center at a time and
+ * the pixel the line crosses there is drawn, so every column (or row) from
+ * the start up to the end gets one pixel, like OpenGL's diamond rule for
+ * lines. A line running exactly between two pixels draws the one below or
+ * to the left of it, as Mesa does. Along a mostly flat line the pixels of
+ * each row are filled as one span.
+ *
+ * @param[in] x0, y0 - the start of the line
+ * @param[in] x1, y1 - the end of the line
+ * @param[in] color - the packed color
+ ******************************************************************************/
+void Framebuffer::drawLine(float x0, float y0, float x1, float y1, uint32_t color)
+{
+   float dx = x1 - x0;
+   float dy = y1 - y0;
+   bool flat = std::fabs(dx) >= std::fabs(dy);
+   float from = flat ? x0 : y0;   // the start and end along the longer axis
+   float to = flat ? x1 : y1;
+   float start = flat ? y0 : x0;  // the start across it
+   if (from == to)
+      return;
+   float across = flat ? y1 : x1;
+   int side = flat ? originY : originX;   // the framebuffer across the longer axis
+   if (std::max(start, across) < side || std::min(start, across) > side + (flat ? rows : columns))
+      return;   // beside the framebuffer, i.e. a tile
+
+   int lowest = flat ? originX : originY;    // the framebuffer along the longer axis
+   int limit = lowest + (flat ? columns : rows);
+   int first;   // the pixels along the longer axis, the end excluded whichever way the line goes
+   int last;
+   if (to > from)
+   {
+      first = int(std::ceil(std::max(from, lowest - 1.0f) - 0.5f));
+      last = int(std::ceil(std::min(to, limit + 1.0f) - 0.5f)) - 1;
+   }
+   else
+   {
+      first = int(std::floor(std::max(to, lowest - 1.0f) - 0.5f)) + 1;
+      last = int(std::floor(std::min(from, limit + 1.0f) - 0.5f));
+   }
+   first = std::max(first, lowest);
+   last = std::min(last, limit - 1);
+   float slope = flat ? dy / dx : dx / dy;
+
+   if (!flat)
+   {
+      for (int row = first; row <= last; row++)
+      {
+         int column = int(std::ceil(start + (row + 0.5f - from) * slope)) - 1 - originX;
+         if (column >= 0 && column < columns)
+            pixels[size_t(row - originY) * columns + column] = color;
+      }
+      return;
+   }
+
+   int runStart = first;   // the columns of the current row not filled yet
+   int runRow = 0;
+   for (int column = first; column <= last; column++)
+   {
+      int row = int(std::ceil(start + (column + 0.5f - from) * slope)) - 1;
+      if (column != first && row != runRow)
+      {
+         fillSpan(runRow, runStart, column, color);
+         runStart = column;
+      }
+      runRow = row;
+   }
+   if (first <= last)
+      fillSpan(runRow, runStart, last + 1, color);
+}
+
+/** **************************************************************************
+ * @brief Saves the image as a binary PPM, the top row first as PPM expects
+ *
+ * @param[in] path - the file to write
+ *
+ * @returns true if the whole image was written
+ ******************************************************************************/
+bool Framebuffer::writePPM(const char *path) const
+{
+   FILE *file = fopen(path, "wb");
+   if (file == nullptr)
+      return false;
+   bool ok = fprintf(file, "P6\n%d %d\n255\n", columns, rows) > 0;
+   std::vector<uint8_t> line(size_t(columns) * 3);
+   for (int y = rows - 1; y >= 0 && ok; y--)
+   {
+      const uint8_t *in = reinterpret_cast<const uint8_t *>(&pixels[size_t(y) * columns]);
+      for (int x = 0; x < columns; x++)
+         for (int c = 0; c < 3; c++)
+            line[3 * x + c] = in[4 * x + c];
+      ok = fwrite(line.data(), 1, line.size(), file) == line.size();
+   }
+   return fclose(file) == 0 && ok;
+}
+
+/** **************************************************************************
+ * @brief Packs a color into a pixel
+ *
+ * @param[in] color - red, green, blue and alpha bytes
+ *
+ * @returns the pixel, whose bytes in memory are the color bytes in order
+ ******************************************************************************/
+uint32_t packColor(const uint8_t color[4])
+{
+   uint32_t pixel;
+   std::copy(color, color + 4, reinterpret_cast<uint8_t *>(&pixel));
+   return pixel;
+}
@@ -0,0 +1,61 @@
+/** ***************************************************************************
+* @file
+* @brief Header file that holds the Framebuffer class, an RGBA image in memory
+* that render lists are rasterized into without OpenGL or a window
+******************************************************************************/
+
+#ifndef __RASTER_H
+#define __RASTER_H
+
+#include <cstdint>
+#include <vector>
+
+const int RASTER_LANES = 8;     /*!< pixels a span fill writes with one pass of its inner loop */
+
+/*!
+ * @brief Framebuffer class, pixels the software rasterizer draws into
+ *
+ * A pixel is four bytes in memory, red, green, blue and alpha, which is how
+ * glReadPixels returns GL_RGBA and GL_UNSIGNED_BYTE. Row 0 is the bottom of
+ * the image, as in the window, so a readback and a framebuffer of the same
+ * size compare byte for byte.
+ *
+ * A framebuffer can also hold one tile of a larger image, placed at the
+ * pixel of the image its bottom left corner covers. Everything is given in
+ * image pixels and whatever falls outside the tile is clipped, so the same
+ * drawing can be split across tiles.
+ *
+ * Everything is drawn from rows of pixels. A span fill writes RASTER_LANES
+ * pixels per pass of a loop with a fixed trip count, which the compiler
+ * turns into vector stores. Pixels are sampled at their centers: triangles
+ * cover the pixels whose center is inside, left and bottom edges included,
+ * and lines leave out their last pixel, so shared edges and joined segments
+ * are not drawn twice.
+ */
+class Framebuffer
+{
+    int columns = 0;                /*!< the width in pixels */
+    int rows = 0;                   /*!< the height in pixels */
+    int originX = 0;                /*!< the image column of the first pixel of a row */
+    int originY = 0;                /*!< the image row of the bottom row */
+    std::vector<uint32_t> pixels;   /*!< the pixels, bottom row first */
+public:
+    Framebuffer(int width = 0, int height = 0);
+    void resize(int width, int height);         // changes the size, the pixels are cleared to 0
+    void place(int x, int y);                   // sets the image pixel the bottom left pixel covers
+    void load(const Framebuffer &image);        // copies the pixels of an image this one covers
+    void store(Framebuffer &image) const;       // copies these pixels into the image
+    void clear(uint32_t color);                 // sets every pixel to a color
+    int width() const;                          // returns the width in pixels
+    int height() const;                         // returns the height in pixels
+    const uint32_t *data() const;               // returns the pixels, bottom row first
+    uint32_t pixel(int x, int y) const;         // returns a pixel, 0 outside the framebuffer
+    void fillSpan(int y, int x0, int x1, uint32_t color);   // fills columns x0 to x1 - 1 of a row
+    void fillTriangle(const float x[3], const float y[3], uint32_t color);  // fills a triangle
+    void drawLine(float x0, float y0, float x1, float y1, uint32_t color);  // draws a one pixel line
+    bool writePPM(const char *path) const;      // saves the image as a binary PPM, top row first
+};
+
+uint32_t packColor(const uint8_t color[4]);     // packs RGBA bytes into a pixel
+
+#endif
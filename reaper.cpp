@@ -0,0 +1,90 @@
+/** ***************************************************************************
+* @file
+* @brief Cpp file including functions for the reaper.h, holds the reaper
+* thread
+*
+* A clear that falls out of the undo history leaves the order, store, grid
+* and records of every shape it cleared, hundreds of thousands of tree nodes
+* and buckets on a large canvas. Their shapes are released by the scene
+* thread, the arena is its own, and the indexes, which no longer point at
+* anything it uses, are handed here to be destroyed. The thread is started
+* by the first set handed over and stopped at exit.
+******************************************************************************/
+
+#include <condition_variable>
+#include <cstdlib>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include "reaper.h"
+#include "history.h"
+
+static std::thread reaper;              // destroys the queued indexes, off the scene thread
+static std::mutex queueLock;            // guards what follows
+static std::condition_variable wake;    // signalled when there is work or on stop
+static std::deque<std::unique_ptr<SceneParts>> queued;     // indexes not yet destroyed
+static bool started = false;            // set once the reaper thread was started
+static bool stopping = false;           // set to make the reaper finish, it is not started again
+
+/** **************************************************************************
+ * @brief The body of the reaper thread, destroys whatever was queued until
+ * stopped, then what is left
+ ******************************************************************************/
+static void reap()
+{
+   std::unique_lock<std::mutex> guard(queueLock);
+   while (true)
+   {
+      wake.wait(guard, [] { return stopping || !queued.empty(); });
+      if (queued.empty())
+         break;   // stopping with nothing left
+      std::unique_ptr<SceneParts> parts = std::move(queued.front());
+      guard.unlock();
+      parts.reset();   // the long part, without the lock
+      guard.lock();
+      queued.pop_front();
+   }
+}
+
+/** **************************************************************************
+ * @brief Queues a set of indexes to be destroyed on the reaper thread
+ *
+ * Their shapes must already be released, the reaper only frees the indexes.
+ * Once the reaper was stopped they are destroyed on the calling thread.
+ *
+ * @param[in] parts - the indexes
+ ******************************************************************************/
+void reapParts(std::unique_ptr<SceneParts> parts)
+{
+   {
+      std::lock_guard<std::mutex> guard(queueLock);
+      if (!stopping)
+      {
+         queued.push_back(std::move(parts));
+         if (!started)
+         {
+            started = true;
+            reaper = std::thread(reap);
+            std::atexit(stopReaper);
+         }
+      }
+   }
+   wake.notify_one();
+}
+
+/** **************************************************************************
+ * @brief Destroys what is queued and stops the reaper thread, if it runs
+ ******************************************************************************/
+void stopReaper()
+{
+   {
+      std::lock_guard<std::mutex> guard(queueLock);
+      if (stopping)
+         return;
+      stopping = true;
+   }
+   wake.notify_one();
+   if (reaper.joinable())
+      reaper.join();
+}
+
@@ -0,0 +1,18 @@
+/** ***************************************************************************
+* @file
+* @brief Header file that holds the reaper, a background thread which
+* destroys the indexes of shapes no command can bring back, so the scene
+* thread never waits on freeing them
+******************************************************************************/
+
+#ifndef __REAPER_H
+#define __REAPER_H
+
+#include <memory>
+
+struct SceneParts;
+
+void reapParts(std::unique_ptr<SceneParts> parts);  // destroys a set of indexes off the scene thread
+void stopReaper();                                  // destroys what is queued and stops the reaper
+
+#endif
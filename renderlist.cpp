@@ -0,0 +1,427 @@
+/** ***************************************************************************
+* @file
+* @brief Cpp file including functions for the renderlist.h, holds the functions
+* which record drawing into batched vertex arrays and draw them with OpenGL
+******************************************************************************/
+
+#define GL_GLEXT_PROTOTYPES   // vertex buffer functions, must come before any GL header
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <cstddef>
+#include "renderlist.h"
+#include "stats.h"
+
+/** **************************************************************************
+ * @brief Constructor for an empty render list, drawing in white
+ ******************************************************************************/
+RenderList::RenderList() : mode(GL_POINTS), base(0), layer(0), buffers{0, 0, 0}, uploaded(false)
+{
+   color(WHITE);
+}
+
+/** **************************************************************************
+ * @brief Destructor, deletes the vertex buffers if the list was ever drawn
+ *
+ * Only submit makes the buffers, so a list that was drawn is destroyed by
+ * the thread that owns the OpenGL context
+ ******************************************************************************/
+RenderList::~RenderList()
+{
+   if(buffers[0] != 0)
+      glDeleteBuffers(3, buffers);
+}
+
+/** **************************************************************************
+ * @brief Copies the drawing recorded in another list
+ *
+ * The vertex buffers are not shared, this list uploads the copy into its own
+ * the next time it is drawn
+ *
+ * @param[in] other - the list to copy
+ ******************************************************************************/
+RenderList &RenderList::operator=(const RenderList &other)
+{
+   vertices = other.vertices;
+   triangles = other.triangles;
+   lines = other.lines;
+   spans = other.spans;
+   labels = other.labels;
+   mode = other.mode;
+   base = other.base;
+   for(int i = 0; i < 4; i++)
+      current[i] = other.current[i];
+   layer = other.layer;
+   uploaded = false;
+   return *this;
+}
+
+/** **************************************************************************
+ * @brief Removes all recorded drawing
+ *
+ * The vectors keep their capacity, so a list reused every frame stops
+ * allocating once it has seen the largest frame
+ ******************************************************************************/
+void RenderList::clear()
+{
+   vertices.clear();
+   triangles.clear();
+   lines.clear();
+   spans.clear();
+   labels.clear();
+   base = 0;
+   layer = 0;
+   uploaded = false;
+}
+
+/** **************************************************************************
+ * @brief Sets the color used by the primitives that follow
+ *
+ * @param[in] col - the color to draw with
+ ******************************************************************************/
+void RenderList::color(const float col[])
+{
+   for(int i = 0; i < 3; i++)
+      current[i] = GLubyte(col[i] * 255.0f + 0.5f);
+   current[3] = 255;
+}
+
+/** **************************************************************************
+ * @brief Starts recording a primitive
+ *
+ * @param[in] mode - the OpenGL primitive, i.e. GL_LINE_LOOP or GL_POLYGON
+ ******************************************************************************/
+void RenderList::begin(GLenum mode)
+{
+   this->mode = mode;
+   base = GLuint(vertices.size());
+}
+
+/** **************************************************************************
+ * @brief Adds a vertex to the primitive being recorded
+ *
+ * @param[in] x - the x location of the vertex
+ * @param[in] y - the y location of the vertex
+ ******************************************************************************/
+void RenderList::vertex(float x, float y)
+{
+   Vertex v = {x, y, float(layer + 1), {current[0], current[1], current[2], current[3]}};
+   vertices.push_back(v);
+}
+
+/** **************************************************************************
+ * @brief Adds a run of vertices to the primitive being recorded, moved by an offset
+ *
+ * Used to place geometry a shape keeps around its own origin, the points are
+ * only copied and moved, nothing about them is recomputed
+ *
+ * @param[in] xy - x/y pairs relative to the offset
+ * @param[in] x - the x offset added to every point
+ * @param[in] y - the y offset added to every point
+ ******************************************************************************/
+void RenderList::points(const vector<float> &xy, float x, float y)
+{
+   size_t first = vertices.size();
+   size_t n = xy.size() / 2;
+   vertices.resize(first + n);
+   Vertex *out = &vertices[first];
+   float z = float(layer + 1);
+   for(size_t i = 0; i < n; i++)
+   {
+      out[i].x = xy[2 * i] + x;
+      out[i].y = xy[2 * i + 1] + y;
+      out[i].z = z;
+      for(int c = 0; c < 4; c++)
+         out[i].color[c] = current[c];
+   }
+}
+
+/** **************************************************************************
+ * @brief Ends the primitive being recorded and adds it to its batch
+ *
+ * The vertices were stored as they were recorded. Polygons become triangle
+ * fans and line loops become separate segments, both as indices, so
+ * every primitive of a frame fits in one of two batches. Polygons are assumed
+ * to be convex, as OpenGL requires of GL_POLYGON.
+ ******************************************************************************/
+void RenderList::end()
+{
+   int n = int(vertices.size() - base);
+   bool filled = mode == GL_POLYGON || mode == GL_TRIANGLE_FAN ||
+                 mode == GL_TRIANGLES || mode == GL_QUADS;
+   vector<GLuint> &batch = filled ? triangles : lines;
+   Span span = {GLenum(filled ? GL_TRIANGLES : GL_LINES), unsigned(batch.size()), 0};
+
+   switch(mode)
+   {
+      case GL_LINES:
+         for(int i = 0; i + 1 < n; i += 2)
+         {
+            batch.push_back(base + i);
+            batch.push_back(base + i + 1);
+         }
+         break;
+      case GL_LINE_LOOP:
+      case GL_LINE_STRIP:
+         for(int i = 0; i + 1 < n; i++)
+         {
+            batch.push_back(base + i);
+            batch.push_back(base + i + 1);
+         }
+         if(mode == GL_LINE_LOOP && n > 2)
+         {
+            batch.push_back(base + n - 1);
+            batch.push_back(base);
+         }
+         break;
+      case GL_POLYGON:
+      case GL_TRIANGLE_FAN:
+         for(int i = 1; i + 1 < n; i++)
+         {
+            batch.push_back(base);
+            batch.push_back(base + i);
+            batch.push_back(base + i + 1);
+         }
+         break;
+      case GL_TRIANGLES:
+         for(int i = 0; i + 2 < n; i += 3)
+            for(int k = 0; k < 3; k++)
+               batch.push_back(base + i + k);
+         break;
+      case GL_QUADS:
+         for(int i = 0; i + 3 < n; i += 4)
+         {
+            GLuint quad[6] = {0, 1, 2, 0, 2, 3};
+            for(int k = 0; k < 6; k++)
+               batch.push_back(base + i + quad[k]);
+         }
+         break;
+   }
+
+   span.count = unsigned(batch.size()) - span.first;
+   if(span.count != 0)
+   {
+      spans.push_back(span);
+      layer++;
+   }
+   else
+      vertices.resize(base);   // nothing drawn, i.e. a single point
+}
+
+/** **************************************************************************
+ * @brief Records bitmap text drawn with the current color
+ *
+ * @param[in] x - the x location of the text
+ * @param[in] y - the y location of the text
+ * @param[in] str - the text, it must outlive the render list
+ ******************************************************************************/
+void RenderList::text(float x, float y, const char *str)
+{
+   Label label = {x, y, {current[0] / 255.0f, current[1] / 255.0f, current[2] / 255.0f}, str};
+   labels.push_back(label);
+}
+
+/** **************************************************************************
+ * @brief Returns the number of primitives recorded, not counting text
+ ******************************************************************************/
+unsigned RenderList::primitives() const
+{
+   return layer;
+}
+
+/** **************************************************************************
+ * @brief Draws the recorded text, on top of everything else
+ ******************************************************************************/
+void RenderList::drawLabels() const
+{
+   if(!windowOpen())   // glut fonts are only available with a window
+      return;
+   for(size_t l = 0; l < labels.size(); l++)
+   {
+      glColor3fv(labels[l].color);
+      glRasterPos2f(labels[l].x, labels[l].y);
+      for(int i = 0; labels[l].text[i] != '\0'; i++)
+         glutBitmapCharacter(GLUT_BITMAP_8_BY_13, labels[l].text[i]);
+   }
+}
+
+/** **************************************************************************
+ * @brief Draws the recorded frame from vertex buffers
+ *
+ * The vertices and both index batches are uploaded the first time the frame
+ * is drawn and reused when the same frame is drawn again, i.e. to repaint an
+ * uncovered window. All the triangles are drawn with one call and all the
+ * lines with another, the depth test puts later primitives in front. The
+ * window needs a depth buffer.
+ *
+ * An overlay list uses the near half of the depth range and every other list
+ * the far half, so an overlay is in front of whatever else was drawn in the
+ * frame, i.e. the toolbox over the shapes.
+ *
+ * Must be called from the thread that owns the OpenGL context
+ *
+ * @param[in] overlay - draw in front of the lists that are not overlays
+ ******************************************************************************/
+void RenderList::submit(bool overlay) const
+{
+   const vector<GLuint> *batches[2] = {&triangles, &lines};
+   const GLenum modes[2] = {GL_TRIANGLES, GL_LINES};
+
+   if(buffers[0] == 0)
+      glGenBuffers(3, buffers);
+   if(buffers[0] == 0)   // no OpenGL context, nothing can be drawn
+      return;
+
+   glMatrixMode(GL_MODELVIEW);
+   glPushMatrix();
+   glScalef(1.0f, 1.0f, 1.0f / float(layer + 1));   // the layers fit between the near and far planes
+   glEnable(GL_DEPTH_TEST);
+   glDepthRange(overlay ? 0.0 : 0.5, overlay ? 0.5 : 1.0);
+   glEnableClientState(GL_VERTEX_ARRAY);
+   glEnableClientState(GL_COLOR_ARRAY);
+
+   glBindBuffer(GL_ARRAY_BUFFER, buffers[0]);
+   if(!uploaded)
+      glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(Vertex), vertices.data(), GL_STREAM_DRAW);
+   glVertexPointer(3, GL_FLOAT, sizeof(Vertex), (const void *)offsetof(Vertex, x));
+   glColorPointer(4, GL_UNSIGNED_BYTE, sizeof(Vertex), (const void *)offsetof(Vertex, color));
+
+   for(int b = 0; b < 2; b++)
+   {
+      const vector<GLuint> &batch = *batches[b];
+      glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, buffers[b + 1]);
+      if(!uploaded)
+         glBufferData(GL_ELEMENT_ARRAY_BUFFER, batch.size() * sizeof(GLuint), batch.data(), GL_STREAM_DRAW);
+      if(batch.empty())
+         continue;
+      glDrawElements(modes[b], GLsizei(batch.size()), GL_UNSIGNED_INT, nullptr);
+      stats().drawCalls.fetch_add(1, std::memory_order_relaxed);
+   }
+   uploaded = true;
+
+   glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+   glBindBuffer(GL_ARRAY_BUFFER, 0);
+   glDisableClientState(GL_COLOR_ARRAY);
+   glDisableClientState(GL_VERTEX_ARRAY);
+   glDepthRange(0.0, 1.0);
+   glDisable(GL_DEPTH_TEST);
+   glPopMatrix();
+
+   drawLabels();
+}
+
+/** **************************************************************************
+ * @brief Draws the recorded frame in immediate mode, in recording order
+ *
+ * One glBegin/glEnd pair per primitive and one call per vertex, the way the
+ * shapes used to be drawn. Kept to measure the vertex buffers against.
+ *
+ * Must be called from the thread that owns the OpenGL context
+ ******************************************************************************/
+void RenderList::submitImmediate() const
+{
+   for(size_t s = 0; s < spans.size(); s++)
+   {
+      const vector<GLuint> &batch = spans[s].mode == GL_TRIANGLES ? triangles : lines;
+      glBegin(spans[s].mode);
+         for(unsigned i = spans[s].first; i < spans[s].first + spans[s].count; i++)
+         {
+            const Vertex &v = vertices[batch[i]];
+            glColor4ubv(v.color);
+            glVertex2f(v.x, v.y);
+         }
+      glEnd();
+      stats().drawCalls.fetch_add(1, std::memory_order_relaxed);
+   }
+
+   drawLabels();
+}
+
+/** **************************************************************************
+ * @brief Scales everything recorded about the origin, i.e. to export the
+ * frame at a larger size
+ *
+ * Lines stay one pixel wide, the text is not moved
+ *
+ * @param[in] factor - the scale, 1 leaves the drawing as it is
+ ******************************************************************************/
+void RenderList::scale(float factor)
+{
+   for(size_t i = 0; i < vertices.size(); i++)
+   {
+      vertices[i].x *= factor;
+      vertices[i].y *= factor;
+   }
+   uploaded = false;
+}
+
+/** **************************************************************************
+ * @brief Returns the pixels a recorded primitive may cover
+ *
+ * @param[in] primitive - the primitive, in recording order
+ ******************************************************************************/
+Box RenderList::bounds(unsigned primitive) const
+{
+   const Span &span = spans[primitive];
+   const vector<GLuint> &batch = span.mode == GL_TRIANGLES ? triangles : lines;
+   float low[2] = {INFINITY, INFINITY};
+   float high[2] = {-INFINITY, -INFINITY};
+   for(unsigned i = span.first; i < span.first + span.count; i++)
+   {
+      const Vertex &v = vertices[batch[i]];
+      low[0] = std::min(low[0], v.x);
+      low[1] = std::min(low[1], v.y);
+      high[0] = std::max(high[0], v.x);
+      high[1] = std::max(high[1], v.y);
+   }
+   const float far = INT_MAX / 4;   // keeps the ends of huge shapes in range of an int
+   return Box(int(std::floor(std::max(low[0], -far))), int(std::floor(std::max(low[1], -far))),
+              int(std::ceil(std::min(high[0], far))), int(std::ceil(std::min(high[1], far))), 1);
+}
+
+/** **************************************************************************
+ * @brief Draws one recorded primitive into a framebuffer with the software
+ * rasterizer
+ *
+ * @param[in] primitive - the primitive, in recording order
+ * @param[in,out] target - the framebuffer drawn into
+ ******************************************************************************/
+void RenderList::rasterize(unsigned primitive, Framebuffer &target) const
+{
+   const Span &span = spans[primitive];
+   bool filled = span.mode == GL_TRIANGLES;
+   const vector<GLuint> &batch = filled ? triangles : lines;
+   unsigned end = span.first + span.count;
+   uint32_t color = packColor(vertices[batch[span.first]].color);
+   for(unsigned i = span.first; i < end; i += filled ? 3 : 2)
+   {
+      const Vertex &a = vertices[batch[i]];
+      const Vertex &b = vertices[batch[i + 1]];
+      if(filled)
+      {
+         const Vertex &c = vertices[batch[i + 2]];
+         float x[3] = {a.x, b.x, c.x};
+         float y[3] = {a.y, b.y, c.y};
+         target.fillTriangle(x, y, color);
+      }
+      else
+         target.drawLine(a.x, a.y, b.x, b.y, color);
+   }
+}
+
+/** **************************************************************************
+ * @brief Draws the recorded frame into a framebuffer with the software
+ * rasterizer, in recording order
+ *
+ * Later primitives simply overwrite earlier ones, which is the order the
+ * depth test gives the vertex buffers. Needs no OpenGL context, so it runs on
+ * any thread and on hosts without a display. The text is left out, the glut
+ * fonts need a window.
+ *
+ * @param[in,out] target - the framebuffer drawn into
+ ******************************************************************************/
+void RenderList::rasterize(Framebuffer &target) const
+{
+   for(unsigned s = 0; s < spans.size(); s++)
+      rasterize(s, target);
+}
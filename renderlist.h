@@ -0,0 +1,98 @@
+/** ***************************************************************************
+* @file
+* @brief Header file that holds the RenderList class, a recorded frame of
+* drawing that is built away from OpenGL and submitted later by the GL thread
+******************************************************************************/
+
+#ifndef __RENDERLIST_H
+#define __RENDERLIST_H
+
+#include "graphics.h"
+#include "rendersink.h"
+#include "raster.h"
+#include "box.h"
+
+/*!
+ * @brief RenderList class, records immediate mode style drawing as batched
+ * vertex arrays so it can be built on one thread and drawn on another in a
+ * handful of draw calls
+ *
+ * Every primitive is turned into indexed triangles or line segments as it is
+ * recorded and given its own depth, later primitives in front of earlier
+ * ones. The depth keeps the painter's order when all the triangles and then
+ * all the lines are drawn with one glDrawElements call each.
+ *
+ * It is the sink the shapes and the toolbox draw into, the backend chosen at
+ * startup decides which of the ways below puts it on screen.
+ */
+class RenderList : public RenderSink
+{
+public:
+    /*!
+     * @brief One vertex of the batched geometry, as uploaded to the vertex buffer
+     */
+    struct Vertex
+    {
+        float x;            /*!< the x location of the vertex */
+        float y;            /*!< the y location of the vertex */
+        float z;            /*!< the drawing order of the primitive, larger is in front */
+        GLubyte color[4];   /*!< the color of the vertex */
+    };
+private:
+    /*!
+     * @brief The vertices one recorded primitive added to a batch
+     */
+    struct Span
+    {
+        GLenum mode;        /*!< GL_TRIANGLES or GL_LINES */
+        unsigned first;     /*!< the first of its indices in the batch */
+        unsigned count;     /*!< number of indices in the batch from first */
+    };
+
+    /*!
+     * @brief Bitmap text, drawn on top of the batched geometry
+     */
+    struct Label
+    {
+        float x;            /*!< the x location of the text */
+        float y;            /*!< the y location of the text */
+        float color[3];     /*!< the color of the text */
+        const char *text;   /*!< the text, it must outlive the render list */
+    };
+
+    vector<Vertex> vertices;    /*!< the vertices of every primitive */
+    vector<GLuint> triangles;   /*!< every filled primitive, as triangle indices */
+    vector<GLuint> lines;       /*!< every outline, as line segment indices */
+    vector<Span> spans;         /*!< the vertices of each primitive, in drawing order */
+    vector<Label> labels;       /*!< the text of the frame */
+    GLenum mode;                /*!< the OpenGL primitive being recorded */
+    GLuint base;                /*!< the first vertex of the primitive being recorded */
+    GLubyte current[4];         /*!< the color used by the next primitive */
+    unsigned layer;             /*!< the number of primitives recorded so far */
+
+    mutable GLuint buffers[3];  /*!< vertex, triangle index and line index buffers, 0 until first drawn */
+    mutable bool uploaded;      /*!< true once the buffers hold this frame */
+
+public:
+    RenderList();
+    ~RenderList();                              // deletes the vertex buffers, on the context thread
+    RenderList(const RenderList &other) = delete;
+    RenderList &operator=(const RenderList &other);    // copies the recorded drawing, not the buffers
+    void clear();                               // removes all recorded drawing, keeps the memory
+    void color(const float col[]);              // sets the color of the following primitives
+    void begin(GLenum mode);                    // starts a primitive, like glBegin
+    void vertex(float x, float y);              // adds a vertex to the primitive, like glVertex2f
+    void points(const vector<float> &xy, float x, float y);    // adds x/y pairs moved by x, y
+    void end();                                 // ends the primitive and batches it, like glEnd
+    void text(float x, float y, const char *str);   // draws bitmap text at a location
+    void submit(bool overlay = false) const;    // draws the frame from vertex buffers
+    void submitImmediate() const;               // draws the frame one glBegin/glEnd per primitive
+    void drawLabels() const;                    // draws the recorded text with OpenGL
+    void rasterize(Framebuffer &target) const;  // draws the frame in software, without its text
+    void rasterize(unsigned primitive, Framebuffer &target) const;  // draws one primitive in software
+    Box bounds(unsigned primitive) const;       // returns the pixels a primitive may cover
+    void scale(float factor);                   // scales the recorded drawing about the origin
+    unsigned primitives() const;                // returns the number of primitives recorded
+};
+
+#endif
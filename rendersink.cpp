@@ -0,0 +1,102 @@
+/** ***************************************************************************
+* @file
+* @brief Cpp file including functions for the rendersink.h, holds the
+* functions of the counting sink
+******************************************************************************/
+
+#include "rendersink.h"
+
+/** **************************************************************************
+ * @brief Ignores the color, the counts do not depend on it
+ *
+ * @param[in] col - the color to draw with
+ ******************************************************************************/
+void CountingSink::color(const float col[])
+{
+}
+
+/** **************************************************************************
+ * @brief Ignores the start of a primitive, it is counted when it ends
+ *
+ * @param[in] mode - the OpenGL primitive
+ ******************************************************************************/
+void CountingSink::begin(GLenum mode)
+{
+}
+
+/** **************************************************************************
+ * @brief Counts a vertex
+ *
+ * @param[in] x - the x location of the vertex
+ * @param[in] y - the y location of the vertex
+ ******************************************************************************/
+void CountingSink::vertex(float x, float y)
+{
+   vertexCount++;
+}
+
+/** **************************************************************************
+ * @brief Counts a run of vertices
+ *
+ * @param[in] xy - x/y pairs relative to the offset
+ * @param[in] x - the x offset
+ * @param[in] y - the y offset
+ ******************************************************************************/
+void CountingSink::points(const vector<float> &xy, float x, float y)
+{
+   vertexCount += xy.size() / 2;
+}
+
+/** **************************************************************************
+ * @brief Counts a primitive
+ ******************************************************************************/
+void CountingSink::end()
+{
+   primitiveCount++;
+}
+
+/** **************************************************************************
+ * @brief Counts a text label
+ *
+ * @param[in] x - the x location of the text
+ * @param[in] y - the y location of the text
+ * @param[in] str - the text
+ ******************************************************************************/
+void CountingSink::text(float x, float y, const char *str)
+{
+   textCount++;
+}
+
+/** **************************************************************************
+ * @brief Sets every count back to 0
+ ******************************************************************************/
+void CountingSink::clear()
+{
+   primitiveCount = 0;
+   vertexCount = 0;
+   textCount = 0;
+}
+
+/** **************************************************************************
+ * @brief Returns the number of primitives drawn since the last clear
+ ******************************************************************************/
+unsigned long CountingSink::primitives() const
+{
+   return primitiveCount;
+}
+
+/** **************************************************************************
+ * @brief Returns the number of vertices drawn since the last clear
+ ******************************************************************************/
+unsigned long CountingSink::vertices() const
+{
+   return vertexCount;
+}
+
+/** **************************************************************************
+ * @brief Returns the number of text labels drawn since the last clear
+ ******************************************************************************/
+unsigned long CountingSink::labels() const
+{
+   return textCount;
+}
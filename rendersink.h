@@ -0,0 +1,57 @@
+/** ***************************************************************************
+* @file
+* @brief Header file that holds the RenderSink class, what the shapes and the
+* toolbox draw into, and the CountingSink class, a sink that only counts
+******************************************************************************/
+
+#ifndef __RENDERSINK_H
+#define __RENDERSINK_H
+
+#include "graphics.h"
+
+/*!
+ * @brief RenderSink class, takes drawing in the style of immediate mode OpenGL
+ * without calling OpenGL
+ *
+ * The shapes and the toolbox only ever draw into a sink, so how the drawing
+ * is stored and put on screen is up to the sink and the backend that draws
+ * it, i.e. a RenderList records it for the RenderBackend chosen at startup.
+ */
+class RenderSink
+{
+public:
+    virtual ~RenderSink() {}
+    virtual void color(const float col[]) = 0;      // sets the color of the following primitives
+    virtual void begin(GLenum mode) = 0;            // starts a primitive, like glBegin
+    virtual void vertex(float x, float y) = 0;      // adds a vertex to the primitive, like glVertex2f
+    virtual void points(const vector<float> &xy, float x, float y) = 0;    // adds x/y pairs moved by x, y
+    virtual void end() = 0;                         // ends the primitive, like glEnd
+    virtual void text(float x, float y, const char *str) = 0;  // draws bitmap text at a location
+};
+
+/*!
+ * @brief CountingSink class, the null sink, keeps nothing of the drawing but
+ * how much there was
+ *
+ * Drawing into it costs what the shapes spend working out their geometry and
+ * nothing else, which is what a benchmark compares the backends against.
+ */
+class CountingSink : public RenderSink
+{
+    unsigned long primitiveCount = 0;   /*!< primitives ended */
+    unsigned long vertexCount = 0;      /*!< vertices added */
+    unsigned long textCount = 0;        /*!< text labels drawn */
+public:
+    void color(const float col[]);
+    void begin(GLenum mode);
+    void vertex(float x, float y);
+    void points(const vector<float> &xy, float x, float y);
+    void end();
+    void text(float x, float y, const char *str);
+    void clear();                       // sets the counts back to 0
+    unsigned long primitives() const;   // returns the number of primitives drawn
+    unsigned long vertices() const;     // returns the number of vertices drawn
+    unsigned long labels() const;       // returns the number of text labels drawn
+};
+
+#endif
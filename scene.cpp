@@ -0,0 +1,365 @@
+/** ***************************************************************************
+* @file
+* @brief Cpp file including functions for the scene.h, holds the scene thread
+*
+* The glut callbacks push Event values into a lock-free SpscRing. The scene
+* thread pops them and runs them through utilityCentral, so it is the
+* only thread that touches the shapes and the selections. Each action records
+* its frame into a RenderList, and finished frames are handed back to the
+* glut thread through a lock-free triple buffer, so neither thread ever waits
+* on the other while drawing.
+*
+* A frame only holds the damaged part of the canvas. The glut thread may skip
+* frames, so each frame also covers the damage of every frame since the last
+* one the glut thread reported as drawn.
+******************************************************************************/
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include "scene.h"
+#include "spsc.h"
+#include "triplebuffer.h"
+#include "util.h"
+#include "stats.h"
+
+using std::chrono::steady_clock;
+
+static SpscRing<Event, 4096> queue;        // events waiting for the scene thread
+static std::thread worker;                 // the scene thread
+static std::atomic<bool> running(false);   // cleared to stop the scene thread
+static std::atomic<bool> sleeping(false);  // set while the scene thread waits for events
+static std::mutex wakeLock;                // only used to put the scene thread to sleep
+static std::condition_variable wake;       // signalled when events arrive while sleeping
+
+/*!
+ * @brief Frame struct, one frame as handed from the scene thread to the glut thread
+ *
+ * Each frame carries the static layer it was recorded against, so the glut
+ * thread never pairs a frame with the wrong layer. The layer is only copied
+ * into a frame when the frame's copy is out of date.
+ */
+struct Frame
+{
+    RenderList shapes;          /*!< the shapes drawn over the static layer */
+    RenderList layer;           /*!< the static layer this frame was recorded against */
+    unsigned version = 0;       /*!< which static layer the layer copy is */
+    Box damage;                 /*!< the area the frame redraws, the rest of the window is kept */
+    unsigned sequence = 0;      /*!< the count of frames published up to this one */
+};
+
+/*!
+ * @brief Toolbox struct, the toolbox as handed from the scene thread to the glut thread
+ */
+struct Toolbox
+{
+    RenderList list;            /*!< the toolbox drawing */
+    Box area;                   /*!< the pixels the toolbox covers */
+};
+
+const unsigned DAMAGE_HISTORY = 8;  /*!< frames of damage kept for frames the glut thread skipped */
+
+static TripleBuffer<Frame> frames;         // the shapes, recorded by the scene thread each frame
+static TripleBuffer<Toolbox> toolboxes;    // the toolbox, recorded only when its layout changes
+static RenderList layer;                   // the newest static layer, owned by the scene thread
+static unsigned layerVersion = 0;          // bumped whenever a static layer is published
+static std::atomic<BackendId> backend(VBO_BACKEND);   // how frames are drawn, chosen at startup
+static Box history[DAMAGE_HISTORY];        // the damage of the latest frames, by sequence
+static unsigned published = 0;             // frames published, owned by the scene thread
+static std::atomic<unsigned> presented(0); // sequence of the frame last drawn by the glut thread
+
+static std::atomic<const char *> title(nullptr);   // window title waiting to be applied
+static std::atomic<int> frameRate(60);             // the most frames rendered per second
+
+/** **************************************************************************
+ * @brief The scene thread, runs queued events until asked to stop
+ *
+ * Every queued event is dispatched before a frame is rendered, so a burst of
+ * input costs one redraw. If the document is damaged before the next frame is
+ * due the thread sleeps until then, or until more events arrive. It only
+ * sleeps once the shapes of dropped clears are freed and the shapes of an
+ * opened file are in the grid, a batch of each per pass.
+ *
+ * When the queue is empty the thread announces that it is sleeping before
+ * checking the queue one last time, so a producer that sees the announcement
+ * is guaranteed to wake it and a producer that does not see it is guaranteed
+ * to have its event noticed by that last check.
+ ******************************************************************************/
+static void sceneLoop()
+{
+   Event event;
+   steady_clock::time_point nextFrame = steady_clock::now();
+   while (true)
+   {
+      while (queue.pop(event))
+         utilityCentral(event);
+
+      bool damaged = sceneDamaged();
+      steady_clock::time_point now = steady_clock::now();
+      if (damaged && now >= nextFrame)
+      {
+         renderDamage();
+         nextFrame = now + std::chrono::microseconds(1000000 / frameRate.load());
+         damaged = false;
+      }
+
+      if (queue.empty() && idleScene())
+         continue;   // dropped clears are freed and opened shapes bucketed a batch at a time between events
+
+      std::unique_lock<std::mutex> lock(wakeLock);
+      sleeping.store(true);
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      if (queue.empty() && running.load())
+      {
+         if (damaged)   // a frame is owed, sleep no later than when it is due
+            wake.wait_until(lock, nextFrame, [] { return !queue.empty() || !running.load(); });
+         else
+            wake.wait(lock, [] { return !queue.empty() || !running.load(); });
+      }
+      sleeping.store(false);
+
+      if (queue.empty() && !running.load())
+         return;
+   }
+}
+
+/** **************************************************************************
+ * @brief Wakes the scene thread if it is waiting for events
+ ******************************************************************************/
+static void wakeScene()
+{
+   std::atomic_thread_fence(std::memory_order_seq_cst);
+   if (sleeping.load())
+   {
+      std::lock_guard<std::mutex> lock(wakeLock);
+      wake.notify_one();
+   }
+}
+
+/** **************************************************************************
+ * @brief Starts the scene thread
+ ******************************************************************************/
+void startScene()
+{
+   if (running.exchange(true))
+      return;
+   worker = std::thread(sceneLoop);
+}
+
+/** **************************************************************************
+ * @brief Stops the scene thread once every queued event has been run
+ ******************************************************************************/
+void stopScene()
+{
+   if (!running.exchange(false))
+      return;
+   {
+      std::lock_guard<std::mutex> lock(wakeLock);
+      wake.notify_one();
+   }
+   worker.join();
+}
+
+/** **************************************************************************
+ * @brief Queues an event for the scene thread
+ *
+ * The event value is copied straight into the ring. If the ring is full the
+ * glut thread yields until the scene thread catches up, events are never
+ * dropped.
+ *
+ * @param[in] event - the event to run on the scene thread
+ ******************************************************************************/
+void postEvent(const Event &event)
+{
+   while (!queue.push(event))
+   {
+      wakeScene();
+      std::this_thread::yield();
+   }
+   wakeScene();
+}
+
+/** **************************************************************************
+ * @brief Returns an empty frame for the scene thread to record into
+ *
+ * The damaged area is widened by the damage of the frames the glut thread
+ * may not have drawn, a frame that is replaced before it is drawn is never
+ * drawn. If too many frames went undrawn the whole window is redrawn.
+ *
+ * @param[in,out] area - the area changed since the last frame, widened to
+ *                       the area this frame must redraw
+ ******************************************************************************/
+RenderList &beginFrame(Box &area)
+{
+   Frame &frame = frames.back();
+   frame.shapes.clear();
+   if (frame.version != layerVersion)
+   {
+      frame.layer = layer;
+      frame.version = layerVersion;
+   }
+
+   unsigned sequence = published + 1;
+   unsigned drawn = presented.load(std::memory_order_acquire);
+   history[sequence % DAMAGE_HISTORY] = area;
+   if (sequence - drawn > DAMAGE_HISTORY)
+      area = Box::whole();
+   for (unsigned s = drawn + 1; s != sequence && !area.isWhole(); s++)
+      area.add(history[s % DAMAGE_HISTORY]);
+   frame.damage = area;
+   frame.sequence = sequence;
+   return frame.shapes;
+}
+
+/** **************************************************************************
+ * @brief Publishes the recorded frame and takes back the oldest one
+ *
+ * A published frame is never touched again by the scene thread until the
+ * glut thread has moved on to a newer one
+ ******************************************************************************/
+void publishFrame()
+{
+   frames.publish();
+   published++;
+}
+
+/** **************************************************************************
+ * @brief Returns an empty static layer for the scene thread to record into
+ ******************************************************************************/
+RenderList &beginLayer()
+{
+   layer.clear();
+   return layer;
+}
+
+/** **************************************************************************
+ * @brief Makes the recorded static layer the one every following frame is drawn over
+ *
+ * Must be called before the first frame that depends on it is begun
+ ******************************************************************************/
+void publishLayer()
+{
+   layerVersion++;
+}
+
+/** **************************************************************************
+ * @brief Returns an empty toolbox for the scene thread to record into
+ ******************************************************************************/
+RenderList &beginToolbox()
+{
+   toolboxes.back().list.clear();
+   return toolboxes.back().list;
+}
+
+/** **************************************************************************
+ * @brief Publishes the recorded toolbox, it is drawn over every frame after it
+ *
+ * @param[in] area - the pixels the toolbox covers, it is only drawn again
+ *                   when a frame damages them
+ ******************************************************************************/
+void publishToolbox(const Box &area)
+{
+   toolboxes.back().area = area;
+   toolboxes.publish();
+}
+
+/** **************************************************************************
+ * @brief Draws the damaged area of the newest published frame, toolbox on top
+ *
+ * Only the damaged area is drawn, the rest of the window keeps what the
+ * earlier frames drew. The toolbox is only drawn when the damage reaches it.
+ * How the area is drawn is up to the backend chosen at startup.
+ *
+ * @returns true if a new frame was drawn
+ ******************************************************************************/
+bool presentFrame()
+{
+   bool fresh = frames.take();
+   fresh = toolboxes.take() || fresh;
+   if (!fresh)
+      return false;
+
+   const Frame &frame = frames.front();
+   GLint viewport[4] = {0, 0, 0, 0};
+   glGetIntegerv(GL_VIEWPORT, viewport);
+   Box area = frame.damage;   // clipped to the window
+   if (area.left < 0) area.left = 0;
+   if (area.bottom < 0) area.bottom = 0;
+   if (area.right >= viewport[2]) area.right = viewport[2] - 1;
+   if (area.top >= viewport[3]) area.top = viewport[3] - 1;
+
+   if (!area.empty())
+   {
+      const Toolbox &toolbox = toolboxes.front();
+      backendFor(backend.load()).present(frame.layer, frame.version, frame.shapes,
+                                         area.intersects(toolbox.area) ? &toolbox.list : nullptr, area);
+      stats().pixelsPresented.fetch_add((unsigned long)(area.right - area.left + 1) *
+                                        (unsigned long)(area.top - area.bottom + 1),
+                                        std::memory_order_relaxed);
+   }
+   presented.store(frame.sequence, std::memory_order_release);
+   stats().framesPresented.fetch_add(1, std::memory_order_relaxed);
+   return true;
+}
+
+/** **************************************************************************
+ * @brief Returns true if a frame or toolbox was published that has not been drawn yet
+ ******************************************************************************/
+bool frameReady()
+{
+   return frames.fresh() || toolboxes.fresh();
+}
+
+/** **************************************************************************
+ * @brief Chooses how the frames are drawn
+ *
+ * Meant to be called before the window opens
+ *
+ * @param[in] id - the backend
+ ******************************************************************************/
+void setBackend(BackendId id)
+{
+   backend.store(id);
+}
+
+/** **************************************************************************
+ * @brief Sets the most frames the scene thread renders per second
+ *
+ * @param[in] fps - the frame rate cap, clamped to 1 through 1000
+ ******************************************************************************/
+void setFrameRate(int fps)
+{
+   frameRate.store(fps < 1 ? 1 : fps > 1000 ? 1000 : fps);
+}
+
+/** **************************************************************************
+ * @brief Returns the time between frames at the current frame rate cap
+ *
+ * @returns the frame interval in whole milliseconds, at least 1
+ ******************************************************************************/
+int frameInterval()
+{
+   int ms = 1000 / frameRate.load();
+   return ms < 1 ? 1 : ms;
+}
+
+/** **************************************************************************
+ * @brief Asks the glut thread to change the window title
+ *
+ * @param[in] text - the new title, it must be a string literal
+ ******************************************************************************/
+void setWindowTitle(const char *text)
+{
+   title.store(text);
+}
+
+/** **************************************************************************
+ * @brief Applies the most recently requested window title, if any
+ ******************************************************************************/
+void updateWindowTitle()
+{
+   const char *text = title.exchange(nullptr);
+   if (text != nullptr && windowOpen())
+      glutSetWindowTitle(text);
+}
@@ -0,0 +1,35 @@
+/** ***************************************************************************
+* @file
+* @brief Header file that holds the scene thread, which runs every event away
+* from the glut thread and hands finished frames back to it
+******************************************************************************/
+
+#ifndef __SCENE_H
+#define __SCENE_H
+
+#include "event.h"
+#include "renderlist.h"
+#include "box.h"
+#include "backend.h"
+
+void startScene();                      // starts the scene thread
+void stopScene();                       // runs the queued events and stops the scene thread
+void postEvent(const Event &event);     // queues an event for the scene thread, glut thread only
+
+RenderList &beginFrame(Box &area);      // returns an empty frame redrawing at least area, scene thread only
+void publishFrame();                    // hands the recorded frame to the glut thread, scene thread only
+RenderList &beginLayer();               // returns an empty static layer to record into, scene thread only
+void publishLayer();                    // makes the recorded layer the one frames are drawn over, scene thread only
+RenderList &beginToolbox();             // returns an empty toolbox to record into, scene thread only
+void publishToolbox(const Box &area);   // hands the recorded toolbox covering area to the glut thread, scene thread only
+bool presentFrame();                    // draws the damaged area of the newest frame, glut thread only
+bool frameReady();                      // true if a frame or toolbox is waiting to be drawn
+
+void setFrameRate(int fps);             // caps how many frames are rendered per second
+void setBackend(BackendId id);          // chooses how frames are drawn, before the window opens
+int frameInterval();                    // milliseconds between frames at the current cap
+
+void setWindowTitle(const char *title); // asks the glut thread to change the window title
+void updateWindowTitle();               // applies the requested window title, glut thread only
+
+#endif
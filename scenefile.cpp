@@ -0,0 +1,412 @@
+/** ***************************************************************************
+* @file
+* @brief Cpp file including functions for the scenefile.h, holds the functions
+* which save the shapes of a drawing to a scene file and open one
+*
+* A scene file is a SceneHeader followed by one SceneRecord per shape, back to
+* front, in the byte order of the machine that wrote it. Opening maps the
+* file into memory and builds each shape straight from its record in the
+* mapping, nothing is parsed or copied into a buffer first.
+******************************************************************************/
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "scenefile.h"
+#include "document.h"
+
+static_assert(sizeof(SceneHeader) % alignof(SceneRecord) == 0, "records must start aligned after the header");
+static_assert(sizeof(SceneRecord) == 40, "scene records must stay the same size on every compiler");
+
+static std::string path = "drawing.pscn";     // the file the drawing is saved to
+
+const size_t SCENE_CHUNK = 4096;    /*!< records written with one call */
+const float SCENE_LIMIT = 1e9f;     /*!< largest location or extent a record may hold */
+
+/*!
+ * @brief SceneMapping class, a scene file mapped read only, its header
+ * checked before any record is looked at
+ */
+class SceneMapping
+{
+    void *base = MAP_FAILED;    /*!< the mapping */
+    size_t size = 0;            /*!< its length in bytes */
+public:
+    const SceneHeader *header = nullptr;    /*!< the header, nullptr if the file is not a scene file */
+    const SceneRecord *records = nullptr;   /*!< the first record, header->count follow it */
+
+    explicit SceneMapping(const char *path);
+    ~SceneMapping();
+};
+
+/** **************************************************************************
+ * @brief Constructor, maps a file and checks its header
+ *
+ * @param[in] path - the file, the mapping is left without a header if it can
+ *                   not be read or is not a version SCENE_VERSION scene file
+ ******************************************************************************/
+SceneMapping::SceneMapping(const char *path)
+{
+   int fd = open(path, O_RDONLY);
+   if (fd < 0)
+      return;
+   struct stat info;
+   if (fstat(fd, &info) != 0 || size_t(info.st_size) < sizeof(SceneHeader))
+   {
+      close(fd);
+      return;
+   }
+   size = size_t(info.st_size);
+   base = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+   close(fd);   // the mapping keeps the file open
+   if (base == MAP_FAILED)
+      return;
+   madvise(base, size, MADV_SEQUENTIAL);
+
+   const SceneHeader *head = static_cast<const SceneHeader *>(base);
+   if (memcmp(head->magic, "PSCN", 4) == 0 && head->version == SCENE_VERSION &&
+       head->headerSize == sizeof(SceneHeader) && head->recordSize == sizeof(SceneRecord) &&
+       head->records >= sizeof(SceneHeader) && head->records % alignof(SceneRecord) == 0 &&
+       head->records <= size && head->count <= (size - head->records) / sizeof(SceneRecord))
+   {
+      header = head;
+      records = reinterpret_cast<const SceneRecord *>(static_cast<const char *>(base) + head->records);
+   }
+}
+
+/** **************************************************************************
+ * @brief Destructor, unmaps the file
+ ******************************************************************************/
+SceneMapping::~SceneMapping()
+{
+   if (base != MAP_FAILED)
+      munmap(base, size);
+}
+
+/** **************************************************************************
+ * @brief Unpacks an RGBA color into the floats the shapes are made with
+ *
+ * @param[in] packed - the color, red in the low byte
+ * @param[out] col - the red, green and blue, 0 to 1
+ ******************************************************************************/
+static void unpackColor(uint32_t packed, float col[3])
+{
+   for (int i = 0; i < 3; i++)
+      col[i] = float((packed >> (8 * i)) & 0xff) / 255.0f;
+}
+
+/** **************************************************************************
+ * @brief Returns true if a record can be made into a shape
+ *
+ * @param[in] record - the shape as the file holds it
+ ******************************************************************************/
+bool validRecord(const ShapeRecord &record)
+{
+   return record.type <= FILLED_ELLIPSE_TYPE &&
+          std::fabs(record.x) < SCENE_LIMIT && std::fabs(record.y) < SCENE_LIMIT &&
+          std::fabs(record.a) < SCENE_LIMIT && std::fabs(record.b) < SCENE_LIMIT;
+}
+
+/** **************************************************************************
+ * @brief Returns the pixels a record covers, as its shape would report them
+ *
+ * @param[in] record - the shape as plain numbers
+ ******************************************************************************/
+static Box recordBounds(const ShapeRecord &record)
+{
+   int x = int(record.x), y = int(record.y), a = int(record.a), b = int(record.b);
+   switch (kindOf(record.type))
+   {
+      case LINE_KIND: return Box(x, y, x + a, y + b);
+      case BOX_KIND:  return Box(x - 1, y, x + a, y + b);
+      default:        return Box(x - a, y - b, x + a, y + b);
+   }
+}
+
+/** **************************************************************************
+ * @brief Makes the shape a record describes in an arena
+ *
+ * @param[in,out] arena - the arena the shape is made in
+ * @param[in] record - the shape as plain numbers, already checked
+ ******************************************************************************/
+static Shape *makeShape(ShapeArena &arena, const ShapeRecord &record)
+{
+   float border[3], fill[3];
+   unpackColor(record.border, border);
+   unpackColor(record.fill, fill);
+   int x = int(record.x), y = int(record.y), a = int(record.a), b = int(record.b);
+   switch (record.type)
+   {
+      case LINE_TYPE:             return arena.make<Line>(x, y, b, a, border);
+      case RECTANGLE_TYPE:        return arena.make<Rectangle>(x, y, b, a, border);
+      case FILLED_RECTANGLE_TYPE: return arena.make<FilledRectangle>(x, y, b, a, border, fill);
+      case CIRCLE_TYPE:           return arena.make<Circle>(x, y, a, border);
+      case FILLED_CIRCLE_TYPE:    return arena.make<FilledCircle>(x, y, a, border, fill);
+      case ELLIPSE_TYPE:          return arena.make<Ellipse>(x, y, a, b, border);
+      case FILLED_ELLIPSE_TYPE:   return arena.make<FilledEllipse>(x, y, a, b, border, fill);
+   }
+   return nullptr;
+}
+
+/** **************************************************************************
+ * @brief Makes a shape from its record and adds it to the store and the
+ * records of a set of indexes, and lists it for the drawing order, which is
+ * built once every shape is made
+ *
+ * @param[in,out] parts - the indexes
+ * @param[in,out] order - the shapes made so far with their depths, back to front
+ * @param[in,out] doc - the document whose arena makes the shape
+ * @param[in] record - the shape as plain numbers, already checked
+ * @param[in] depth - its depth in the drawing order, past every listed one
+ ******************************************************************************/
+static void addShape(SceneParts &parts, std::vector<std::pair<long long, Shape *>> &order, Document &doc,
+                     const ShapeRecord &record, long long depth)
+{
+   Shape *shape = makeShape(doc.arena, record);
+   parts.store.add(shape);
+   parts.records.put(shape->getHandle(), shape->toRecord(), depth);
+   order.emplace_back(depth, shape);
+}
+
+/** **************************************************************************
+ * @brief Writes a scene file from shapes handed over back to front
+ *
+ * The file is written beside the target, flushed to disk and renamed over
+ * it once complete, so a failed save or a crash never leaves a half written
+ * drawing behind. The header is written again at the end, once the counts
+ * and bounds are known.
+ *
+ * @param[in] path - the file to write
+ * @param[in] count - the number of shapes
+ * @param[in] generation - the autosave generation, 0 if saved by hand
+ * @param[in] each - called with a function taking a record and its depth,
+ *                   which it calls for every shape back to front
+ *
+ * @returns true if the whole file was written
+ ******************************************************************************/
+template <typename Each>
+static bool writeScene(const char *path, size_t count, uint32_t generation, Each each)
+{
+   std::string temp = std::string(path) + ".tmp";
+   FILE *file = fopen(temp.c_str(), "wb");
+   if (file == nullptr)
+      return false;
+
+   SceneHeader header;
+   memset(&header, 0, sizeof(header));
+   memcpy(header.magic, "PSCN", 4);
+   header.version = SCENE_VERSION;
+   header.headerSize = sizeof(SceneHeader);
+   header.recordSize = sizeof(SceneRecord);
+   header.generation = generation;
+   header.count = count;
+   header.records = sizeof(SceneHeader);
+   bool ok = fwrite(&header, sizeof(header), 1, file) == 1;
+
+   Box bounds;
+   std::vector<SceneRecord> chunk;
+   chunk.reserve(SCENE_CHUNK);
+   each([&](const ShapeRecord &shape, long long depth)
+   {
+      SceneRecord record;
+      memset(&record, 0, sizeof(record));   // no stray padding bytes in the file
+      record.shape = shape;
+      record.depth = depth;
+      header.kinds[kindOf(shape.type)]++;
+      bounds.add(recordBounds(shape));
+      chunk.push_back(record);
+      if (chunk.size() == SCENE_CHUNK)
+      {
+         ok = ok && fwrite(chunk.data(), sizeof(SceneRecord), chunk.size(), file) == chunk.size();
+         chunk.clear();
+      }
+   });
+   if (ok && !chunk.empty())
+      ok = fwrite(chunk.data(), sizeof(SceneRecord), chunk.size(), file) == chunk.size();
+
+   if (!bounds.empty())
+   {
+      header.bounds[0] = bounds.left;
+      header.bounds[1] = bounds.bottom;
+      header.bounds[2] = bounds.right;
+      header.bounds[3] = bounds.top;
+   }
+   ok = ok && fseek(file, 0, SEEK_SET) == 0 && fwrite(&header, sizeof(header), 1, file) == 1;
+   ok = ok && fflush(file) == 0 && fsync(fileno(file)) == 0;
+   ok = fclose(file) == 0 && ok;
+   if (ok)
+      ok = rename(temp.c_str(), path) == 0;
+   if (!ok)
+      remove(temp.c_str());
+   return ok;
+}
+
+/** **************************************************************************
+ * @brief Writes the shapes of a document to a scene file
+ *
+ * @param[in] path - the file to write
+ * @param[in] doc - the document, only read
+ *
+ * @returns true if the whole file was written
+ ******************************************************************************/
+bool saveScene(const char *path, Document &doc)
+{
+   return writeScene(path, doc.shapes.size(), 0, [&](auto emit)
+   {
+      for (ZOrder::const_iterator at = doc.shapes.begin(); at != doc.shapes.end(); ++at)
+         emit((*at)->toRecord(), at.depth());
+   });
+}
+
+/** **************************************************************************
+ * @brief Writes a snapshot of the shapes to a scene file
+ *
+ * Only reads the snapshot, so it can run on any thread while the document
+ * goes on changing
+ *
+ * @param[in] path - the file to write
+ * @param[in] scene - the snapshot
+ * @param[in] generation - the autosave generation, 0 if saved by hand
+ *
+ * @returns true if the whole file was written
+ ******************************************************************************/
+bool saveScene(const char *path, const SceneSnapshot &scene, uint32_t generation)
+{
+   std::vector<SnapshotEntry> entries;
+   scene.ordered(entries);
+   return writeScene(path, entries.size(), generation, [&](auto emit)
+   {
+      for (const SnapshotEntry &entry : entries)
+         emit(entry.record, entry.depth);
+   });
+}
+
+/** **************************************************************************
+ * @brief Reads a scene file into a new set of indexes, the shapes are made in
+ * the arena of the document
+ *
+ * The file is mapped read only and its records are read where they lie, one
+ * pass from front to back, each shape made in an arena slot and added to the
+ * indexes at its saved depth. The drawing order is built last, in one pass
+ * over the sorted depths, and the grid only lists the shapes, the scene
+ * thread buckets them between events. The header is checked
+ * before anything is made, and every record before its shape is made, a file
+ * that fails either is rejected as a whole.
+ *
+ * @param[in] path - the file to read
+ * @param[in,out] doc - the document whose arena makes the shapes
+ *
+ * @returns the indexes holding the shapes, nullptr if the file could not be
+ *          read or is not a version SCENE_VERSION scene file
+ ******************************************************************************/
+std::unique_ptr<SceneParts> openScene(const char *path, Document &doc)
+{
+   SceneMapping file(path);
+   if (file.header == nullptr)
+      return nullptr;
+
+   const SceneHeader &header = *file.header;
+   std::unique_ptr<SceneParts> parts(new SceneParts);
+   size_t kinds[SHAPE_KINDS];
+   for (int k = 0; k < SHAPE_KINDS; k++)
+      kinds[k] = size_t(std::min<uint64_t>(header.kinds[k], header.count));
+   parts->store.reserve(kinds);
+   std::vector<std::pair<long long, Shape *>> order;
+   order.reserve(size_t(header.count));
+
+   for (uint64_t i = 0; i < header.count; i++)
+   {
+      const SceneRecord &record = file.records[i];
+      if (!validRecord(record.shape) || (i != 0 && record.depth <= file.records[i - 1].depth))
+      {
+         for (const auto &shape : order)
+            doc.arena.release(shape.second);
+         return nullptr;
+      }
+      addShape(*parts, order, doc, record.shape, record.depth);
+   }
+   parts->shapes.assign(order);
+   parts->grid.insert(parts->shapes);   // only listed, bucketed as the scene thread has time
+   return parts;
+}
+
+/** **************************************************************************
+ * @brief Reads the records of a scene file, checked the same way as opening it
+ *
+ * @param[in] path - the file to read
+ * @param[out] shapes - the records by depth
+ * @param[out] generation - the autosave generation of the file
+ *
+ * @returns false if the file could not be read or is not a valid scene file,
+ *          the shapes are then left empty
+ ******************************************************************************/
+bool readScene(const char *path, SceneShapes &shapes, uint32_t &generation)
+{
+   shapes.clear();
+   SceneMapping file(path);
+   if (file.header == nullptr)
+      return false;
+
+   for (uint64_t i = 0; i < file.header->count; i++)
+   {
+      const SceneRecord &record = file.records[i];
+      if (!validRecord(record.shape) || (i != 0 && record.depth <= file.records[i - 1].depth))
+      {
+         shapes.clear();
+         return false;
+      }
+      shapes.emplace_hint(shapes.end(), record.depth, record.shape);
+   }
+   generation = file.header->generation;
+   return true;
+}
+
+/** **************************************************************************
+ * @brief Makes records into shapes in a new set of indexes
+ *
+ * @param[in] shapes - the records by depth, each one checked
+ * @param[in,out] doc - the document whose arena makes the shapes
+ *
+ * @returns the indexes holding the shapes
+ ******************************************************************************/
+std::unique_ptr<SceneParts> buildScene(const SceneShapes &shapes, Document &doc)
+{
+   std::unique_ptr<SceneParts> parts(new SceneParts);
+   size_t kinds[SHAPE_KINDS] = {};
+   for (const auto &shape : shapes)
+      kinds[kindOf(shape.second.type)]++;
+   parts->store.reserve(kinds);
+   std::vector<std::pair<long long, Shape *>> order;
+   order.reserve(shapes.size());
+   for (const auto &shape : shapes)
+      addShape(*parts, order, doc, shape.second, shape.first);
+   parts->shapes.assign(order);
+   parts->grid.insert(parts->shapes);
+   return parts;
+}
+
+/** **************************************************************************
+ * @brief Sets the file the drawing is saved to and opened from
+ *
+ * @param[in] file - the path of the scene file
+ ******************************************************************************/
+void setScenePath(const char *file)
+{
+   path = file;
+}
+
+/** **************************************************************************
+ * @brief Returns the file the drawing is saved to and opened from,
+ * drawing.pscn unless another was set
+ ******************************************************************************/
+const char *scenePath()
+{
+   return path.c_str();
+}
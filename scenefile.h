@@ -0,0 +1,66 @@
+/** ***************************************************************************
+* @file
+* @brief Header file that holds the scene file format, the shapes of a drawing
+* saved as fixed size records, and the functions that save and open it
+******************************************************************************/
+
+#ifndef __SCENEFILE_H
+#define __SCENEFILE_H
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include "shape.h"
+#include "box.h"
+
+struct Document;
+struct SceneParts;
+class SceneSnapshot;
+
+const uint16_t SCENE_VERSION = 1;   /*!< the scene file format version */
+
+/*!
+ * @brief SceneHeader struct, written at the start of every scene file, the
+ * index of what follows it
+ *
+ * The counts of each kind let the shape store size its arrays once, and the
+ * bounds tell how large the drawing is without reading a record.
+ */
+struct SceneHeader
+{
+    char magic[4];                  /*!< always "PSCN" */
+    uint16_t version;               /*!< the scene file format version */
+    uint16_t headerSize;            /*!< sizeof(SceneHeader) when the file was written */
+    uint32_t recordSize;            /*!< sizeof(SceneRecord) when the file was written */
+    uint32_t generation;            /*!< the autosave generation of the file, 0 if saved by hand */
+    uint64_t count;                 /*!< the number of shape records */
+    uint64_t records;               /*!< the file offset of the first record */
+    uint64_t kinds[SHAPE_KINDS];    /*!< the number of shapes of each kind of outline */
+    int32_t bounds[4];              /*!< left, bottom, right and top pixel of every shape */
+};
+
+/*!
+ * @brief SceneRecord struct, one shape as the file holds it, in drawing order
+ */
+struct SceneRecord
+{
+    ShapeRecord shape;      /*!< the type, location, extents and packed colors */
+    uint32_t reserved;      /*!< 0, keeps the depth 8 byte aligned */
+    int64_t depth;          /*!< its depth in the drawing order, larger is in front */
+};
+
+/*!
+ * @brief The shapes of a scene as records, keyed by their depth
+ */
+typedef std::map<long long, ShapeRecord> SceneShapes;
+
+bool saveScene(const char *path, Document &doc);            // writes the shapes of a document to a file
+bool saveScene(const char *path, const SceneSnapshot &scene, uint32_t generation);  // writes a snapshot to a file
+std::unique_ptr<SceneParts> openScene(const char *path, Document &doc);  // reads a file into new indexes
+bool readScene(const char *path, SceneShapes &shapes, uint32_t &generation);    // reads a file as records
+std::unique_ptr<SceneParts> buildScene(const SceneShapes &shapes, Document &doc);   // makes records into new indexes
+bool validRecord(const ShapeRecord &record);                // returns true if a record can be made into a shape
+void setScenePath(const char *path);                        // sets the file the drawing is saved to
+const char *scenePath();                                    // returns the file the drawing is saved to
+
+#endif
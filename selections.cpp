@@ -24,7 +24,7 @@ Selections::Selections()
  *
  * @param[in] col - the border color that has been selected
  ******************************************************************************/
-void Selections::setBorderColor(float col[])
+void Selections::setBorderColor(const float col[])
 {
     for(int i = 0; i < 3; i++)
         borderColor[i] = col[i];
@@ -35,7 +35,7 @@ void Selections::setBorderColor(float col[])
  *
  * @param[in] col - the fill color that has been selected
  ******************************************************************************/
-void Selections::setFillColor(float col[])
+void Selections::setFillColor(const float col[])
 {
     for(int i = 0; i < 3; i++)
         fillColor[i] = col[i];
@@ -46,7 +46,7 @@ void Selections::setFillColor(float col[])
  *
  * @param[in] tool - the tool/shape that has been selected
  ******************************************************************************/
-void Selections::setTool(std::string tool)
+void Selections::setTool(ToolId tool)
 {
     selectedTool = tool;
 }
@@ -70,7 +70,7 @@ float* Selections::getFillColor()
 /** **************************************************************************
  * @brief Returns the selected border color on the toolbox
  ******************************************************************************/
-std::string Selections::getTool()
+ToolId Selections::getTool()
 {
     return selectedTool;
 }
@@ -186,36 +186,29 @@ void Selections::setLeftCLickStatus(bool set)
 
 
 /** **************************************************************************
- * @brief Brings the right-clicked shape to the front of the screen and selects it.
+ * @brief Selects the right-clicked shape, the one on top under the click.
  * 
  * It accommodates for an empty paint area.
  *
- * @param[in,out] shapes - vector of saved shapes that have been drawn in the paint area
+ * The grid finds the shapes under the click front to back, so the first one
+ * is the one on top. Bringing it to the front is left to the caller, so the
+ * change can be undone.
+ *
+ * @param[in,out] grid - the spatial index of the shapes, buckets any it only listed
+ * @param[in] store - the shape store, which tests the shapes near the click
  * @param[in] xLoc - x location of the mouse right click
  * @param[in] yLoc - y location of the mouse right click
+ *
+ * @returns the picked shape, nullptr if there is no shape under the click
  ******************************************************************************/
-void Selections::bringToFront(vector<Shape *> &shapes, int xLoc, int yLoc)
+Shape * Selections::pick(ShapeGrid &grid, const ShapeStore &store, int xLoc, int yLoc)
 {
-    int latest = -1;
-    for(int i = 0; i < int(shapes.size()); i++)
-    {
-        if(shapes[i]->contains(xLoc,yLoc))
-        {
-            latest = i;
-        }
-        if(shapes.size() == 0)
-        {
-            setSelectedShape(shapes[0]);
-        }
-    }
-    if(latest != -1)
-    {
-        shapes.push_back(shapes[latest]);
-        shapes[latest]->draw();
-        shapes.erase(shapes.begin() + latest);
-        setSelectedShape(shapes[latest]);
-        glFlush();
-    }
+    grid.query(xLoc, yLoc, store, picked);
+    if(picked.empty())
+        return nullptr;
+
+    setSelectedShape(picked[0]);
+    return picked[0];
 }
 
 /** **************************************************************************
@@ -225,32 +218,30 @@ void Selections::bringToFront(vector<Shape *> &shapes, int xLoc, int yLoc)
  ******************************************************************************/
 void Selections::setSelectedShape(Shape * select)
 {
-    selectedShape = select;
+    selectedShape = select->getRef();
 }
 
 /** **************************************************************************
  * @brief Returns the latest selected shape.
+ *
+ * The selection only keeps a reference, so a deleted or cleared shape is
+ * never returned.
+ *
+ * @param[in] arena - the shape arena that made the shape
+ *
+ * @returns the selected shape, nullptr if none is selected or it was deleted
  ******************************************************************************/
-Shape * Selections::getSelectedShape()
+Shape * Selections::getSelectedShape(const ShapeArena &arena)
 {
-    return selectedShape;
+    return arena.get(selectedShape);
 }
 
 /** **************************************************************************
- * @brief Moves the shape that has been both selected and dragged with the right mouse button.
- * 
- * It will redraw the shape after every mouse drag event based off where the shape
- * is being dragged.
+ * @brief Returns what the selected tool needs to size its shape.
  *
- * @param[in,out] shapes - vector of saved shapes that have been drawn in the paint area
- * @param[in] xLoc - x location of the mouse right click
- * @param[in] yLoc - y location of the mouse right click
+ * The colors are not copied, the tool reads the selected ones.
  ******************************************************************************/
-void Selections::moveShape(vector<Shape *> &shapes, int xLoc, int yLoc)
+ToolDrag Selections::getDrag()
 {
-    int distanceXStart = startX;
-    int distanceYStart = startY;
-
-    shapes.back()->setXLoc(xLoc - distanceXStart);
-    shapes.back()->setYLoc(yLoc - distanceYStart);
+    return ToolDrag{startX, startY, endX, endY, borderColor, fillColor};
 }
\ No newline at end of file
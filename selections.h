@@ -9,6 +9,10 @@
 #include <iostream>
 #include "graphics.h"
 #include "shape.h"
+#include "grid.h"
+#include "shapearena.h"
+#include "zorder.h"
+#include "tools.h"
 
 /*!
  * @brief Selections Class, holds/changes information about selection states of program
@@ -18,23 +22,24 @@ class Selections
 protected:
         float borderColor[3];   /*!< Selected border color from the toolbox */
         float fillColor[3];     /*!< Selected fill color from the toolbox */
-        std::string selectedTool;       /*!< Selected tool type from the toolbox */
+        ToolId selectedTool = NO_TOOL;  /*!< Selected tool type from the toolbox */
         int startX = 0;         /*!< Selected Starting x location */
         int startY = 0;         /*!< Selected Starting u location */
         int endX = 0;           /*!< Saved Ending x location */
         int endY = 0;           /*!< Saved Ending y location */
         bool dragOccurred = false;      /*!< describes whether a drag has occurred */
         bool leftClickOccurred = false; /*!< describes whether a left click has occurred */
-        Shape *selectedShape;           /*!< pointer to a shape class */
+        ShapeRef selectedShape;         /*!< the selected shape, resolved through the shape arena */
+        vector<Shape *> picked;         /*!< the shapes under the last picked point, kept to not allocate */
 public: 
         Selections();                           // constructor
         // ***Accessors & setters***
-        void setBorderColor(float col[]);       // sets selected border color
-        void setFillColor(float col[]);         // sets selected fill color
-        void setTool(std::string tool);         // sets selected tool
+        void setBorderColor(const float col[]); // sets selected border color
+        void setFillColor(const float col[]);   // sets selected fill color
+        void setTool(ToolId tool);              // sets selected tool
         float* getBorderColor();                // returns selected border color
         float* getFillColor();                  // returns selected fill color
-        std::string getTool();                  // returns selected tool
+        ToolId getTool();                       // returns selected tool
 
         int getStartX();                        // returns starting x location
         int getStartY();                        // returns starting y location
@@ -51,12 +56,13 @@ public:
         bool getLeftClickStatus();              // returns the mouse's left click status
         void setLeftCLickStatus(bool set);      // sets the mouse's left click status
 
-        Shape * getSelectedShape();             // returns the selected shape
+        Shape * getSelectedShape(const ShapeArena &arena);  // returns the selected shape, nullptr if it is gone
         void setSelectedShape(Shape * select);  // sets the selected shape
+        ToolDrag getDrag();                     // returns the drag locations and colors for the selected tool
         
         // ***Shape Manimpulators***
-        void bringToFront(vector<Shape *> &shapes, int xLoc, int yLoc); // brings the selected shape to the end of a vector and front of program
-        void moveShape(vector<Shape *> &shapes, int xLoc, int yLoc);    // moves the selected shape around based on a drag action
+        // selects the shape on top under a point and returns it, nullptr if there is none
+        Shape * pick(ShapeGrid &grid, const ShapeStore &store, int xLoc, int yLoc);
 };
 
 #endif
\ No newline at end of file
@@ -5,6 +5,33 @@
 ******************************************************************************/
 
 #include "shape.h"
+#include "unitcircle.h"
+#include "stats.h"
+
+/** **************************************************************************
+ * @brief Returns the kind of outline a shape type has, filled or not
+ *
+ * @param[in] type - the concrete class of the shape
+ ******************************************************************************/
+ShapeKind kindOf(ShapeType type)
+{
+   static const ShapeKind kinds[] = {LINE_KIND, BOX_KIND, BOX_KIND, CIRCLE_KIND,
+                                     CIRCLE_KIND, ELLIPSE_KIND, ELLIPSE_KIND};
+   return kinds[type];
+}
+
+/** **************************************************************************
+ * @brief Packs a color into 8 bit RGBA, red in the low byte
+ *
+ * @param[in] col - the red, green and blue, 0 to 1
+ ******************************************************************************/
+static uint32_t packColor(const float col[])
+{
+   uint32_t packed = 255u << 24;
+   for(int i = 0; i < 3; i++)
+      packed |= uint32_t(col[i] * 255.0f + 0.5f) << (8 * i);
+   return packed;
+}
 
 /** **************************************************************************
  * @brief Default constructor for the abstract shape class
@@ -51,11 +78,74 @@ int Shape::getXLoc()
 }
 
 /** **************************************************************************
- * @brief Returns the name of the shape
+ * @brief Returns the name of the shape in the shape store, NO_SHAPE if not stored
+ ******************************************************************************/
+ShapeHandle Shape::getHandle()
+{
+   return handle;
+}
+
+/** **************************************************************************
+ * @brief Sets the name of the shape in the shape store
+ * @param[in] h - the handle the store gave the shape, NO_SHAPE once removed
+ ******************************************************************************/
+void Shape::setHandle(ShapeHandle h)
+{
+   handle = h;
+}
+
+/** **************************************************************************
+ * @brief Returns the name of the shape in the shape arena, an empty reference
+ * if the arena did not make it
+ ******************************************************************************/
+ShapeRef Shape::getRef()
+{
+   return ref;
+}
+
+/** **************************************************************************
+ * @brief Sets the name of the shape in the shape arena
+ * @param[in] r - the slot and generation the arena made the shape in
+ ******************************************************************************/
+void Shape::setRef(ShapeRef r)
+{
+   ref = r;
+}
+
+/** **************************************************************************
+ * @brief Returns the name of the shape, the name of its class
+ *
+ * Taken from the type rather than kept by every shape, so a shape holds no
+ * string
  ******************************************************************************/
 std::string Shape::getName()
 {
-   return name;
+   static const char *const NAMES[] = {"Line", "Rectangle", "FilledRectangle", "Circle",
+                                       "Circle", "Ellipse", "Ellipse"};
+   return NAMES[toRecord().type];
+}
+
+/** **************************************************************************
+ * @brief Returns the bytes the shape holds outside the arena, none for a
+ * shape that is not round
+ ******************************************************************************/
+size_t Shape::heapBytes()
+{
+   return 0;
+}
+
+/** **************************************************************************
+ * @brief Returns the bytes the outline of an ellipse takes once it is built
+ *
+ * Follows from the radii alone, the outline is built with exactly this many
+ * bytes, so it is the same before and after the shape is first drawn
+ *
+ * @param[in] radiusX - the x axis radius
+ * @param[in] radiusY - the y axis radius
+ ******************************************************************************/
+size_t Shape::outlineBytes(float radiusX, float radiusY)
+{
+   return 2 * circleSegments(fabs(radiusX) > fabs(radiusY) ? radiusX : radiusY) * sizeof(float);
 }
 
 /** **************************************************************************
@@ -78,6 +168,46 @@ void Shape::setFillColor(const float col[])
       fillColor[i] = col[i];
 }
 
+/** **************************************************************************
+ * @brief Adds the round outline of the shape at its current location
+ *
+ * The outline is built around the origin the first time it is needed and
+ * again only when the radii change. Moving the shape only changes the offset
+ * the kept points are copied with, so redrawing a shape that was moved or not
+ * touched at all costs a copy and no trig.
+ *
+ * @param[in,out] list - the sink being drawn into
+ * @param[in] radiusX - the x axis radius of the outline
+ * @param[in] radiusY - the y axis radius of the outline
+ ******************************************************************************/
+void Shape::traceOutline(RenderSink &list, float radiusX, float radiusY)
+{
+   if(outlineSize[0] != radiusX || outlineSize[1] != radiusY)
+   {
+      tessellateEllipse(outline, radiusX, radiusY);
+      outlineSize[0] = radiusX;
+      outlineSize[1] = radiusY;
+      stats().tessellations.fetch_add(1, std::memory_order_relaxed);
+   }
+   list.points(outline, xLoc, yLoc);
+}
+
+/** **************************************************************************
+ * @brief Returns the record of the shape for the given type and extents
+ *
+ * Only the filled types pack a fill color, an unfilled shape never set one
+ *
+ * @param[in] type - the concrete class of the shape
+ * @param[in] a - the x extent, a width or radius
+ * @param[in] b - the y extent, a height or radius
+ ******************************************************************************/
+ShapeRecord Shape::makeRecord(ShapeType type, float a, float b)
+{
+   bool filled = type == FILLED_RECTANGLE_TYPE || type == FILLED_CIRCLE_TYPE || type == FILLED_ELLIPSE_TYPE;
+   ShapeRecord rec = {type, float(xLoc), float(yLoc), a, b, packColor(borderColor),
+                      filled ? packColor(fillColor) : 0u};
+   return rec;
+}
 /** **************************************************************************
  * @brief Constructor for the line subclass
  *
@@ -88,45 +218,39 @@ void Shape::setFillColor(const float col[])
  * @param[in] h - the height of the line
  * @param[in] w - the width of the line
  * @param[in] bcol - the desired border color of the line
- * @param[in] nm - the name/type of the line
  ******************************************************************************/
-Line::Line(int x, int y, int h, int w, const float bcol[], std::string nm)
+Line::Line(int x, int y, int h, int w, const float bcol[])
 {
-   xLoc = x; yLoc = y; ; height = h; width = w; name = name;
+   xLoc = x; yLoc = y; height = h; width = w;
    setBorderColor(bcol);
 }
 
 /** **************************************************************************
- * @brief Checks to see if the entered point is contained by the line
- *
- * @param[in] x   - the x-coordinate of the point
- * @param[in] y   - the y-coordinate of the point
+ * @brief Draws the line
  ******************************************************************************/
-bool Line::contains(int x, int y)
+void Line::draw(RenderSink &list)
 {
-   float slope = float(height) / float(width);
-   
-   for(int i = 1; i < 8; i++)
-   {
-      if(y + i == int((slope * (float(x) - float(xLoc))) + float(yLoc)))
-         return true;
-      if(y - i == int((slope * (float(x) - float(xLoc))) + float(yLoc)))
-         return true;
-   }
+   list.color( borderColor );   
+   list.begin(GL_LINES);
+      list.vertex(xLoc, yLoc);
+      list.vertex(xLoc + width, yLoc + height);          
+   list.end();
+}
 
-   return false;
+/** **************************************************************************
+ * @brief Returns the pixels the line may cover, both ends included
+ ******************************************************************************/
+Box Line::bounds()
+{
+   return Box(xLoc, yLoc, xLoc + width, yLoc + height);
 }
 
 /** **************************************************************************
- * @brief Draws the line
+ * @brief Returns the line as plain numbers, for the shape store
  ******************************************************************************/
-void Line::draw()
+ShapeRecord Line::toRecord()
 {
-   glColor3fv( borderColor );   
-   glBegin(GL_LINES);
-      glVertex2f(xLoc, yLoc);
-      glVertex2f(xLoc + width, yLoc + height);          
-   glEnd();
+   return makeRecord(LINE_TYPE, width, height);
 }
 
 
@@ -140,12 +264,11 @@ void Line::draw()
  * @param[in] h - the height of the rectangle
  * @param[in] w - the width of the rectangle
  * @param[in] bcol - the desired border color of the rectangle
- * @param[in] nm - the name/type of the rectangle
  ******************************************************************************/
 Rectangle::Rectangle(int x, int y, int h, 
-int w, const float bcol[], std::string nm) : height(h), width(w)
+int w, const float bcol[]) : height(h), width(w)
  {
-   xLoc = x; yLoc = y; name = nm;
+   xLoc = x; yLoc = y;
    setBorderColor(bcol);
  }
 
@@ -155,48 +278,43 @@ int w, const float bcol[], std::string nm) : height(h), width(w)
 Rectangle::Rectangle() {}
 
 /** **************************************************************************
- * @brief Checks to see if the entered point is contained by the rectangle
+ * @brief Draws either a unfilled rectangle
+ * 
+ * Otherwise, there will be a fill color in the drawn rectangle
  *
- * @param[in] x   - the x-coordinate of the point
- * @param[in] y   - the y-coordinate of the point
  ******************************************************************************/
-bool Rectangle::contains(int x, int y)
+void Rectangle::draw(RenderSink &list)
 {
-   if(x > xLoc && x < xLoc + width && y < yLoc && y > yLoc + height) // top left
-      return true;
-
-   if(x < xLoc && x > xLoc + width && y > yLoc && y < yLoc + height) // bottom right
-      return true;
-
-   if(x > xLoc && x < xLoc + width && y > yLoc && y < yLoc + height) // bottom left
-      return true;
-
-   if(x < xLoc && x > xLoc + width && y < yLoc && y > yLoc + height) // top right
-      return true;
-      
-   return false;
+   // Border  
+   list.color( borderColor );   
+   list.begin(GL_LINE_LOOP);
+      list.vertex(xLoc - 1, yLoc);
+      list.vertex(xLoc + width, yLoc);
+      list.vertex(xLoc + width, yLoc + height);
+      list.vertex(xLoc, yLoc + height);
+      list.vertex(xLoc - 1, yLoc);
+      list.vertex(xLoc, yLoc + height);
+      list.vertex(xLoc + width, yLoc + height);
+      list.vertex(xLoc + width, yLoc);           
+   list.end();
 }
 
 /** **************************************************************************
- * @brief Draws either a unfilled rectangle
- * 
- * Otherwise, there will be a fill color in the drawn rectangle
+ * @brief Returns the pixels the rectangle may cover, filled or not
  *
+ * The border starts a pixel left of the corner, see draw
  ******************************************************************************/
-void Rectangle::draw()
+Box Rectangle::bounds()
 {
-   // Border  
-   glColor3fv( borderColor );   
-   glBegin(GL_LINE_LOOP);
-      glVertex2f(xLoc - 1, yLoc);
-      glVertex2f(xLoc + width, yLoc);
-      glVertex2f(xLoc + width, yLoc + height);
-      glVertex2f(xLoc, yLoc + height);
-      glVertex2f(xLoc - 1, yLoc);
-      glVertex2f(xLoc, yLoc + height);
-      glVertex2f(xLoc + width, yLoc + height);
-      glVertex2f(xLoc + width, yLoc);           
-   glEnd();
+   return Box(xLoc - 1, yLoc, xLoc + width, yLoc + height);
+}
+
+/** **************************************************************************
+ * @brief Returns the rectangle as plain numbers, for the shape store
+ ******************************************************************************/
+ShapeRecord Rectangle::toRecord()
+{
+   return makeRecord(RECTANGLE_TYPE, width, height);
 }
 
 
@@ -211,12 +329,11 @@ void Rectangle::draw()
  * @param[in] w - the width of the rectangle
  * @param[in] fcol - the desired fill color of the rectangle
  * @param[in] bcol - the desired border color of the rectangle
- * @param[in] nm - the name/type of the rectangle
  ******************************************************************************/
 FilledRectangle::FilledRectangle(int x, int y, int h, 
-int w, const float bcol[], const float fcol[], std::string nm)
+int w, const float bcol[], const float fcol[])
  {
-   xLoc = x; yLoc = y; name = nm; height = h; width = w;
+   xLoc = x; yLoc = y; height = h; width = w;
    setFillColor(fcol);
    setBorderColor(bcol);
  }
@@ -224,28 +341,36 @@ int w, const float bcol[], const float fcol[], std::string nm)
 /** **************************************************************************
  * @brief Draws a filled rectangle
  ******************************************************************************/
- void FilledRectangle::draw()
+ void FilledRectangle::draw(RenderSink &list)
 {
    // Fill Draw
-   glColor3fv( fillColor );   
-      glBegin(GL_POLYGON);
-      glVertex2f(xLoc, yLoc);
-      glVertex2f(xLoc + width, yLoc);
-      glVertex2f(xLoc + width, yLoc + height);
-      glVertex2f(xLoc, yLoc + height);         
-   glEnd();
+   list.color( fillColor );   
+      list.begin(GL_POLYGON);
+      list.vertex(xLoc, yLoc);
+      list.vertex(xLoc + width, yLoc);
+      list.vertex(xLoc + width, yLoc + height);
+      list.vertex(xLoc, yLoc + height);         
+   list.end();
    // Border  
-   glColor3fv( borderColor );   
-   glBegin(GL_LINE_LOOP);
-      glVertex2f(xLoc - 1, yLoc);
-      glVertex2f(xLoc + width, yLoc);
-      glVertex2f(xLoc + width, yLoc + height);
-      glVertex2f(xLoc, yLoc + height);
-      glVertex2f(xLoc - 1, yLoc);
-      glVertex2f(xLoc, yLoc + height);
-      glVertex2f(xLoc + width, yLoc + height);
-      glVertex2f(xLoc + width, yLoc);           
-   glEnd();
+   list.color( borderColor );   
+   list.begin(GL_LINE_LOOP);
+      list.vertex(xLoc - 1, yLoc);
+      list.vertex(xLoc + width, yLoc);
+      list.vertex(xLoc + width, yLoc + height);
+      list.vertex(xLoc, yLoc + height);
+      list.vertex(xLoc - 1, yLoc);
+      list.vertex(xLoc, yLoc + height);
+      list.vertex(xLoc + width, yLoc + height);
+      list.vertex(xLoc + width, yLoc);           
+   list.end();
+}
+
+/** **************************************************************************
+ * @brief Returns the filled rectangle as plain numbers, for the shape store
+ ******************************************************************************/
+ShapeRecord FilledRectangle::toRecord()
+{
+   return makeRecord(FILLED_RECTANGLE_TYPE, width, height);
 }
 
 
@@ -260,11 +385,10 @@ int w, const float bcol[], const float fcol[], std::string nm)
  * @param[in] y - the y location of the circle
  * @param[in] r - the radius of the circle
  * @param[in] bcol - the desired border color of the circle
- * @param[in] nm - the name/type of the circle
  ******************************************************************************/
-Circle::Circle(int x, int y, int r, const float bcol[], std::string nm)
+Circle::Circle(int x, int y, int r, const float bcol[])
 {
-   xLoc = x; yLoc = y; name = nm; radius = r;     // set variables
+   xLoc = x; yLoc = y; radius = r;     // set variables
    setBorderColor(bcol);   // set border color
 }
 
@@ -274,39 +398,52 @@ Circle::Circle(int x, int y, int r, const float bcol[], std::string nm)
 Circle::Circle() {}
 
 /** **************************************************************************
- * @brief Checks to see if the entered point is contained by the circle
- *
- * @param[in] x   - the x-coordinate of the point
- * @param[in] y   - the y-coordinate of the point
+ * @brief Draws either an unfilled circle given it's dimensions
  ******************************************************************************/
-bool Circle::contains(int x, int y)
+void Circle::draw(RenderSink &list)
 {
-   int xDist, yDist, sum;
-   // determine the x and y components of a containment function
-   xDist = pow(x - xLoc,2);
-   yDist = pow(y - yLoc,2);
-   // add them
-   sum = xDist + yDist;
-   // if they add to less than the radius squared, the point is within the circle
-   if(sum < pow(radius, 2))
-      return true;
-   return false;
+   list.color(borderColor);
+   list.begin(GL_LINE_LOOP);
+      traceOutline(list, radius, radius);
+   list.end();
 }
 
 /** **************************************************************************
- * @brief Draws either an unfilled circle given it's dimensions
+ * @brief Returns the pixels the circle may cover, filled or not
  ******************************************************************************/
-void Circle::draw()
+Box Circle::bounds()
 {
-   float theta;
-   glColor3fv(borderColor);
-   glBegin(GL_LINE_LOOP);
-      for(int i = 0; i < 360; i++)  // draw around 360 times for the circle
-      {
-         theta = i * 3.142 / 180;
-         glVertex2f(xLoc + radius*cos(theta), yLoc + radius*sin(theta));
-      }
-   glEnd();
+   return Box(xLoc - radius, yLoc - radius, xLoc + radius, yLoc + radius);
+}
+
+/** **************************************************************************
+ * @brief Returns the circle as plain numbers, for the shape store
+ ******************************************************************************/
+ShapeRecord Circle::toRecord()
+{
+   return makeRecord(CIRCLE_TYPE, radius, radius);
+}
+
+/** **************************************************************************
+ * @brief Returns the bytes the outline of the circle holds, filled or not
+ ******************************************************************************/
+size_t Circle::heapBytes()
+{
+   return outlineBytes(radius, radius);
+}
+
+/** **************************************************************************
+ * @brief Changes the radius of the circle
+ *
+ * The kept outline is rebuilt in its own memory when next drawn. The arena
+ * counts the outline of the shapes it made by their size, so only a shape it
+ * did not make may be resized.
+ *
+ * @param[in] r - the new radius
+ ******************************************************************************/
+void Circle::setRadius(int r)
+{
+   radius = r;
 }
 
 /** **************************************************************************
@@ -319,38 +456,40 @@ void Circle::draw()
  * @param[in] r - the radius of the circle
  * @param[in] fcol - the desired fill color of the circle
  * @param[in] bcol - the desired border color of the circle
- * @param[in] nm - the name/type of the circle
  ******************************************************************************/
-FilledCircle::FilledCircle(int x, int y, int r, const float bcol[], const float fcol[], std::string nm)
+FilledCircle::FilledCircle(int x, int y, int r, const float bcol[], const float fcol[])
 {
-   xLoc = x; yLoc = y; name = nm; radius = r;
+   xLoc = x; yLoc = y; radius = r;
    setBorderColor(bcol);
    setFillColor(fcol);
 }
 
+/** **************************************************************************
+ * @brief Base constructor for the filled circle class
+ ******************************************************************************/
+FilledCircle::FilledCircle() {}
+
 /** **************************************************************************
  * @brief Draws a filled circle given it's dimensions and colors
  ******************************************************************************/
-void FilledCircle::draw()
+void FilledCircle::draw(RenderSink &list)
 {
-   float theta;
-   glColor3fv(fillColor); 
-   glBegin(GL_POLYGON);
-      for(int i = 0; i < 360; i++)
-      {
-         theta = i * 3.142 / 180;
-         glVertex2f(xLoc + radius*cos(theta), yLoc + radius*sin(theta));
-      }
-   glEnd();
+   list.color(fillColor); 
+   list.begin(GL_POLYGON);
+      traceOutline(list, radius, radius);
+   list.end();
+   list.color(borderColor);
+   list.begin(GL_LINE_LOOP);
+      traceOutline(list, radius, radius);
+   list.end();
+}
 
-   glColor3fv(borderColor);
-      glBegin(GL_LINE_LOOP);
-      for(int i = 0; i < 360; i++)
-      {
-         theta = i * 3.142 / 180;
-         glVertex2f(xLoc + radius*cos(theta), yLoc + radius*sin(theta));
-      }
-      glEnd();
+/** **************************************************************************
+ * @brief Returns the filled circle as plain numbers, for the shape store
+ ******************************************************************************/
+ShapeRecord FilledCircle::toRecord()
+{
+   return makeRecord(FILLED_CIRCLE_TYPE, radius, radius);
 }
 
 
@@ -364,11 +503,10 @@ void FilledCircle::draw()
  * @param[in] xrad - the x-axis radius of the ellipse
  * @param[in] yrad - the y-axis radius of the ellipse
  * @param[in] bcol - the desired border color of the ellipse
- * @param[in] nm - the name/type of the ellipse
  ******************************************************************************/
-Ellipse::Ellipse(int x, int y, int xrad, int yrad, const float bcol[], std::string nm)
+Ellipse::Ellipse(int x, int y, int xrad, int yrad, const float bcol[])
 {
-   xLoc = x; yLoc = y; radiusX = xrad; radiusY = yrad; name = nm;
+   xLoc = x; yLoc = y; radiusX = xrad; radiusY = yrad;
    setBorderColor(bcol);
 }
 
@@ -378,45 +516,58 @@ Ellipse::Ellipse(int x, int y, int xrad, int yrad, const float bcol[], std::stri
 Ellipse::Ellipse() {}
 
 /** **************************************************************************
- * @brief Checks to see if the entered point is contained by the ellipse
+ * @brief Draws either a filled or unfilled ellipse
+ * 
+ * If fill color contains a -1, there will be no fill
+ * Otherwise, there will be a fill color in the drawn ellipse
  *
- * @param[in] x   - the x-coordinate of the point
- * @param[in] y   - the y-coordinate of the point
  ******************************************************************************/
-bool Ellipse::contains(int x, int y)
+void Ellipse::draw(RenderSink &list)
 {
-   float xDist, yDist, sum;        // initialize variables
-   xDist = float((x - xLoc)) / float(radiusX);  // calculate x distance component
-   yDist = float((y - yLoc)) / float(radiusY);  // calculate y distance compenent
-   xDist = pow(xDist,2);  // square and y components
-   yDist = pow(yDist,2);  
+   list.color(borderColor); // border
+   list.begin(GL_LINE_LOOP);
+      traceOutline(list, radiusX, radiusY);
+   list.end();
+}
 
-   sum = xDist + yDist;   // add the components, if sum less than 1, point is within ellipse
+/** **************************************************************************
+ * @brief Returns the pixels the ellipse may cover, filled or not
+ ******************************************************************************/
+Box Ellipse::bounds()
+{
+   return Box(xLoc - radiusX, yLoc - radiusY, xLoc + radiusX, yLoc + radiusY);
+}
 
-   if(sum <= 1)
-      return true;
+/** **************************************************************************
+ * @brief Returns the ellipse as plain numbers, for the shape store
+ ******************************************************************************/
+ShapeRecord Ellipse::toRecord()
+{
+   return makeRecord(ELLIPSE_TYPE, radiusX, radiusY);
+}
 
-   return false;
+/** **************************************************************************
+ * @brief Returns the bytes the outline of the ellipse holds, filled or not
+ ******************************************************************************/
+size_t Ellipse::heapBytes()
+{
+   return outlineBytes(radiusX, radiusY);
 }
 
 /** **************************************************************************
- * @brief Draws either a filled or unfilled ellipse
- * 
- * If fill color contains a -1, there will be no fill
- * Otherwise, there will be a fill color in the drawn ellipse
+ * @brief Changes the radii of the ellipse
+ *
+ * The kept outline is rebuilt in its own memory when next drawn. The arena
+ * counts the outline of the shapes it made by their size, so only a shape it
+ * did not make may be resized.
  *
+ * @param[in] xrad - the new x-axis radius
+ * @param[in] yrad - the new y-axis radius
  ******************************************************************************/
-void Ellipse::draw()
+void Ellipse::setRadii(int xrad, int yrad)
 {
-   float theta;
-   glColor3fv(borderColor); // border
-   glBegin(GL_LINE_LOOP);
-	for(int i=0; i < 360; i++)
-	{
-		theta = i * 3.142 / 180;
-		glVertex2f(xLoc + cos(theta)*radiusX,yLoc + sin(theta)*radiusY);
-	} 
-	glEnd();
+   radiusX = xrad;
+   radiusY = yrad;
 }
 
 
@@ -431,35 +582,38 @@ void Ellipse::draw()
  * @param[in] yrad - the y-axis radius of the ellipse
  * @param[in] fcol - the desired fill color of the ellipse
  * @param[in] bcol - the desired border color of the ellipse
- * @param[in] nm - the name/type of the ellipse
  ******************************************************************************/
-FilledEllipse::FilledEllipse(int x, int y, int xrad, int yrad, const float bcol[], const float fcol[], std::string nm)
+FilledEllipse::FilledEllipse(int x, int y, int xrad, int yrad, const float bcol[], const float fcol[])
 {
-   xLoc = x; yLoc = y; radiusX = xrad; radiusY = yrad; name = nm;
+   xLoc = x; yLoc = y; radiusX = xrad; radiusY = yrad;
    setBorderColor(bcol);
    setFillColor(fcol);
 }
 
+/** **************************************************************************
+ * @brief Default constructor for the filled ellipse class
+ ******************************************************************************/
+FilledEllipse::FilledEllipse() {}
+
 /** **************************************************************************
  * @brief Draws a filled ellipse
  ******************************************************************************/
-void FilledEllipse::draw()
+void FilledEllipse::draw(RenderSink &list)
 {
-   float theta;
-   glColor3fv(fillColor); 
-   glBegin(GL_POLYGON);
-   for(int i = 0; i < 360; i++)
-   {
-      theta = i * 3.142 / 180;
-      glVertex2f(xLoc + cos(theta)*radiusX,yLoc + sin(theta)*radiusY);
-   }
-   glEnd();
-   glColor3fv(borderColor); // border
-   glBegin(GL_LINE_LOOP);
-	for(int i=0; i < 360; i++)
-	{
-		theta = i * 3.142 / 180;
-		glVertex2f(xLoc + cos(theta)*radiusX,yLoc + sin(theta)*radiusY);
-	} 
-	glEnd();
-}
\ No newline at end of file
+   list.color(fillColor); 
+   list.begin(GL_POLYGON);
+      traceOutline(list, radiusX, radiusY);
+   list.end();
+   list.color(borderColor); // border
+   list.begin(GL_LINE_LOOP);
+      traceOutline(list, radiusX, radiusY);
+   list.end();
+}
+
+/** **************************************************************************
+ * @brief Returns the filled ellipse as plain numbers, for the shape store
+ ******************************************************************************/
+ShapeRecord FilledEllipse::toRecord()
+{
+   return makeRecord(FILLED_ELLIPSE_TYPE, radiusX, radiusY);
+}
@@ -8,9 +8,60 @@
 
 #include <string>
 #include <iostream>
+#include <cstdint>
 #include "graphics.h"
+#include "rendersink.h"
+#include "box.h"
 
 
+/*!
+ * @brief The concrete shape classes, as stored in the shape store
+ */
+enum ShapeType : uint8_t
+{
+    LINE_TYPE, RECTANGLE_TYPE, FILLED_RECTANGLE_TYPE, CIRCLE_TYPE,
+    FILLED_CIRCLE_TYPE, ELLIPSE_TYPE, FILLED_ELLIPSE_TYPE
+};
+
+/*!
+ * @brief The kinds of outline, each kind is stored and hit tested on its own
+ */
+enum ShapeKind { LINE_KIND, BOX_KIND, CIRCLE_KIND, ELLIPSE_KIND, SHAPE_KINDS };
+
+typedef uint32_t ShapeHandle;               /*!< stable name of a shape in the shape store */
+const ShapeHandle NO_SHAPE = UINT32_MAX;    /*!< the handle of a shape not in a store */
+
+/*!
+ * @brief ShapeRef struct, names a shape made by the shape arena
+ *
+ * The generation tells a shape apart from the shapes made in the same slot
+ * before and after it, so a kept reference never reaches a deleted shape.
+ */
+struct ShapeRef
+{
+    uint32_t index = UINT32_MAX;    /*!< the arena slot holding the shape */
+    uint32_t generation = 0;        /*!< which shape made in that slot, 0 for none */
+};
+
+/*!
+ * @brief ShapeRecord struct, a shape as plain numbers
+ *
+ * The extents are the width and height of a line or rectangle, from its
+ * location, and the radii of a circle or ellipse, around its location.
+ */
+struct ShapeRecord
+{
+    ShapeType type;     /*!< the concrete class of the shape */
+    float x;            /*!< the x location */
+    float y;            /*!< the y location */
+    float a;            /*!< the x extent */
+    float b;            /*!< the y extent */
+    uint32_t border;    /*!< the border color, packed RGBA */
+    uint32_t fill;      /*!< the fill color, packed RGBA, 0 if not filled */
+};
+
+ShapeKind kindOf(ShapeType type);   // returns the kind of outline a shape type has
+
 /****************************************************************************
  *                          BASE SHAPE CLASS
  * **************************************************************************/
@@ -21,16 +72,28 @@
 class Shape 
 {
 protected:
-    std::string name;     /*!< the name/tyep of the shape */
     int xLoc;             /*!< the x location of the shape */
     int yLoc;             /*!< the y location of the cursor */
     float fillColor[3];   /*!< the fill color of the shape */
     float borderColor[3]; /*!< the border color of the shape */
+    vector<float> outline;              /*!< the round outline as x/y pairs around 0, 0, built once */
+    float outlineSize[2] = {-1, -1};    /*!< the radii the outline was built for */
+    ShapeHandle handle = NO_SHAPE;      /*!< the name of the shape in the shape store */
+    ShapeRef ref;                       /*!< the name of the shape in the shape arena */
+    void traceOutline(RenderSink &list, float radiusX, float radiusY);  // adds the kept outline at the shape's location
+    ShapeRecord makeRecord(ShapeType type, float a, float b);          // the record of the shape with the given extents
+    static size_t outlineBytes(float radiusX, float radiusY);          // the bytes the outline of an ellipse takes
 public:
     Shape();    // shape constructor
-    ~Shape();   // shape destructor
-    virtual bool contains(int x, int y) = 0;    // checks to see if point is contained in shape
-    virtual void draw() = 0;                       // draws the shape
+    virtual ~Shape();   // shape destructor
+    virtual void draw(RenderSink &list) = 0;       // draws the shape into a sink
+    virtual Box bounds() = 0;                   // returns the pixels the shape may cover
+    virtual ShapeRecord toRecord() = 0;         // returns the shape as plain numbers
+    virtual size_t heapBytes();                 // returns the bytes the shape holds outside the arena
+    ShapeHandle getHandle();                    // returns the name of the shape in the shape store
+    void setHandle(ShapeHandle h);              // sets the name of the shape in the shape store
+    ShapeRef getRef();                          // returns the name of the shape in the shape arena
+    void setRef(ShapeRef r);                    // sets the name of the shape in the shape arena
     void setFillColor(const float col[]);       // sets the fill color of the shape
     void setBorderColor(const float col[]);     // sets the border color of the shape
     int getXLoc();                              // returns the x location of the shape
@@ -52,9 +115,10 @@ protected:
     int height;   /*!< Height of the line from start to end*/
     int width;    /*!< Width of the line from start to end */
 public:
-    Line(int x, int y, int h, int w, const float bcol[], std::string nm = "Line"); // constructor for line
-    bool contains(int x, int y);    // returns whether the point is on the line
-    void draw();    // draws the line
+    Line(int x, int y, int h, int w, const float bcol[]); // constructor for line
+    void draw(RenderSink &list);    // draws the line
+    Box bounds();                   // returns the pixels the line may cover
+    ShapeRecord toRecord();         // returns the line as plain numbers
 };
 /****************************************************************************
  *                          RECTANGLE CLASSES
@@ -69,10 +133,11 @@ protected:
     int width;  /*!< Width of the rectangle */
 public:
     /// rectangle constructor, sets all the properties
-    Rectangle(int x, int y, int h, int w, const float bcol[], std::string nm = "Rectangle");
+    Rectangle(int x, int y, int h, int w, const float bcol[]);
     Rectangle();
-    bool contains(int x, int y);    // checks to see if the point is contained in shape
-    void draw();                    // draws the rectangle
+    void draw(RenderSink &list);                    // draws the rectangle
+    Box bounds();                   // returns the pixels the rectangle may cover
+    ShapeRecord toRecord();         // returns the rectangle as plain numbers
 };
 
 /*!
@@ -81,8 +146,9 @@ public:
 class FilledRectangle : public Rectangle
 {
 public:
-    FilledRectangle(int x, int y, int h, int w, const float bcol[], const float fcol[], std::string nm = "FilledRectangle");
-    void draw();
+    FilledRectangle(int x, int y, int h, int w, const float bcol[], const float fcol[]);
+    void draw(RenderSink &list);
+    ShapeRecord toRecord();         // returns the filled rectangle as plain numbers
 };
 
 /*!
@@ -93,10 +159,13 @@ class Circle : public Shape
 protected:
     int radius; /*!< the radius of the circle */
 public:
-    Circle(int x, int y, int r, const float bcol[], std::string nm = "Circle"); // circle constructor
+    Circle(int x, int y, int r, const float bcol[]); // circle constructor
     Circle();
-    bool contains(int x, int y);    // checks to see if the point is contained in the circle
-    void draw();                    // draws the circle
+    void draw(RenderSink &list);                    // draws the circle
+    Box bounds();                   // returns the pixels the circle may cover
+    ShapeRecord toRecord();         // returns the circle as plain numbers
+    size_t heapBytes();             // returns the bytes its outline holds
+    void setRadius(int r);          // resizes a circle the arena did not make, i.e. a preview
 };
 
 /*!
@@ -105,8 +174,10 @@ public:
 class FilledCircle : public Circle
 {
 public:
-    FilledCircle(int x, int y, int r, const float bcol[], const float fcol[], std::string nm = "Circle"); // circle constructor
-    void draw();    // draws the circle
+    FilledCircle(int x, int y, int r, const float bcol[], const float fcol[]); // circle constructor
+    FilledCircle();
+    void draw(RenderSink &list);    // draws the circle
+    ShapeRecord toRecord();         // returns the filled circle as plain numbers
 };
 
 
@@ -122,10 +193,13 @@ protected:
     int radiusX; /*!< the x axis radius of the ellipse */
     int radiusY; /*!< the y axis radius of the ellipse */
 public:
-    Ellipse(int x, int y, int xrad, int yrad, const float bcol[], std::string nm = "Ellipse");
+    Ellipse(int x, int y, int xrad, int yrad, const float bcol[]);
     Ellipse(); // default constructor for the ellipse
-    bool contains(int x, int y);    // returns whether the point is contained in the ellipse
-    void draw();    // draws the ellipse
+    void draw(RenderSink &list);    // draws the ellipse
+    Box bounds();                   // returns the pixels the ellipse may cover
+    ShapeRecord toRecord();         // returns the ellipse as plain numbers
+    size_t heapBytes();             // returns the bytes its outline holds
+    void setRadii(int xrad, int yrad);  // resizes an ellipse the arena did not make, i.e. a preview
 };
 
 /*!
@@ -134,7 +208,9 @@ public:
 class FilledEllipse : public Ellipse
 {
 public:
-    FilledEllipse(int x, int y, int xrad, int yrad, const float bcol[], const float fcol[], std::string nm = "Ellipse"); // constructor of ellipse
-    void draw();    // draws the ellipse
+    FilledEllipse(int x, int y, int xrad, int yrad, const float bcol[], const float fcol[]); // constructor of ellipse
+    FilledEllipse();
+    void draw(RenderSink &list);    // draws the ellipse
+    ShapeRecord toRecord();         // returns the filled ellipse as plain numbers
 };
 #endif
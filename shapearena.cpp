@@ -0,0 +1,143 @@
+/** ***************************************************************************
+* @file
+* @brief Cpp file including functions for the shapearena.h, holds the functions
+* which hand out, free and look up the slots of the shape arena
+******************************************************************************/
+
+#include "shapearena.h"
+#include "stats.h"
+
+/** **************************************************************************
+ * @brief Destroys every shape still in the arena
+ ******************************************************************************/
+ShapeArena::~ShapeArena()
+{
+   for (size_t c = 0; c < chunks.size(); c++)
+      for (uint32_t i = 0; i < ARENA_CHUNK; i++)
+         if (chunks[c][i].shape != nullptr)
+            chunks[c][i].shape->~Shape();
+}
+
+/** **************************************************************************
+ * @brief Returns a slot by index
+ *
+ * @param[in] index - the slot, less than the slots allocated
+ ******************************************************************************/
+ShapeArena::Slot &ShapeArena::slot(uint32_t index) const
+{
+   return chunks[index / ARENA_CHUNK][index % ARENA_CHUNK];
+}
+
+/** **************************************************************************
+ * @brief Returns an empty slot for a new shape
+ *
+ * Freed slots are taken first, then the slots after the last one handed out,
+ * and only then a new chunk is allocated.
+ *
+ * @returns the index of the slot
+ ******************************************************************************/
+uint32_t ShapeArena::take()
+{
+   uint32_t index;
+   if (!freed.empty())
+   {
+      index = freed.back();
+      freed.pop_back();
+   }
+   else
+   {
+      if (used == chunks.size() * ARENA_CHUNK)
+         chunks.emplace_back(new Slot[ARENA_CHUNK]);
+      index = used++;
+   }
+   return index;
+}
+
+/** **************************************************************************
+ * @brief Gives a shape just made in a slot its generation and reference
+ *
+ * @param[in] index - the slot the shape was made in
+ * @param[in,out] shape - the shape, its reference is set
+ ******************************************************************************/
+void ShapeArena::made(uint32_t index, Shape *shape)
+{
+   Slot &s = slot(index);
+   s.shape = shape;
+   s.generation = nextGeneration++;
+   ShapeRef ref;
+   ref.index = index;
+   ref.generation = s.generation;
+   shape->setRef(ref);
+
+   live++;
+   heap += shape->heapBytes();
+   if (live > peak)
+      peak = live;
+   publish();
+}
+
+/** **************************************************************************
+ * @brief Destroys a shape and frees its slot for the next shape
+ *
+ * Shapes the arena did not make, or already freed, are ignored
+ *
+ * @param[in,out] shape - the shape, it must not be used again
+ ******************************************************************************/
+void ShapeArena::release(Shape *shape)
+{
+   ShapeRef ref = shape->getRef();
+   if (get(ref) != shape)
+      return;
+   Slot &s = slot(ref.index);
+   heap -= shape->heapBytes();
+   shape->~Shape();
+   s.shape = nullptr;
+   s.generation = 0;
+   freed.push_back(ref.index);
+   live--;
+   publish();
+}
+
+/** **************************************************************************
+ * @brief Returns the shape a reference names
+ *
+ * @param[in] ref - the reference, made when the shape was
+ *
+ * @returns the shape, nullptr if it was freed or the reference is empty
+ ******************************************************************************/
+Shape *ShapeArena::get(ShapeRef ref) const
+{
+   if (ref.index >= chunks.size() * ARENA_CHUNK)
+      return nullptr;
+   Slot &s = slot(ref.index);
+   if (s.generation != ref.generation)
+      return nullptr;
+   return s.shape;
+}
+
+/** **************************************************************************
+ * @brief Returns how many shapes are live and how much memory the arena and
+ * its shapes hold
+ ******************************************************************************/
+ArenaStats ShapeArena::usage() const
+{
+   ArenaStats usage;
+   usage.live = live;
+   usage.peak = peak;
+   usage.slots = chunks.size() * ARENA_CHUNK;
+   usage.bytes = usage.slots * sizeof(Slot);
+   usage.heap = heap;
+   return usage;
+}
+
+/** **************************************************************************
+ * @brief Copies the arena counts into the program wide counters
+ ******************************************************************************/
+void ShapeArena::publish() const
+{
+   ArenaStats now = usage();
+   stats().shapesLive.store(now.live, std::memory_order_relaxed);
+   stats().shapesPeak.store(now.peak, std::memory_order_relaxed);
+   stats().shapeBytes.store(now.bytes, std::memory_order_relaxed);
+   stats().shapeHeapBytes.store(now.heap, std::memory_order_relaxed);
+}
@@ -0,0 +1,101 @@
+/** ***************************************************************************
+* @file
+* @brief Header file that holds the ShapeArena class, which makes and frees
+* the shapes of the document in fixed size slots and names them by
+* generation checked references
+******************************************************************************/
+
+#ifndef __SHAPEARENA_H
+#define __SHAPEARENA_H
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+#include "shape.h"
+
+const uint32_t ARENA_CHUNK = 256;   /*!< slots added to the arena at a time */
+
+/*!
+ * @brief The bytes each arena slot holds, enough for any concrete shape
+ */
+const size_t SHAPE_SLOT_SIZE = std::max({sizeof(Line), sizeof(Rectangle), sizeof(FilledRectangle),
+                                         sizeof(Circle), sizeof(FilledCircle), sizeof(Ellipse),
+                                         sizeof(FilledEllipse)});
+
+/*!
+ * @brief ArenaStats struct, how much the shape arena holds
+ */
+struct ArenaStats
+{
+    size_t live;    /*!< shapes made and not yet freed */
+    size_t peak;    /*!< the most shapes live at once */
+    size_t slots;   /*!< slots allocated, live or free */
+    size_t bytes;   /*!< bytes allocated for the slots */
+    size_t heap;    /*!< bytes the live shapes hold outside their slots, their outlines */
+};
+
+/*!
+ * @brief ShapeArena class, owns every shape of the document
+ *
+ * Shapes are made in slots taken from chunks of ARENA_CHUNK, chunks are
+ * never given back so a shape never moves. Freed slots are used again
+ * before new ones, so memory only grows with the most shapes ever alive at
+ * once.
+ *
+ * A round shape also keeps its outline on the heap. Its size follows from
+ * the radii, so the arena counts it when the shape is made and freed, and
+ * reports it next to the slots.
+ *
+ * Every shape made gets a generation no earlier shape had. A ShapeRef holds
+ * the slot and generation, and only resolves while that very shape is live.
+ */
+class ShapeArena
+{
+    /*!
+     * @brief One slot, holds at most one shape
+     */
+    struct Slot
+    {
+        alignas(std::max_align_t) unsigned char storage[SHAPE_SLOT_SIZE];  /*!< the shape */
+        Shape *shape = nullptr;     /*!< the shape in storage, nullptr once it is destroyed */
+        uint32_t generation = 0;    /*!< generation of the shape held, 0 if none is live */
+    };
+
+    std::vector<std::unique_ptr<Slot[]>> chunks;    /*!< the slots, ARENA_CHUNK per chunk */
+    std::vector<uint32_t> freed;                    /*!< freed slots, used first */
+    uint32_t used = 0;                  /*!< slots handed out so far, in order */
+    uint32_t nextGeneration = 1;        /*!< the generation of the next shape made */
+    size_t live = 0;                    /*!< shapes live */
+    size_t heap = 0;                    /*!< bytes the live shapes hold outside their slots */
+    size_t peak = 0;                    /*!< the most shapes live at once */
+
+    Slot &slot(uint32_t index) const;   // returns a slot by index
+    uint32_t take();                    // returns an empty slot
+    void made(uint32_t index, Shape *shape);  // names a shape just made in a slot
+    void publish() const;               // copies the counts into the program wide counters
+public:
+    ShapeArena() = default;
+    ShapeArena(const ShapeArena &other) = delete;
+    ShapeArena &operator=(const ShapeArena &other) = delete;
+    ~ShapeArena();
+
+    /// makes a shape of class T in a free slot, the arguments go to its constructor
+    template <typename T, typename... Args>
+    T *make(Args &&... args)
+    {
+        static_assert(sizeof(T) <= SHAPE_SLOT_SIZE, "shape class too large for an arena slot");
+        uint32_t index = take();
+        T *shape = new (slot(index).storage) T(std::forward<Args>(args)...);
+        made(index, shape);
+        return shape;
+    }
+
+    void release(Shape *shape);         // destroys a shape and frees its slot
+    Shape *get(ShapeRef ref) const;     // returns the shape a reference names, nullptr if it is gone
+    ArenaStats usage() const;           // returns the live, peak, allocated and heap counts
+};
+
+#endif
@@ -0,0 +1,395 @@
+/** ***************************************************************************
+* @file
+* @brief Cpp file including functions for the shapestore.h, holds the functions
+* which keep the shape arrays packed and the hit test kernels
+*
+* Each kernel tests one point against HIT_LANES shapes laid out as separate
+* arrays. The loops have a fixed trip count and no branches, so the compiler
+* turns each into a few vector instructions.
+******************************************************************************/
+
+#include "shapestore.h"
+
+/*!
+ * @brief A hit test kernel, sets hit[i] to 1 if shape i of the block contains the point
+ */
+typedef void (*HitKernel)(const float *x, const float *y, const float *a, const float *b,
+                          float px, float py, uint8_t *hit);
+
+/** **************************************************************************
+ * @brief Tests a point against a block of lines
+ *
+ * The point is on the line if it is within LINE_PICK pixels of it straight
+ * up or down, which is |w (py - y) - h (px - x)| < LINE_PICK |w|
+ * without dividing by the width, and lies between its two ends along x
+ *
+ * @param[in] x, y - the starts of the lines
+ * @param[in] a, b - the widths and heights of the lines
+ * @param[in] px, py - the point
+ * @param[out] hit - 1 for each line the point is on
+ ******************************************************************************/
+static void hitLines(const float *x, const float *y, const float *a, const float *b,
+                     float px, float py, uint8_t *hit)
+{
+   for (int i = 0; i < HIT_LANES; i++)
+   {
+      float dx = px - x[i];
+      float across = a[i] * (py - y[i]) - b[i] * dx;
+      hit[i] = (fabsf(across) < LINE_PICK * fabsf(a[i])) & (dx * (dx - a[i]) <= 0.0f);
+   }
+}
+
+/** **************************************************************************
+ * @brief Tests a point against a block of rectangles
+ *
+ * The point is inside, edges excluded, if it lies strictly between the two
+ * corners on both axes, i.e. (px - x)(px - x - w) < 0, whichever way the
+ * rectangle was dragged
+ *
+ * @param[in] x, y - the corners the rectangles were dragged from
+ * @param[in] a, b - the widths and heights, may be negative
+ * @param[in] px, py - the point
+ * @param[out] hit - 1 for each rectangle holding the point
+ ******************************************************************************/
+static void hitBoxes(const float *x, const float *y, const float *a, const float *b,
+                     float px, float py, uint8_t *hit)
+{
+   for (int i = 0; i < HIT_LANES; i++)
+   {
+      float dx = px - x[i];
+      float dy = py - y[i];
+      hit[i] = (dx * (dx - a[i]) < 0.0f) & (dy * (dy - b[i]) < 0.0f);
+   }
+}
+
+/** **************************************************************************
+ * @brief Tests a point against a block of circles, edge excluded
+ *
+ * @param[in] x, y - the centers
+ * @param[in] a - the radii
+ * @param[in] b - unused, the same as a
+ * @param[in] px, py - the point
+ * @param[out] hit - 1 for each circle holding the point
+ ******************************************************************************/
+static void hitCircles(const float *x, const float *y, const float *a, const float *b,
+                       float px, float py, uint8_t *hit)
+{
+   for (int i = 0; i < HIT_LANES; i++)
+   {
+      float dx = px - x[i];
+      float dy = py - y[i];
+      hit[i] = dx * dx + dy * dy < a[i] * a[i];
+   }
+}
+
+/** **************************************************************************
+ * @brief Tests a point against a block of ellipses, edge included
+ *
+ * (dx / rx)^2 + (dy / ry)^2 <= 1 multiplied through by (rx ry)^2, so there
+ * is no division
+ *
+ * @param[in] x, y - the centers
+ * @param[in] a, b - the x and y radii
+ * @param[in] px, py - the point
+ * @param[out] hit - 1 for each ellipse holding the point
+ ******************************************************************************/
+static void hitEllipses(const float *x, const float *y, const float *a, const float *b,
+                        float px, float py, uint8_t *hit)
+{
+   for (int i = 0; i < HIT_LANES; i++)
+   {
+      float dx = (px - x[i]) * b[i];
+      float dy = (py - y[i]) * a[i];
+      float r = a[i] * b[i];
+      hit[i] = (dx * dx + dy * dy <= r * r) & (r != 0.0f);
+   }
+}
+
+static const HitKernel kernels[SHAPE_KINDS] = {hitLines, hitBoxes, hitCircles, hitEllipses};
+
+/** **************************************************************************
+ * @brief Stores a shape and gives it a handle
+ *
+ * @param[in,out] shape - the shape, its handle is set
+ *
+ * @returns the handle of the shape
+ ******************************************************************************/
+ShapeHandle ShapeStore::add(Shape *shape)
+{
+   ShapeRecord rec = shape->toRecord();
+   ShapeKind kind = kindOf(rec.type);
+   Columns &c = columns[kind];
+
+   ShapeHandle handle;
+   if (!freed.empty())
+   {
+      handle = freed.back();
+      freed.pop_back();
+   }
+   else
+   {
+      handle = ShapeHandle(slots.size());
+      slots.push_back(Slot());
+   }
+   slots[handle].kind = kind;
+   slots[handle].row = uint32_t(c.x.size());
+
+   c.x.push_back(rec.x);
+   c.y.push_back(rec.y);
+   c.a.push_back(rec.a);
+   c.b.push_back(rec.b);
+   c.border.push_back(rec.border);
+   c.fill.push_back(rec.fill);
+   c.type.push_back(rec.type);
+   c.handle.push_back(handle);
+   shape->setHandle(handle);
+   return handle;
+}
+
+/** **************************************************************************
+ * @brief Stores the current location and size of a shape
+ *
+ * @param[in] shape - a stored shape that moved or changed size
+ ******************************************************************************/
+void ShapeStore::update(Shape *shape)
+{
+   ShapeHandle handle = shape->getHandle();
+   if (handle >= slots.size() || slots[handle].kind == SHAPE_KINDS)
+      return;
+   ShapeRecord rec = shape->toRecord();
+   Columns &c = columns[slots[handle].kind];
+   uint32_t row = slots[handle].row;
+   c.x[row] = rec.x;
+   c.y[row] = rec.y;
+   c.a[row] = rec.a;
+   c.b[row] = rec.b;
+}
+
+/** **************************************************************************
+ * @brief Removes a shape, the last row of its kind takes its place
+ *
+ * @param[in,out] shape - a stored shape, its handle is cleared
+ ******************************************************************************/
+void ShapeStore::remove(Shape *shape)
+{
+   ShapeHandle handle = shape->getHandle();
+   if (handle >= slots.size() || slots[handle].kind == SHAPE_KINDS)
+      return;
+   Columns &c = columns[slots[handle].kind];
+   uint32_t row = slots[handle].row;
+   size_t last = c.x.size() - 1;
+
+   c.x[row] = c.x[last];
+   c.y[row] = c.y[last];
+   c.a[row] = c.a[last];
+   c.b[row] = c.b[last];
+   c.border[row] = c.border[last];
+   c.fill[row] = c.fill[last];
+   c.type[row] = c.type[last];
+   c.handle[row] = c.handle[last];
+   slots[c.handle[row]].row = row;
+
+   c.x.pop_back();
+   c.y.pop_back();
+   c.a.pop_back();
+   c.b.pop_back();
+   c.border.pop_back();
+   c.fill.pop_back();
+   c.type.pop_back();
+   c.handle.pop_back();
+
+   slots[handle].kind = SHAPE_KINDS;
+   freed.push_back(handle);
+   shape->setHandle(NO_SHAPE);
+}
+
+/** **************************************************************************
+ * @brief Removes every shape, the arrays keep their memory
+ *
+ * Handles held by the removed shapes are no longer valid
+ ******************************************************************************/
+void ShapeStore::clear()
+{
+   for (int k = 0; k < SHAPE_KINDS; k++)
+   {
+      Columns &c = columns[k];
+      c.x.clear();
+      c.y.clear();
+      c.a.clear();
+      c.b.clear();
+      c.border.clear();
+      c.fill.clear();
+      c.type.clear();
+      c.handle.clear();
+   }
+   slots.clear();
+   freed.clear();
+}
+
+/** **************************************************************************
+ * @brief Makes room for more shapes, so adding them grows no array
+ *
+ * @param[in] counts - the number of shapes of each kind to be added
+ ******************************************************************************/
+void ShapeStore::reserve(const size_t counts[SHAPE_KINDS])
+{
+   size_t total = 0;
+   for (int k = 0; k < SHAPE_KINDS; k++)
+   {
+      Columns &c = columns[k];
+      size_t rows = c.x.size() + counts[k];
+      c.x.reserve(rows);
+      c.y.reserve(rows);
+      c.a.reserve(rows);
+      c.b.reserve(rows);
+      c.border.reserve(rows);
+      c.fill.reserve(rows);
+      c.type.reserve(rows);
+      c.handle.reserve(rows);
+      total += counts[k];
+   }
+   slots.reserve(slots.size() + total);
+}
+
+/** **************************************************************************
+ * @brief Returns the number of stored shapes
+ ******************************************************************************/
+size_t ShapeStore::size() const
+{
+   size_t count = 0;
+   for (int k = 0; k < SHAPE_KINDS; k++)
+      count += columns[k].x.size();
+   return count;
+}
+
+/** **************************************************************************
+ * @brief Returns a stored shape as plain numbers
+ *
+ * @param[in] handle - the handle of a stored shape
+ ******************************************************************************/
+ShapeRecord ShapeStore::get(ShapeHandle handle) const
+{
+   const Columns &c = columns[slots[handle].kind];
+   uint32_t row = slots[handle].row;
+   ShapeRecord rec = {c.type[row], c.x[row], c.y[row], c.a[row], c.b[row], c.border[row], c.fill[row]};
+   return rec;
+}
+
+/** **************************************************************************
+ * @brief Tests a point against many shapes, of any kinds
+ *
+ * The shapes are gathered by kind into blocks of HIT_LANES and each full
+ * block goes through its kernel, the last block of each kind is padded.
+ * Handles that name no stored shape never hit.
+ *
+ * @param[in] x - the x location of the point
+ * @param[in] y - the y location of the point
+ * @param[in] handles - the shapes to test
+ * @param[in] count - the number of handles
+ * @param[out] hits - set to 1 for each shape containing the point, 0 otherwise
+ ******************************************************************************/
+void ShapeStore::hitTest(int x, int y, const ShapeHandle *handles, size_t count, uint8_t *hits) const
+{
+   /*!
+    * @brief The shapes of one kind waiting for a kernel pass
+    */
+   struct Block
+   {
+      float x[HIT_LANES], y[HIT_LANES], a[HIT_LANES], b[HIT_LANES];
+      size_t index[HIT_LANES];  // where each result goes in hits
+      int used;
+   };
+   Block blocks[SHAPE_KINDS] = {};
+   uint8_t hit[HIT_LANES];
+   float px = float(x), py = float(y);
+
+   auto flush = [&](int kind)
+   {
+      Block &block = blocks[kind];
+      kernels[kind](block.x, block.y, block.a, block.b, px, py, hit);
+      for (int i = 0; i < block.used; i++)
+         hits[block.index[i]] = hit[i];
+      block.used = 0;
+   };
+
+   for (size_t i = 0; i < count; i++)
+   {
+      hits[i] = 0;
+      if (handles[i] >= slots.size() || slots[handles[i]].kind == SHAPE_KINDS)
+         continue;
+      int kind = slots[handles[i]].kind;
+      const Columns &c = columns[kind];
+      uint32_t row = slots[handles[i]].row;
+      Block &block = blocks[kind];
+      block.x[block.used] = c.x[row];
+      block.y[block.used] = c.y[row];
+      block.a[block.used] = c.a[row];
+      block.b[block.used] = c.b[row];
+      block.index[block.used] = i;
+      if (++block.used == HIT_LANES)
+         flush(kind);
+   }
+   for (int k = 0; k < SHAPE_KINDS; k++)
+      if (blocks[k].used != 0)
+         flush(k);
+}
+
+/** **************************************************************************
+ * @brief Tests a point against one shape
+ *
+ * @param[in] handle - the shape, a handle naming no stored shape never hits
+ * @param[in] x - the x location of the point
+ * @param[in] y - the y location of the point
+ ******************************************************************************/
+bool ShapeStore::contains(ShapeHandle handle, int x, int y) const
+{
+   uint8_t hit = 0;
+   hitTest(x, y, &handle, 1, &hit);
+   return hit != 0;
+}
+
+/** **************************************************************************
+ * @brief Finds every stored shape containing a point
+ *
+ * Runs the kernels straight over the arrays, HIT_LANES rows at a time, with
+ * only the last partial block of each kind copied out and padded. The shapes
+ * come back grouped by kind, not in any stacking order.
+ *
+ * @param[in] x - the x location of the point
+ * @param[in] y - the y location of the point
+ * @param[out] found - the handles of the shapes containing the point, replaced
+ ******************************************************************************/
+void ShapeStore::scan(int x, int y, std::vector<ShapeHandle> &found) const
+{
+   float px = float(x), py = float(y);
+   uint8_t hit[HIT_LANES];
+   found.clear();
+   for (int k = 0; k < SHAPE_KINDS; k++)
+   {
+      const Columns &c = columns[k];
+      size_t rows = c.x.size();
+      size_t whole = rows - rows % HIT_LANES;
+      for (size_t row = 0; row < whole; row += HIT_LANES)
+      {
+         kernels[k](&c.x[row], &c.y[row], &c.a[row], &c.b[row], px, py, hit);
+         for (int i = 0; i < HIT_LANES; i++)
+            if (hit[i])
+               found.push_back(c.handle[row + i]);
+      }
+      if (whole == rows)
+         continue;
+
+      float tail[4][HIT_LANES] = {};
+      for (size_t row = whole; row < rows; row++)
+      {
+         tail[0][row - whole] = c.x[row];
+         tail[1][row - whole] = c.y[row];
+         tail[2][row - whole] = c.a[row];
+         tail[3][row - whole] = c.b[row];
+      }
+      kernels[k](tail[0], tail[1], tail[2], tail[3], px, py, hit);
+      for (size_t row = whole; row < rows; row++)
+         if (hit[row - whole])
+            found.push_back(c.handle[row]);
+   }
+}
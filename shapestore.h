@@ -0,0 +1,73 @@
+/** ***************************************************************************
+* @file
+* @brief Header file that holds the ShapeStore class, the shapes of the
+* document kept as plain numbers in one set of arrays per kind of outline,
+* and tested against a point a block of shapes at a time
+******************************************************************************/
+
+#ifndef __SHAPESTORE_H
+#define __SHAPESTORE_H
+
+#include <vector>
+#include "shape.h"
+
+const int HIT_LANES = 8;        /*!< shapes tested against a point by one pass of a kernel */
+const float LINE_PICK = 8.0f;   /*!< a line is picked less than this many pixels above or below it */
+
+/*!
+ * @brief ShapeStore class, a structure of arrays holding every shape of the document
+ *
+ * Each kind of outline has its own arrays, so a hit test kernel reads one
+ * kind of shape from contiguous memory and works on HIT_LANES shapes with
+ * the same instructions. The kernels use no division, pow() or rounding to
+ * int.
+ *
+ * A shape is named by a handle that stays the same while it is stored. Rows
+ * are kept packed, removing a shape moves the last row of its kind into its
+ * place, and the handle table follows the move. Handles of removed shapes
+ * are given out again.
+ */
+class ShapeStore
+{
+    /*!
+     * @brief The stored shapes of one kind, one array per field
+     */
+    struct Columns
+    {
+        std::vector<float> x;               /*!< the x locations */
+        std::vector<float> y;               /*!< the y locations */
+        std::vector<float> a;               /*!< the x extents, width or radius */
+        std::vector<float> b;               /*!< the y extents, height or radius */
+        std::vector<uint32_t> border;       /*!< the packed border colors */
+        std::vector<uint32_t> fill;         /*!< the packed fill colors */
+        std::vector<ShapeType> type;        /*!< the concrete classes */
+        std::vector<ShapeHandle> handle;    /*!< the handle naming each row */
+    };
+
+    /*!
+     * @brief Where the shape a handle names is stored
+     */
+    struct Slot
+    {
+        ShapeKind kind;     /*!< the arrays it is in, SHAPE_KINDS if the handle is free */
+        uint32_t row;       /*!< its row in them */
+    };
+
+    Columns columns[SHAPE_KINDS];       /*!< the shapes, by kind */
+    std::vector<Slot> slots;            /*!< the row of each handle */
+    std::vector<ShapeHandle> freed;     /*!< handles to give out again */
+public:
+    ShapeHandle add(Shape *shape);      // stores a shape and gives it a handle
+    void update(Shape *shape);          // stores the current location and size of a shape
+    void remove(Shape *shape);          // removes a shape, its handle is freed
+    void clear();                       // removes every shape, keeps the memory
+    void reserve(const size_t counts[SHAPE_KINDS]);    // makes room for more shapes of each kind
+    size_t size() const;                // returns the number of stored shapes
+    ShapeRecord get(ShapeHandle handle) const;   // returns a stored shape as plain numbers
+    // tests a point against many shapes, hits[i] is set to 1 if handles[i] contains it
+    void hitTest(int x, int y, const ShapeHandle *handles, size_t count, uint8_t *hits) const;
+    bool contains(ShapeHandle handle, int x, int y) const;  // tests a point against one shape
+    void scan(int x, int y, std::vector<ShapeHandle> &found) const;    // finds every stored shape containing a point
+};
+
+#endif
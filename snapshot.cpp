@@ -0,0 +1,238 @@
+/** ***************************************************************************
+* @file
+* @brief Cpp file including functions for the snapshot.h, holds the functions
+* which change the shared tree of records and take snapshots of it
+******************************************************************************/
+
+#include <algorithm>
+#include "snapshot.h"
+#include "stats.h"
+
+/** **************************************************************************
+ * @brief Returns a copy of the branch, sharing its children
+ ******************************************************************************/
+std::shared_ptr<SnapshotNode> SnapshotBranch::copy() const
+{
+   return std::make_shared<SnapshotBranch>(*this);
+}
+
+/** **************************************************************************
+ * @brief Returns the size of a branch in bytes
+ ******************************************************************************/
+size_t SnapshotBranch::bytes() const
+{
+   return sizeof(SnapshotBranch);
+}
+
+/** **************************************************************************
+ * @brief Returns a copy of the leaf
+ ******************************************************************************/
+std::shared_ptr<SnapshotNode> SnapshotLeaf::copy() const
+{
+   return std::make_shared<SnapshotLeaf>(*this);
+}
+
+/** **************************************************************************
+ * @brief Returns the size of a leaf in bytes
+ ******************************************************************************/
+size_t SnapshotLeaf::bytes() const
+{
+   return sizeof(SnapshotLeaf);
+}
+
+/** **************************************************************************
+ * @brief Returns the number of shapes in the snapshot
+ ******************************************************************************/
+size_t SceneSnapshot::size() const
+{
+   return count;
+}
+
+/** **************************************************************************
+ * @brief Returns the shapes of the snapshot in drawing order
+ *
+ * The tree is keyed by handle, so the shapes are sorted by depth here, on
+ * the thread using the snapshot
+ *
+ * @param[out] out - the shapes, back to front
+ ******************************************************************************/
+void SceneSnapshot::ordered(std::vector<ShapeRecord> &out) const
+{
+   std::vector<const SnapshotEntry *> entries;
+   entries.reserve(count);
+   forEach([&](ShapeHandle, const SnapshotEntry &entry) { entries.push_back(&entry); });
+   std::sort(entries.begin(), entries.end(),
+             [](const SnapshotEntry *a, const SnapshotEntry *b) { return a->depth < b->depth; });
+   out.clear();
+   out.reserve(entries.size());
+   for (const SnapshotEntry *entry : entries)
+      out.push_back(entry->record);
+}
+
+/** **************************************************************************
+ * @brief Returns the entries of every shape, sorted back to front
+ *
+ * @param[out] out - the entries, with their depths
+ ******************************************************************************/
+void SceneSnapshot::ordered(std::vector<SnapshotEntry> &out) const
+{
+   out.clear();
+   out.reserve(count);
+   forEach([&](ShapeHandle, const SnapshotEntry &entry) { out.push_back(entry); });
+   std::sort(out.begin(), out.end(),
+             [](const SnapshotEntry &a, const SnapshotEntry &b) { return a.depth < b.depth; });
+}
+
+/** **************************************************************************
+ * @brief Returns the entry of a handle, ready to be changed
+ *
+ * Grows the tree if the handle is past it. Every node on the way down that a
+ * snapshot still holds is replaced by a copy first, missing nodes are made.
+ *
+ * @param[in] handle - the shape store handle
+ ******************************************************************************/
+SnapshotEntry &SharedScene::entry(ShapeHandle handle)
+{
+   if (root == nullptr)
+   {
+      root = std::make_shared<SnapshotLeaf>();
+      shift = 0;
+   }
+   while (uint64_t(handle) >= (uint64_t(SNAPSHOT_FANOUT) << shift))
+   {
+      std::shared_ptr<SnapshotBranch> taller = std::make_shared<SnapshotBranch>();
+      taller->children[0] = root;
+      root = taller;
+      shift += SNAPSHOT_BITS;
+   }
+
+   std::shared_ptr<SnapshotNode> *at = &root;
+   for (int level = shift; ; level -= SNAPSHOT_BITS)
+   {
+      if (*at == nullptr)
+      {
+         if (level == 0)
+            *at = std::make_shared<SnapshotLeaf>();
+         else
+            *at = std::make_shared<SnapshotBranch>();
+      }
+      else if (at->use_count() > 1)   // a snapshot holds it, leave it as it is
+         *at = (*at)->copy();
+      uint32_t index = (handle >> level) & (SNAPSHOT_FANOUT - 1);
+      if (level == 0)
+         return static_cast<SnapshotLeaf &>(**at).entries[index];
+      at = &static_cast<SnapshotBranch &>(**at).children[index];
+   }
+}
+
+/** **************************************************************************
+ * @brief Adds a shape to the tree
+ *
+ * @param[in] handle - its handle in the shape store
+ * @param[in] record - the shape as plain numbers
+ * @param[in] depth - its depth in the drawing order
+ ******************************************************************************/
+void SharedScene::put(ShapeHandle handle, const ShapeRecord &record, long long depth)
+{
+   SnapshotEntry &at = entry(handle);
+   if (!at.present)
+      count++;
+   at.record = record;
+   at.depth = depth;
+   at.present = true;
+}
+
+/** **************************************************************************
+ * @brief Stores where a shape in the tree is now
+ *
+ * @param[in] handle - its handle in the shape store
+ * @param[in] record - the shape as plain numbers
+ ******************************************************************************/
+void SharedScene::update(ShapeHandle handle, const ShapeRecord &record)
+{
+   entry(handle).record = record;
+}
+
+/** **************************************************************************
+ * @brief Stores the new depth of a shape in the tree
+ *
+ * @param[in] handle - its handle in the shape store
+ * @param[in] depth - its depth in the drawing order
+ ******************************************************************************/
+void SharedScene::restack(ShapeHandle handle, long long depth)
+{
+   entry(handle).depth = depth;
+}
+
+/** **************************************************************************
+ * @brief Removes a shape from the tree, its nodes stay for the next shape
+ * given the handle
+ *
+ * @param[in] handle - its handle in the shape store
+ ******************************************************************************/
+void SharedScene::erase(ShapeHandle handle)
+{
+   SnapshotEntry &at = entry(handle);
+   if (at.present)
+      count--;
+   at.present = false;
+}
+
+/** **************************************************************************
+ * @brief Returns the number of shapes in the tree
+ ******************************************************************************/
+size_t SharedScene::size() const
+{
+   return count;
+}
+
+/** **************************************************************************
+ * @brief Returns a snapshot of the shapes as they are now
+ *
+ * Only the root is shared, nothing is copied
+ ******************************************************************************/
+SceneSnapshot SharedScene::snapshot() const
+{
+   SceneSnapshot snap;
+   snap.root = root;
+   snap.shift = shift;
+   snap.count = count;
+   stats().snapshotsTaken.fetch_add(1, std::memory_order_relaxed);
+   return snap;
+}
+
+/** **************************************************************************
+ * @brief Returns the bytes of the nodes a snapshot keeps alive that the tree
+ * has since replaced
+ *
+ * The snapshot and the tree are walked side by side, a node they share is
+ * not walked into, so this costs as much as the edits made since the
+ * snapshot was taken
+ *
+ * @param[in] snap - a snapshot taken of this tree
+ ******************************************************************************/
+size_t SharedScene::retained(const SceneSnapshot &snap) const
+{
+   struct Walk
+   {
+      static size_t apart(const SnapshotNode *old, const SnapshotNode *now, int level)
+      {
+         if (old == nullptr || old == now)
+            return 0;
+         size_t bytes = old->bytes();
+         if (level == 0)
+            return bytes;
+         const SnapshotBranch *oldBranch = static_cast<const SnapshotBranch *>(old);
+         const SnapshotBranch *nowBranch = static_cast<const SnapshotBranch *>(now);
+         for (uint32_t i = 0; i < SNAPSHOT_FANOUT; i++)
+            bytes += apart(oldBranch->children[i].get(),
+                           nowBranch == nullptr ? nullptr : nowBranch->children[i].get(),
+                           level - SNAPSHOT_BITS);
+         return bytes;
+      }
+   };
+   const SnapshotNode *now = root.get();
+   for (int level = shift; level > snap.shift; level -= SNAPSHOT_BITS)   // the tree grew since
+      now = now == nullptr ? nullptr : static_cast<const SnapshotBranch *>(now)->children[0].get();
+   return Walk::apart(snap.root.get(), now, snap.shift);
+}
@@ -0,0 +1,149 @@
+/** ***************************************************************************
+* @file
+* @brief Header file that holds the SharedScene class, the shapes of the
+* document as plain records in a tree whose nodes are shared with the
+* snapshots taken of it, and the SceneSnapshot class, one such snapshot
+******************************************************************************/
+
+#ifndef __SNAPSHOT_H
+#define __SNAPSHOT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "shape.h"
+
+const int SNAPSHOT_BITS = 5;                            /*!< bits of a handle each level of the tree takes */
+const uint32_t SNAPSHOT_FANOUT = 1u << SNAPSHOT_BITS;   /*!< children of a branch, entries of a leaf */
+
+/*!
+ * @brief SnapshotEntry struct, a shape as the tree holds it
+ */
+struct SnapshotEntry
+{
+    ShapeRecord record;         /*!< the shape as plain numbers */
+    long long depth = 0;        /*!< its depth in the drawing order, larger is in front */
+    bool present = false;       /*!< set if a shape has the handle of the entry */
+};
+
+/*!
+ * @brief SnapshotNode struct, a branch or a leaf of the tree, which one is
+ * known from its level
+ */
+struct SnapshotNode
+{
+    virtual ~SnapshotNode() {}
+    virtual std::shared_ptr<SnapshotNode> copy() const = 0;    // returns a copy to be changed
+    virtual size_t bytes() const = 0;                           // returns the size of the node
+};
+
+/*!
+ * @brief SnapshotBranch struct, the nodes one level down
+ */
+struct SnapshotBranch : SnapshotNode
+{
+    std::shared_ptr<SnapshotNode> children[SNAPSHOT_FANOUT];   /*!< nullptr where no handle was used yet */
+
+    std::shared_ptr<SnapshotNode> copy() const;
+    size_t bytes() const;
+};
+
+/*!
+ * @brief SnapshotLeaf struct, the shapes of SNAPSHOT_FANOUT handles in a row
+ */
+struct SnapshotLeaf : SnapshotNode
+{
+    SnapshotEntry entries[SNAPSHOT_FANOUT];     /*!< the shape of each handle */
+
+    std::shared_ptr<SnapshotNode> copy() const;
+    size_t bytes() const;
+};
+
+/*!
+ * @brief SceneSnapshot class, the shapes as they were when it was taken
+ *
+ * It holds the root of the tree at that time, the nodes are never changed
+ * once a snapshot holds them, so it can be read on any thread, for as long
+ * as it is kept, without a lock, while the document keeps changing.
+ */
+class SceneSnapshot
+{
+    std::shared_ptr<const SnapshotNode> root;   /*!< the tree, nullptr if it was empty */
+    int shift = 0;                              /*!< handle bits below the root */
+    size_t count = 0;                           /*!< shapes in the tree */
+
+    template <typename Visit>
+    static void walk(const SnapshotNode *node, int shift, ShapeHandle first, Visit &visit);
+    friend class SharedScene;
+public:
+    size_t size() const;                                // returns the number of shapes
+    void ordered(std::vector<ShapeRecord> &out) const;  // returns the shapes back to front
+    void ordered(std::vector<SnapshotEntry> &out) const;    // returns the shapes back to front with their depths
+
+    /// calls visit with every shape entry, in handle order
+    template <typename Visit>
+    void forEach(Visit visit) const
+    {
+        if (root != nullptr)
+            walk(root.get(), shift, 0, visit);
+    }
+};
+
+/*!
+ * @brief SharedScene class, the shapes on the canvas as plain records, keyed
+ * by their shape store handle
+ *
+ * The records are kept in a tree of SNAPSHOT_FANOUT wide nodes over the bits
+ * of the handle. Handles are reused, so the tree stays as large as the most
+ * shapes stored at once. A snapshot only copies the root pointer. A node held
+ * by a snapshot is copied before it is changed, and its copy replaces it
+ * along the path from the root, so an edit after a snapshot copies one node
+ * per level and every other node stays shared. Nodes held by the tree alone
+ * are changed in place.
+ *
+ * Only the thread that owns the document changes it or takes snapshots.
+ */
+class SharedScene
+{
+    std::shared_ptr<SnapshotNode> root;     /*!< the tree, nullptr while empty */
+    int shift = 0;                          /*!< handle bits below the root */
+    size_t count = 0;                       /*!< shapes in the tree */
+
+    SnapshotEntry &entry(ShapeHandle handle);   // returns the entry of a handle, owned by the tree alone
+public:
+    void put(ShapeHandle handle, const ShapeRecord &record, long long depth);  // adds a shape
+    void update(ShapeHandle handle, const ShapeRecord &record);    // stores where a shape is now
+    void restack(ShapeHandle handle, long long depth);             // stores a new depth of a shape
+    void erase(ShapeHandle handle);                                 // removes a shape
+    size_t size() const;                                            // returns the number of shapes
+    SceneSnapshot snapshot() const;                                 // returns the shapes as they are now
+    size_t retained(const SceneSnapshot &snap) const;  // returns the bytes a snapshot keeps that the tree no longer uses
+};
+
+/** **************************************************************************
+ * @brief Calls a function with every present entry below a node
+ *
+ * @param[in] node - the node
+ * @param[in] shift - handle bits below it, 0 for a leaf
+ * @param[in] first - the handle of its first entry
+ * @param[in,out] visit - called with the handle and the entry
+ ******************************************************************************/
+template <typename Visit>
+void SceneSnapshot::walk(const SnapshotNode *node, int shift, ShapeHandle first, Visit &visit)
+{
+    if (shift == 0)
+    {
+        const SnapshotLeaf *leaf = static_cast<const SnapshotLeaf *>(node);
+        for (uint32_t i = 0; i < SNAPSHOT_FANOUT; i++)
+            if (leaf->entries[i].present)
+                visit(ShapeHandle(first + i), leaf->entries[i]);
+        return;
+    }
+    const SnapshotBranch *branch = static_cast<const SnapshotBranch *>(node);
+    for (uint32_t i = 0; i < SNAPSHOT_FANOUT; i++)
+        if (branch->children[i] != nullptr)
+            walk(branch->children[i].get(), shift - SNAPSHOT_BITS, ShapeHandle(first + (i << shift)), visit);
+}
+
+#endif
@@ -0,0 +1,67 @@
+/** ***************************************************************************
+* @file
+* @brief Header file that holds the SpscRing class, a fixed size lock-free queue
+* for exactly one producer thread and one consumer thread
+******************************************************************************/
+
+#ifndef __SPSC_H
+#define __SPSC_H
+
+#include <atomic>
+#include <cstddef>
+
+/*!
+ * @brief SpscRing class, a bounded single-producer/single-consumer ring buffer
+ *
+ * The producer only writes tail and the consumer only writes head, so neither
+ * side ever waits on a lock. N must be a power of two.
+ */
+template <typename T, size_t N>
+class SpscRing
+{
+    static_assert((N & (N - 1)) == 0, "SpscRing size must be a power of two");
+
+    alignas(64) std::atomic<size_t> head{0};   /*!< next slot to read, written by the consumer */
+    alignas(64) std::atomic<size_t> tail{0};   /*!< next slot to write, written by the producer */
+    alignas(64) T slots[N];                     /*!< the queued items */
+public:
+    /*!
+     * @brief Adds an item to the ring, producer thread only
+     * @param[in] item - the item to add
+     * @returns false if the ring is full
+     */
+    bool push(const T &item)
+    {
+        size_t t = tail.load(std::memory_order_relaxed);
+        if (t - head.load(std::memory_order_acquire) == N)
+            return false;
+        slots[t & (N - 1)] = item;
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    /*!
+     * @brief Removes the oldest item from the ring, consumer thread only
+     * @param[out] item - the removed item
+     * @returns false if the ring is empty
+     */
+    bool pop(T &item)
+    {
+        size_t h = head.load(std::memory_order_relaxed);
+        if (h == tail.load(std::memory_order_acquire))
+            return false;
+        item = slots[h & (N - 1)];
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+    /*!
+     * @brief Returns whether the ring currently holds no items
+     */
+    bool empty() const
+    {
+        return head.load(std::memory_order_acquire) == tail.load(std::memory_order_acquire);
+    }
+};
+
+#endif
@@ -0,0 +1,141 @@
+/** ***************************************************************************
+* @file
+* @brief Cpp file including functions for the stats.h, holds the program wide
+* counters and the replacement global operator new/delete that count every heap
+* allocation so allocation free code paths can be checked
+******************************************************************************/
+
+#include <cstdlib>
+#include <new>
+#include "stats.h"
+#include "autosave.h"
+
+/** **************************************************************************
+ * @brief Returns the program wide counters
+ *
+ * The counters are a function local static so they are ready before the first
+ * allocation made during static initialization
+ ******************************************************************************/
+Stats &stats()
+{
+   static Stats counters;
+   return counters;
+}
+
+/** **************************************************************************
+ * @brief Prints the program wide counters
+ *
+ * @param[in,out] out - the stream the counters are written to
+ ******************************************************************************/
+void reportStats(std::ostream &out)
+{
+   Stats &s = stats();
+   unsigned long events = s.eventsDispatched;
+   unsigned long allocations = s.heapAllocations;
+   unsigned long frames = s.framesRendered;
+
+   out << "events dispatched:   " << events << "\n"
+       << "heap allocations:    " << allocations << "\n"
+       << "heap frees:          " << s.heapFrees << "\n"
+       << "heap bytes:          " << s.heapBytes << "\n"
+       << "motion received:     " << s.motionReceived << "\n"
+       << "motion dropped:      " << s.motionDropped << "\n"
+       << "frames rendered:     " << frames << "\n"
+       << "frames presented:    " << s.framesPresented << "\n"
+       << "pixels presented:    " << s.pixelsPresented << "\n"
+       << "draw calls:          " << s.drawCalls << "\n"
+       << "tessellations:       " << s.tessellations << "\n"
+       << "layer bakes:         " << s.layerBakes << "\n"
+       << "shapes live / peak:  " << s.shapesLive << " / " << s.shapesPeak << "\n"
+       << "shape arena bytes:   " << s.shapeBytes << " slots + " << s.shapeHeapBytes << " outlines\n"
+       << "undo steps / bytes:  " << s.undoSteps << " / " << s.undoBytes << "\n"
+       << "snapshots taken:     " << s.snapshotsTaken << "\n";
+   if (s.autosaveSnapshots != 0)
+   {
+      // the log records of the changes are what had to be written, the rest is amplification
+      unsigned long changes = s.autosaveChanges;
+      unsigned long written = s.autosaveLogBytes + s.autosaveSceneBytes;
+      out << "autosave changes:    " << changes << " in " << s.autosaveSyncs << " flushes\n"
+          << "autosave bytes:      " << s.autosaveLogBytes << " log, " << s.autosaveSceneBytes << " in "
+          << s.autosaveSnapshots << " snapshots\n";
+      if (changes != 0)
+         out << "write amplification: " << double(written) / double(changes * sizeof(ChangeRecord)) << "\n";
+   }
+   if (events != 0)
+      out << "allocations / event: " << double(allocations) / double(events) << "\n";
+   if (frames != 0)
+      out << "events / frame:      " << double(events) / double(frames) << "\n";
+   if (s.framesPresented != 0)
+   {
+      out << "draw calls / frame:  " << double(s.drawCalls) / double(s.framesPresented) << "\n";
+      out << "pixels / frame:      " << double(s.pixelsPresented) / double(s.framesPresented) << "\n";
+   }
+}
+
+/** **************************************************************************
+ * @brief Counting replacement for the global operator new
+ *
+ * @param[in] size - the number of bytes requested
+ ******************************************************************************/
+void *operator new(std::size_t size)
+{
+   stats().heapAllocations.fetch_add(1, std::memory_order_relaxed);
+   stats().heapBytes.fetch_add(size, std::memory_order_relaxed);
+   void *block = std::malloc(size == 0 ? 1 : size);
+   if (block == nullptr)
+      throw std::bad_alloc();
+   return block;
+}
+
+/** **************************************************************************
+ * @brief Counting replacement for the global array operator new
+ *
+ * @param[in] size - the number of bytes requested
+ ******************************************************************************/
+void *operator new[](std::size_t size)
+{
+   return operator new(size);
+}
+
+/** **************************************************************************
+ * @brief Counting replacement for the global operator delete
+ *
+ * @param[in] block - the memory being released
+ ******************************************************************************/
+void operator delete(void *block) noexcept
+{
+   if (block == nullptr)
+      return;
+   stats().heapFrees.fetch_add(1, std::memory_order_relaxed);
+   std::free(block);
+}
+
+/** **************************************************************************
+ * @brief Counting replacement for the global array operator delete
+ *
+ * @param[in] block - the memory being released
+ ******************************************************************************/
+void operator delete[](void *block) noexcept
+{
+   operator delete(block);
+}
+
+/** **************************************************************************
+ * @brief Counting replacement for the global sized operator delete
+ *
+ * @param[in] block - the memory being released
+ ******************************************************************************/
+void operator delete(void *block, std::size_t) noexcept
+{
+   operator delete(block);
+}
+
+/** **************************************************************************
+ * @brief Counting replacement for the global sized array operator delete
+ *
+ * @param[in] block - the memory being released
+ ******************************************************************************/
+void operator delete[](void *block, std::size_t) noexcept
+{
+   operator delete(block);
+}
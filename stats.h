@@ -0,0 +1,47 @@
+/** ***************************************************************************
+* @file
+* @brief Header file that holds the program wide counters used to measure how
+* the paint program behaves while it runs (allocations, dispatched events)
+******************************************************************************/
+
+#ifndef __STATS_H
+#define __STATS_H
+
+#include <atomic>
+#include <iostream>
+
+/*!
+ * @brief Stats struct, holds counters that are updated from anywhere in the program
+ */
+struct Stats
+{
+    std::atomic<unsigned long> heapAllocations{0};  /*!< number of calls to operator new */
+    std::atomic<unsigned long> heapFrees{0};        /*!< number of calls to operator delete */
+    std::atomic<unsigned long> heapBytes{0};        /*!< total bytes requested from operator new */
+    std::atomic<unsigned long> eventsDispatched{0}; /*!< number of events routed through utilityCentral */
+    std::atomic<unsigned long> motionReceived{0};   /*!< number of drag/move callbacks received from glut */
+    std::atomic<unsigned long> motionDropped{0};    /*!< number of drag/move events replaced by a newer one */
+    std::atomic<unsigned long> framesRendered{0};   /*!< number of frames recorded by the frame scheduler */
+    std::atomic<unsigned long> framesPresented{0};  /*!< number of frames drawn to the window */
+    std::atomic<unsigned long> pixelsPresented{0};  /*!< number of window pixels the presented frames redrew */
+    std::atomic<unsigned long> tessellations{0};    /*!< number of times a shape built its outline */
+    std::atomic<unsigned long> layerBakes{0};       /*!< number of times the static layer was rendered offscreen */
+    std::atomic<unsigned long> drawCalls{0};        /*!< number of glDrawArrays or glBegin/glEnd calls made */
+    std::atomic<unsigned long> shapesLive{0};       /*!< number of shapes in the shape arena now */
+    std::atomic<unsigned long> shapesPeak{0};       /*!< the most shapes the shape arena held at once */
+    std::atomic<unsigned long> shapeBytes{0};       /*!< bytes the shape arena allocated for its slots */
+    std::atomic<unsigned long> shapeHeapBytes{0};   /*!< bytes the live shapes hold outside the arena */
+    std::atomic<unsigned long> undoSteps{0};        /*!< number of commands the history keeps */
+    std::atomic<unsigned long> undoBytes{0};        /*!< bytes the commands in the history keep alive */
+    std::atomic<unsigned long> snapshotsTaken{0};   /*!< number of snapshots taken of the shapes */
+    std::atomic<unsigned long> autosaveChanges{0};  /*!< number of changes queued for the autosave log */
+    std::atomic<unsigned long> autosaveLogBytes{0}; /*!< bytes written to autosave logs */
+    std::atomic<unsigned long> autosaveSceneBytes{0};   /*!< bytes written to autosave scene files */
+    std::atomic<unsigned long> autosaveSnapshots{0};    /*!< number of autosave scene files written */
+    std::atomic<unsigned long> autosaveSyncs{0};    /*!< number of batches appended and flushed to the log */
+};
+
+Stats &stats();                         // returns the program wide counters
+void reportStats(std::ostream &out);    // prints the counters to the given stream
+
+#endif
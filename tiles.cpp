@@ -0,0 +1,210 @@
+/** ***************************************************************************
+* @file
+* @brief Cpp file including functions for the tiles.h, holds the thread pool
+* that bins a render list into tiles and rasterizes the tiles in parallel
+******************************************************************************/
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include "tiles.h"
+
+using std::chrono::steady_clock;
+
+/** **************************************************************************
+ * @brief Constructor, starts the helper threads, which sleep until a render
+ *
+ * @param[in] count - the threads to draw with, the caller included, at least 1
+ ******************************************************************************/
+TileRenderer::TileRenderer(unsigned count)
+{
+   count = std::max(count, 1u);
+   runs.reset(new Run[count]);
+   work.reset(new Work[count]);
+   for (unsigned i = 1; i < count; i++)
+      threads.emplace_back(&TileRenderer::helper, this, i);
+}
+
+/** **************************************************************************
+ * @brief Destructor, ends the helper threads
+ ******************************************************************************/
+TileRenderer::~TileRenderer()
+{
+   {
+      std::lock_guard<std::mutex> guard(lock);
+      stopping = true;
+   }
+   wake.notify_all();
+   for (std::thread &thread : threads)
+      thread.join();
+}
+
+/** **************************************************************************
+ * @brief Returns the number of threads drawing, the caller of render included
+ ******************************************************************************/
+unsigned TileRenderer::size() const
+{
+   return unsigned(threads.size()) + 1;
+}
+
+/** **************************************************************************
+ * @brief Draws a render list into an image, split into tiles drawn in parallel
+ *
+ * Gives the same pixels as drawing the list straight into the image, the
+ * primitives of each tile are drawn in recording order. Returns once every
+ * tile is drawn.
+ *
+ * @param[in] drawing - the recorded drawing, in image pixels
+ * @param[in,out] target - the image, placed at 0, 0, its pixels no primitive
+ *                         covers are kept
+ ******************************************************************************/
+void TileRenderer::render(const RenderList &drawing, Framebuffer &target)
+{
+   steady_clock::time_point start = steady_clock::now();
+   list = &drawing;
+   image = &target;
+   across = (target.width() + TILE_SIZE - 1) / TILE_SIZE;
+   down = (target.height() + TILE_SIZE - 1) / TILE_SIZE;
+   size_t tiles = size_t(across) * down;
+   bins.resize(tiles);
+   for (std::vector<unsigned> &tile : bins)
+      tile.clear();   // keeps the memory for the next render
+   bin();
+   std::chrono::duration<double, std::milli> binned = steady_clock::now() - start;
+   binning = binned.count();
+
+   times.assign(tiles, 0.0f);
+   unsigned count = size();
+   for (unsigned t = 0; t < count; t++)
+   {
+      runs[t].next.store(tiles * t / count, std::memory_order_relaxed);
+      runs[t].end = tiles * (t + 1) / count;
+      work[t] = Work();
+   }
+   {
+      std::lock_guard<std::mutex> guard(lock);
+      generation++;
+      finished = 0;
+   }
+   wake.notify_all();
+   drawTiles(0);
+   {
+      std::unique_lock<std::mutex> guard(lock);
+      done.wait(guard, [this] { return finished == threads.size(); });
+   }
+
+   std::chrono::duration<double, std::milli> total = steady_clock::now() - start;
+   elapsed = total.count();
+}
+
+/** **************************************************************************
+ * @brief Adds every primitive of the list to the bins of the tiles its
+ * bounds overlap, in recording order
+ ******************************************************************************/
+void TileRenderer::bin()
+{
+   const int width = image->width();
+   const int height = image->height();
+   for (unsigned p = 0; p < list->primitives(); p++)
+   {
+      Box box = list->bounds(p);
+      if (box.right < 0 || box.top < 0 || box.left >= width || box.bottom >= height)
+         continue;
+      int left = std::max(box.left, 0) / TILE_SIZE;
+      int right = std::min(box.right, width - 1) / TILE_SIZE;
+      int bottom = std::max(box.bottom, 0) / TILE_SIZE;
+      int top = std::min(box.top, height - 1) / TILE_SIZE;
+      for (int y = bottom; y <= top; y++)
+         for (int x = left; x <= right; x++)
+            bins[size_t(y) * across + x].push_back(p);
+   }
+}
+
+/** **************************************************************************
+ * @brief Draws tiles until there are none left, its own run first, then
+ * whatever is left of the others
+ *
+ * Each tile is read from the image into a framebuffer placed over it, drawn
+ * and written back. Tiles nothing overlaps keep the pixels of the image.
+ *
+ * @param[in] thread - the number of the calling thread, 0 for the caller of render
+ ******************************************************************************/
+void TileRenderer::drawTiles(unsigned thread)
+{
+   Framebuffer tile(TILE_SIZE, TILE_SIZE);
+   Work &mine = work[thread];
+   unsigned count = size();
+   for (unsigned k = 0; k < count; k++)
+   {
+      Run &run = runs[(thread + k) % count];
+      for (size_t t = run.next.fetch_add(1, std::memory_order_relaxed); t < run.end;
+           t = run.next.fetch_add(1, std::memory_order_relaxed))
+      {
+         if (bins[t].empty())
+            continue;
+         steady_clock::time_point start = steady_clock::now();
+         tile.place(int(t % across) * TILE_SIZE, int(t / across) * TILE_SIZE);
+         tile.load(*image);
+         for (unsigned p : bins[t])
+            list->rasterize(p, tile);
+         tile.store(*image);
+         std::chrono::duration<double, std::micro> spent = steady_clock::now() - start;
+         times[t] = float(spent.count());
+         mine.tiles++;
+         mine.stolen += k != 0;
+         mine.busy += spent.count();
+      }
+   }
+}
+
+/** **************************************************************************
+ * @brief The body of a helper thread, draws tiles for every render until the
+ * pool is stopped
+ *
+ * @param[in] thread - the number of the thread, from 1
+ ******************************************************************************/
+void TileRenderer::helper(unsigned thread)
+{
+   unsigned seen = 0;
+   std::unique_lock<std::mutex> guard(lock);
+   while (true)
+   {
+      wake.wait(guard, [&] { return stopping || generation != seen; });
+      if (stopping)
+         return;
+      seen = generation;
+      guard.unlock();
+      drawTiles(thread);
+      guard.lock();
+      if (++finished == threads.size())
+         done.notify_one();
+   }
+}
+
+/** **************************************************************************
+ * @brief Prints how long the last render took, what each thread did and
+ * the tiles that took longest
+ *
+ * @param[in,out] out - the stream to print to
+ * @param[in] hottest - the number of tiles to list
+ ******************************************************************************/
+void TileRenderer::report(std::ostream &out, size_t hottest) const
+{
+   out << std::fixed << std::setprecision(2)
+       << "rendered " << across << " x " << down << " tiles of " << TILE_SIZE << " pixels on "
+       << size() << " threads in " << elapsed << " ms (binning " << binning << " ms)\n";
+   for (unsigned t = 0; t < size(); t++)
+      out << "  thread " << t << ": " << work[t].tiles << " tiles, " << work[t].stolen
+          << " stolen, busy " << work[t].busy / 1000.0 << " ms\n";
+
+   std::vector<size_t> order(times.size());
+   for (size_t t = 0; t < order.size(); t++)
+      order[t] = t;
+   hottest = std::min(hottest, order.size());
+   std::partial_sort(order.begin(), order.begin() + hottest, order.end(),
+                     [this](size_t a, size_t b) { return times[a] > times[b]; });
+   out << "hottest tiles (column, row from the bottom left):\n";
+   for (size_t i = 0; i < hottest && times[order[i]] > 0; i++)
+      out << "  (" << order[i] % across << ", " << order[i] / across << "): "
+          << bins[order[i]].size() << " primitives, " << times[order[i]] << " us\n";
+}
@@ -0,0 +1,95 @@
+/** ***************************************************************************
+* @file
+* @brief Header file that holds the TileRenderer class, which splits an image
+* into tiles and rasterizes them in software on a pool of threads
+******************************************************************************/
+
+#ifndef __TILES_H
+#define __TILES_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <thread>
+#include <vector>
+#include "renderlist.h"
+#include "raster.h"
+
+const int TILE_SIZE = 64;       /*!< the width and height of a tile in pixels, 16 KB of pixels */
+
+/*!
+ * @brief TileRenderer class, rasterizes a render list into an image one tile
+ * at a time, on every core
+ *
+ * The primitives of the list are first binned: each is added to every tile
+ * its bounds overlap, in recording order, so a tile draws only the
+ * primitives that can touch it and draws them back to front. The tiles share
+ * no pixels, each is drawn into a tile sized framebuffer that stays in cache
+ * and then copied into the image, so the threads never wait for each other.
+ *
+ * The tiles are dealt out to the threads in runs of neighbours. A thread
+ * that finishes its run steals the next tile of another run, so a few busy
+ * tiles, i.e. under a pile of shapes, do not hold up the whole image. The
+ * thread calling render works as one of the threads.
+ *
+ * The time each tile took is kept until the next render and reported, so
+ * the tiles that are hot stand out.
+ */
+class TileRenderer
+{
+    /*!
+     * @brief The tiles dealt to one thread, taken from the front by it and by
+     * any thread stealing from it
+     */
+    struct alignas(64) Run
+    {
+        std::atomic<size_t> next{0};    /*!< the next tile not yet taken */
+        size_t end = 0;                 /*!< the tile after the last one of the run */
+    };
+
+    /*!
+     * @brief What one thread did during the last render
+     */
+    struct alignas(64) Work
+    {
+        size_t tiles = 0;           /*!< the tiles it drew */
+        size_t stolen = 0;          /*!< the tiles it took from another run */
+        double busy = 0;            /*!< microseconds it spent drawing tiles */
+    };
+
+    std::vector<std::thread> threads;   /*!< the helper threads, the caller is thread 0 */
+    std::unique_ptr<Run[]> runs;        /*!< the tiles dealt to each thread */
+    std::unique_ptr<Work[]> work;       /*!< what each thread did */
+    std::mutex lock;                    /*!< guards the fields below it */
+    std::condition_variable wake;       /*!< signalled when a render starts or the pool stops */
+    std::condition_variable done;       /*!< signalled when the last helper finished a render */
+    unsigned generation = 0;            /*!< renders started, helpers wait for it to change */
+    unsigned finished = 0;              /*!< helpers done with the current render */
+    bool stopping = false;              /*!< set to end the helper threads */
+
+    const RenderList *list = nullptr;   /*!< the list being drawn */
+    Framebuffer *image = nullptr;       /*!< the image being drawn */
+    int across = 0;                     /*!< tiles per row of the image */
+    int down = 0;                       /*!< rows of tiles */
+    std::vector<std::vector<unsigned>> bins;    /*!< the primitives of each tile, in drawing order */
+    std::vector<float> times;           /*!< microseconds each tile took */
+    double binning = 0;                 /*!< milliseconds binning took */
+    double elapsed = 0;                 /*!< milliseconds the whole render took */
+
+    void bin();                                 // adds every primitive to the tiles it overlaps
+    void drawTiles(unsigned thread);            // draws tiles until none are left
+    void helper(unsigned thread);               // the body of a helper thread
+public:
+    TileRenderer(unsigned count = std::thread::hardware_concurrency());
+    TileRenderer(const TileRenderer &other) = delete;
+    TileRenderer &operator=(const TileRenderer &other) = delete;
+    ~TileRenderer();
+    void render(const RenderList &drawing, Framebuffer &target);    // draws a list into an image
+    unsigned size() const;                                          // returns the number of threads
+    void report(std::ostream &out, size_t hottest = 8) const;       // prints the timing of the last render
+};
+
+#endif
@@ -0,0 +1,224 @@
+/** ***************************************************************************
+* @file
+* @brief Cpp file including functions for the tools.h, holds the tool registry
+* and the functions which size, draw and make the shape of each tool
+******************************************************************************/
+
+#include "tools.h"
+
+/** **************************************************************************
+ * @brief Returns the radius of a circle around the start of a drag through its end
+ *
+ * @param[in] drag - the drag locations
+ ******************************************************************************/
+static int circleRadius(const ToolDrag &drag)
+{
+   return sqrt((pow(drag.startX - drag.endX,2) + pow(drag.startY - drag.endY,2)));
+}
+
+/** **************************************************************************
+ * @brief Records a shape into a list if one is given and returns its bounds
+ *
+ * @param[in,out] shape - the sized shape
+ * @param[in,out] list - the sink to draw it into, nullptr to only size it
+ ******************************************************************************/
+static Box previewOf(Shape &shape, RenderSink *list)
+{
+   if(list != nullptr)
+      shape.draw(*list);
+   return shape.bounds();
+}
+
+/*!
+ * @brief The tools, one object each as they hold nothing of a drag but the
+ * preview shape they reuse
+ */
+static const RectangleTool UNFILLED_SQUARE(false), FILLED_SQUARE(true);
+static const CircleTool UNFILLED_CIRCLE(false), FILLED_CIRCLE(true);
+static const EllipseTool UNFILLED_ELLIPSE(false), FILLED_ELLIPSE(true);
+static const LineTool LINE = LineTool();
+
+/*!
+ * @brief The tool of each ToolId, in ToolId order
+ */
+static const Tool *const REGISTRY[TOOL_COUNT] =
+{
+   nullptr, &UNFILLED_SQUARE, &FILLED_SQUARE, &UNFILLED_CIRCLE,
+   &FILLED_CIRCLE, &UNFILLED_ELLIPSE, &FILLED_ELLIPSE, &LINE
+};
+
+/** **************************************************************************
+ * @brief Returns the type of shape the line tool makes
+ ******************************************************************************/
+ShapeType LineTool::type() const
+{
+   return LINE_TYPE;
+}
+
+/** **************************************************************************
+ * @brief Sizes the line of a drag
+ *
+ * @param[in] drag - the drag locations and selected colors
+ * @param[in,out] list - the sink to draw the line into, nullptr to only size it
+ *
+ * @returns the pixels the line covers
+ ******************************************************************************/
+Box LineTool::preview(const ToolDrag &drag, RenderSink *list) const
+{
+   Line line(drag.startX, drag.startY, drag.endY - drag.startY, drag.endX - drag.startX, drag.border);
+   return previewOf(line, list);
+}
+
+/** **************************************************************************
+ * @brief Makes the line of a drag
+ *
+ * @param[in] drag - the drag locations and selected colors
+ * @param[in,out] arena - the arena the line is made in
+ ******************************************************************************/
+Shape *LineTool::commit(const ToolDrag &drag, ShapeArena &arena) const
+{
+   return arena.make<Line>(drag.startX, drag.startY, drag.endY - drag.startY, drag.endX - drag.startX, drag.border);
+}
+
+/** **************************************************************************
+ * @brief Returns the type of shape the rectangle tool makes
+ ******************************************************************************/
+ShapeType RectangleTool::type() const
+{
+   return filled ? FILLED_RECTANGLE_TYPE : RECTANGLE_TYPE;
+}
+
+/** **************************************************************************
+ * @brief Sizes the rectangle of a drag
+ *
+ * @param[in] drag - the drag locations and selected colors
+ * @param[in,out] list - the sink to draw the rectangle into, nullptr to only size it
+ *
+ * @returns the pixels the rectangle covers
+ ******************************************************************************/
+Box RectangleTool::preview(const ToolDrag &drag, RenderSink *list) const
+{
+   int xSize = drag.endX - drag.startX;
+   int ySize = drag.endY - drag.startY;
+   if(filled)
+   {
+      FilledRectangle box(drag.startX, drag.startY, ySize, xSize, drag.border, drag.fill);
+      return previewOf(box, list);
+   }
+   Rectangle box(drag.startX, drag.startY, ySize, xSize, drag.border);
+   return previewOf(box, list);
+}
+
+/** **************************************************************************
+ * @brief Makes the rectangle of a drag
+ *
+ * @param[in] drag - the drag locations and selected colors
+ * @param[in,out] arena - the arena the rectangle is made in
+ ******************************************************************************/
+Shape *RectangleTool::commit(const ToolDrag &drag, ShapeArena &arena) const
+{
+   int xSize = drag.endX - drag.startX;
+   int ySize = drag.endY - drag.startY;
+   if(filled)
+      return arena.make<FilledRectangle>(drag.startX, drag.startY, ySize, xSize, drag.border, drag.fill);
+   return arena.make<Rectangle>(drag.startX, drag.startY, ySize, xSize, drag.border);
+}
+
+/** **************************************************************************
+ * @brief Returns the type of shape the circle tool makes
+ ******************************************************************************/
+ShapeType CircleTool::type() const
+{
+   return filled ? FILLED_CIRCLE_TYPE : CIRCLE_TYPE;
+}
+
+/** **************************************************************************
+ * @brief Sizes the circle of a drag
+ *
+ * @param[in] drag - the drag locations and selected colors
+ * @param[in,out] list - the sink to draw the circle into, nullptr to only size it
+ *
+ * @returns the pixels the circle covers
+ ******************************************************************************/
+Box CircleTool::preview(const ToolDrag &drag, RenderSink *list) const
+{
+   Circle &circle = filled ? solid : outlined;
+   circle.setXLoc(drag.startX);
+   circle.setYLoc(drag.startY);
+   circle.setRadius(circleRadius(drag));
+   circle.setBorderColor(drag.border);
+   if(filled)
+      circle.setFillColor(drag.fill);
+   return previewOf(circle, list);
+}
+
+/** **************************************************************************
+ * @brief Makes the circle of a drag
+ *
+ * @param[in] drag - the drag locations and selected colors
+ * @param[in,out] arena - the arena the circle is made in
+ ******************************************************************************/
+Shape *CircleTool::commit(const ToolDrag &drag, ShapeArena &arena) const
+{
+   if(filled)
+      return arena.make<FilledCircle>(drag.startX, drag.startY, circleRadius(drag), drag.border, drag.fill);
+   return arena.make<Circle>(drag.startX, drag.startY, circleRadius(drag), drag.border);
+}
+
+/** **************************************************************************
+ * @brief Returns the type of shape the ellipse tool makes
+ ******************************************************************************/
+ShapeType EllipseTool::type() const
+{
+   return filled ? FILLED_ELLIPSE_TYPE : ELLIPSE_TYPE;
+}
+
+/** **************************************************************************
+ * @brief Sizes the ellipse of a drag
+ *
+ * @param[in] drag - the drag locations and selected colors
+ * @param[in,out] list - the sink to draw the ellipse into, nullptr to only size it
+ *
+ * @returns the pixels the ellipse covers
+ ******************************************************************************/
+Box EllipseTool::preview(const ToolDrag &drag, RenderSink *list) const
+{
+   Ellipse &ellipse = filled ? solid : outlined;
+   ellipse.setXLoc(drag.endX);
+   ellipse.setYLoc(drag.endY);
+   ellipse.setRadii(drag.endX - drag.startX, drag.endY - drag.startY);
+   ellipse.setBorderColor(drag.border);
+   if(filled)
+      ellipse.setFillColor(drag.fill);
+   return previewOf(ellipse, list);
+}
+
+/** **************************************************************************
+ * @brief Makes the ellipse of a drag
+ *
+ * @param[in] drag - the drag locations and selected colors
+ * @param[in,out] arena - the arena the ellipse is made in
+ ******************************************************************************/
+Shape *EllipseTool::commit(const ToolDrag &drag, ShapeArena &arena) const
+{
+   int xSize = drag.endX - drag.startX;
+   int ySize = drag.endY - drag.startY;
+   if(filled)
+      return arena.make<FilledEllipse>(drag.endX, drag.endY, xSize, ySize, drag.border, drag.fill);
+   return arena.make<Ellipse>(drag.endX, drag.endY, xSize, ySize, drag.border);
+}
+
+/** **************************************************************************
+ * @brief Returns the tool registered under an ID
+ *
+ * A new tool is a new class, a new ToolId before TOOL_COUNT and a new entry
+ * here, nothing that uses the tools changes
+ *
+ * @param[in] id - the tool ID
+ *
+ * @returns the tool, nullptr for NO_TOOL
+ ******************************************************************************/
+const Tool *toolFor(ToolId id)
+{
+   return id < TOOL_COUNT ? REGISTRY[id] : nullptr;
+}
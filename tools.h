@@ -0,0 +1,115 @@
+/** ***************************************************************************
+* @file
+* @brief Header file that holds the drawing tools, one object per tool kept in
+* a registry indexed by a compact tool ID
+******************************************************************************/
+
+#ifndef __TOOLS_H
+#define __TOOLS_H
+
+#include <cstdint>
+#include "shape.h"
+#include "shapearena.h"
+#include "rendersink.h"
+#include "box.h"
+
+/*!
+ * @brief The drawing tools, the index of each tool in the registry
+ */
+enum ToolId : uint8_t
+{
+    NO_TOOL, UNFILLED_SQUARE_TOOL, FILLED_SQUARE_TOOL, UNFILLED_CIRCLE_TOOL,
+    FILLED_CIRCLE_TOOL, UNFILLED_ELLIPSE_TOOL, FILLED_ELLIPSE_TOOL, LINE_TOOL,
+    TOOL_COUNT
+};
+
+/*!
+ * @brief ToolDrag struct, what a tool needs to size its shape
+ */
+struct ToolDrag
+{
+    int startX;             /*!< where the drag started */
+    int startY;             /*!< where the drag started */
+    int endX;               /*!< where the mouse is now */
+    int endY;               /*!< where the mouse is now */
+    const float *border;    /*!< the selected border color */
+    const float *fill;      /*!< the selected fill color */
+};
+
+/*!
+ * @brief Tool class, abstract class for a tool that makes one kind of shape by dragging
+ *
+ * The preview is sized from the drag every time it is asked for, so a drag
+ * only has to remember where the mouse is. The round tools keep their
+ * preview shape between frames, so its outline is only rebuilt when the
+ * radii change and then in memory it already holds. A made shape is hit tested by the
+ * shape store, with the kernel the type of the tool picks.
+ */
+class Tool
+{
+public:
+    virtual ~Tool() {}
+    virtual ShapeType type() const = 0;     // returns the type of shape made, which picks its hit test kernel
+    // returns the pixels the sized shape covers, and records it into list if one is given
+    virtual Box preview(const ToolDrag &drag, RenderSink *list) const = 0;
+    virtual Shape *commit(const ToolDrag &drag, ShapeArena &arena) const = 0;  // makes the sized shape in the arena
+};
+
+/*!
+ * @brief LineTool class, draws a line from the start of the drag to its end
+ */
+class LineTool : public Tool
+{
+public:
+    ShapeType type() const;
+    Box preview(const ToolDrag &drag, RenderSink *list) const;
+    Shape *commit(const ToolDrag &drag, ShapeArena &arena) const;
+};
+
+/*!
+ * @brief RectangleTool class, draws a rectangle from the start of the drag to its end
+ */
+class RectangleTool : public Tool
+{
+    bool filled;    /*!< set if the rectangle is filled with the fill color */
+public:
+    RectangleTool(bool fill) : filled(fill) {}
+    ShapeType type() const;
+    Box preview(const ToolDrag &drag, RenderSink *list) const;
+    Shape *commit(const ToolDrag &drag, ShapeArena &arena) const;
+};
+
+/*!
+ * @brief CircleTool class, draws a circle around the start of the drag through its end
+ */
+class CircleTool : public Tool
+{
+    bool filled;                /*!< set if the circle is filled with the fill color */
+    mutable Circle outlined;    /*!< the preview of an unfilled circle */
+    mutable FilledCircle solid; /*!< the preview of a filled circle */
+public:
+    CircleTool(bool fill) : filled(fill) {}
+    ShapeType type() const;
+    Box preview(const ToolDrag &drag, RenderSink *list) const;
+    Shape *commit(const ToolDrag &drag, ShapeArena &arena) const;
+};
+
+/*!
+ * @brief EllipseTool class, draws an ellipse around the end of the drag
+ * with radii as far as the drag went
+ */
+class EllipseTool : public Tool
+{
+    bool filled;                    /*!< set if the ellipse is filled with the fill color */
+    mutable Ellipse outlined;       /*!< the preview of an unfilled ellipse */
+    mutable FilledEllipse solid;    /*!< the preview of a filled ellipse */
+public:
+    EllipseTool(bool fill) : filled(fill) {}
+    ShapeType type() const;
+    Box preview(const ToolDrag &drag, RenderSink *list) const;
+    Shape *commit(const ToolDrag &drag, ShapeArena &arena) const;
+};
+
+const Tool *toolFor(ToolId id);     // returns the tool registered under an ID, nullptr for NO_TOOL
+
+#endif
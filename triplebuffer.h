@@ -0,0 +1,76 @@
+/** ***************************************************************************
+* @file
+* @brief Header file that holds the TripleBuffer class, a lock-free hand off of
+* the newest version of a value from one producer thread to one consumer thread
+******************************************************************************/
+
+#ifndef __TRIPLEBUFFER_H
+#define __TRIPLEBUFFER_H
+
+#include <atomic>
+
+/*!
+ * @brief TripleBuffer class, the producer fills one slot while the consumer
+ * reads another and the third holds the most recently published value
+ *
+ * Publishing and taking are a single atomic exchange each, so neither side
+ * ever waits. A slot is never touched by the producer again until the
+ * consumer has moved on to a newer one.
+ */
+template <typename T>
+class TripleBuffer
+{
+    static const int FRESH = 4;     /*!< set in ready when it holds an unseen value */
+    static const int INDEX = 3;     /*!< the slot index bits of ready */
+
+    T slots[3];                     /*!< the three buffered values */
+    int writing = 0;                /*!< slot being filled, owned by the producer */
+    int reading = 1;                /*!< slot being read, owned by the consumer */
+    std::atomic<int> ready{2};      /*!< most recently published slot, plus FRESH */
+public:
+    /*!
+     * @brief Returns the slot to fill, producer thread only
+     */
+    T &back()
+    {
+        return slots[writing];
+    }
+
+    /*!
+     * @brief Publishes the filled slot and takes back the oldest one, producer thread only
+     */
+    void publish()
+    {
+        writing = ready.exchange(writing | FRESH, std::memory_order_acq_rel) & INDEX;
+    }
+
+    /*!
+     * @brief Returns true if a value was published that the consumer has not taken
+     */
+    bool fresh() const
+    {
+        return (ready.load(std::memory_order_acquire) & FRESH) != 0;
+    }
+
+    /*!
+     * @brief Moves the consumer to the newest published value, consumer thread only
+     * @returns true if there was a newer value
+     */
+    bool take()
+    {
+        if (!fresh())
+            return false;
+        reading = ready.exchange(reading, std::memory_order_acq_rel) & INDEX;
+        return true;
+    }
+
+    /*!
+     * @brief Returns the slot the consumer is reading, consumer thread only
+     */
+    const T &front() const
+    {
+        return slots[reading];
+    }
+};
+
+#endif
@@ -0,0 +1,77 @@
+/** ***************************************************************************
+* @file
+* @brief Cpp file including functions for the unitcircle.h, holds the functions
+* which pick a segment count from a radius and trace round outlines from the
+* shared unit circle table
+******************************************************************************/
+
+#include "unitcircle.h"
+
+/** **************************************************************************
+ * @brief Returns how many segments a circle needs to look round
+ *
+ * A chord of a circle of radius r spanning angle a strays r(1 - cos(a/2))
+ * from the curve, so keeping that under MAX_ERROR gives the segment count.
+ * It is rounded up to a power of two so the table can be walked with a
+ * whole stride, and kept between MIN_SEGMENTS and CIRCLE_POINTS.
+ *
+ * @param[in] radius - the radius in pixels
+ *
+ * @returns the number of segments, a power of two
+ ******************************************************************************/
+int circleSegments(float radius)
+{
+   radius = fabs(radius);
+   if (radius <= MAX_ERROR)
+      return MIN_SEGMENTS;
+   float needed = 3.14159265f / acos(1.0f - MAX_ERROR / radius);
+   int segments = MIN_SEGMENTS;
+   while (segments < needed && segments < CIRCLE_POINTS)
+      segments *= 2;
+   return segments;
+}
+
+/** **************************************************************************
+ * @brief Adds the outline points of an ellipse to the primitive being recorded
+ *
+ * The segment count follows the larger radius, a circle is an ellipse with
+ * equal radii. The caller begins and ends the primitive, so the same points
+ * serve for a GL_LINE_LOOP outline or a GL_POLYGON fill.
+ *
+ * @param[in,out] list - the sink being drawn into
+ * @param[in] x - the x location of the center
+ * @param[in] y - the y location of the center
+ * @param[in] radiusX - the x axis radius
+ * @param[in] radiusY - the y axis radius
+ ******************************************************************************/
+void traceEllipse(RenderSink &list, float x, float y, float radiusX, float radiusY)
+{
+   int segments = circleSegments(fabs(radiusX) > fabs(radiusY) ? radiusX : radiusY);
+   int stride = CIRCLE_POINTS / segments;
+   for (int i = 0; i < CIRCLE_POINTS; i += stride)
+      list.vertex(x + radiusX * UNIT_CIRCLE.cosine[i], y + radiusY * UNIT_CIRCLE.sine[i]);
+}
+
+/** **************************************************************************
+ * @brief Stores the outline points of an ellipse centered on the origin
+ *
+ * Gives the same points as traceEllipse, as x/y pairs, so a shape can keep
+ * them and only move them to its location when it is drawn. An empty vector
+ * is given exactly the room the points take, a reused one keeps its memory.
+ *
+ * @param[out] points - the x/y pairs, replaced
+ * @param[in] radiusX - the x axis radius
+ * @param[in] radiusY - the y axis radius
+ ******************************************************************************/
+void tessellateEllipse(vector<float> &points, float radiusX, float radiusY)
+{
+   int segments = circleSegments(fabs(radiusX) > fabs(radiusY) ? radiusX : radiusY);
+   int stride = CIRCLE_POINTS / segments;
+   points.clear();
+   points.reserve(2 * segments);
+   for (int i = 0; i < CIRCLE_POINTS; i += stride)
+   {
+      points.push_back(radiusX * UNIT_CIRCLE.cosine[i]);
+      points.push_back(radiusY * UNIT_CIRCLE.sine[i]);
+   }
+}
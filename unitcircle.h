@@ -0,0 +1,82 @@
+/** ***************************************************************************
+* @file
+* @brief Header file that holds the unit circle table shared by every round
+* shape, computed by the compiler, and the functions that trace circles and
+* ellipses from it with as many segments as their size needs
+******************************************************************************/
+
+#ifndef __UNITCIRCLE_H
+#define __UNITCIRCLE_H
+
+#include "rendersink.h"
+
+const int CIRCLE_POINTS = 1024;     /*!< points in the table, every segment count divides it */
+const int MIN_SEGMENTS = 8;         /*!< the fewest segments a round shape is drawn with */
+const float MAX_ERROR = 0.25f;      /*!< the furthest, in pixels, a segment may stray from the curve */
+
+/*!
+ * @brief UnitCircle struct, evenly spaced points around the unit circle
+ */
+struct UnitCircle
+{
+    float cosine[CIRCLE_POINTS];    /*!< the x of each point */
+    float sine[CIRCLE_POINTS];      /*!< the y of each point */
+};
+
+constexpr double CIRCLE_PI = 3.14159265358979323846;   /*!< pi, for the table */
+
+/** **************************************************************************
+ * @brief Sine of an angle between -pi and pi, usable at compile time
+ *
+ * The Taylor series converges to double precision over that range well
+ * within the number of terms used
+ *
+ * @param[in] x - the angle in radians
+ ******************************************************************************/
+constexpr double taylorSine(double x)
+{
+   double term = x;
+   double sum = x;
+   for (int n = 1; n < 30; n++)
+   {
+      term *= -x * x / ((2 * n) * (2 * n + 1));
+      sum += term;
+   }
+   return sum;
+}
+
+/** **************************************************************************
+ * @brief Brings an angle between 0 and 3 pi into the range -pi to pi
+ *
+ * @param[in] x - the angle in radians
+ ******************************************************************************/
+constexpr double wrapAngle(double x)
+{
+   return x > CIRCLE_PI ? x - 2 * CIRCLE_PI : x;
+}
+
+/** **************************************************************************
+ * @brief Builds the unit circle table, at compile time
+ ******************************************************************************/
+constexpr UnitCircle makeUnitCircle()
+{
+   UnitCircle table = {};
+   for (int i = 0; i < CIRCLE_POINTS; i++)
+   {
+      double theta = 2 * CIRCLE_PI * i / CIRCLE_POINTS;
+      table.sine[i] = float(taylorSine(wrapAngle(theta)));
+      table.cosine[i] = float(taylorSine(wrapAngle(theta + CIRCLE_PI / 2)));   // cos x = sin(x + pi/2)
+   }
+   return table;
+}
+
+inline constexpr UnitCircle UNIT_CIRCLE = makeUnitCircle();   /*!< the shared unit circle table */
+
+static_assert(UNIT_CIRCLE.cosine[0] == 1.0f && UNIT_CIRCLE.sine[CIRCLE_POINTS / 4] == 1.0f,
+              "the unit circle table must be exact at the axes");
+
+int circleSegments(float radius);   // segments needed to keep a circle within MAX_ERROR
+void traceEllipse(RenderSink &list, float x, float y, float radiusX, float radiusY);  // adds the outline points of an ellipse
+void tessellateEllipse(vector<float> &points, float radiusX, float radiusY);        // stores the outline points of an ellipse around 0, 0
+
+#endif
@@ -5,8 +5,15 @@
 ******************************************************************************/
 
 
+#include <unistd.h>
 #include "util.h"
+#include "stats.h"
+#include "journal.h"
+#include "scene.h"
+#include "scenefile.h"
+#include "autosave.h"
 
+static Document doc;    // the menu items, shapes and selections, owned by the scene thread
 
 /** **************************************************************************
  * @brief Main event dispatch function
@@ -14,15 +21,175 @@
  * Any events to which the application has subscribed will be routed through
  * this function. It will help with saving the state of the program
  *
- * @param[in] event - Pointer to an Event object.
+ * It only ever runs on the scene thread (or the replay driver), which makes
+ * that thread the sole owner of the shapes, menu items and selections
+ *
+ * The event is a value owned by the caller and is only borrowed for the
+ * duration of the call. std::visit selects the action of the held event type
+ * at compile time and hands it the one document. Actions only mark the
+ * document as damaged, renderDamage draws it.
+ *
+ * @param[in] event - Reference to an Event variant.
+ ******************************************************************************/
+void utilityCentral(const Event &event)
+{
+   stats().eventsDispatched.fetch_add(1, std::memory_order_relaxed);
+   journalEvent(event);
+   visit([](const auto &e) { e.action(doc); }, event);   // the borrowed event
+}
+
+/** **************************************************************************
+ * @brief Returns true if an event changed the document since the last frame
+ ******************************************************************************/
+bool sceneDamaged()
+{
+   return doc.dirty;
+}
+
+/** **************************************************************************
+ * @brief Renders and publishes one frame if the document was damaged
+ *
+ * Called by the frame scheduler once per frame, after every queued event has
+ * been dispatched, so a burst of events costs a single redraw
+ *
+ * @returns true if a frame was rendered
+ ******************************************************************************/
+bool renderDamage()
+{
+   if (!doc.dirty)
+      return false;
+   renderScene(doc);
+   stats().framesRendered.fetch_add(1, std::memory_order_relaxed);
+   return true;
+}
+
+/** **************************************************************************
+ * @brief Frees a batch of the shapes of clears dropped from the undo history
+ * and buckets a batch of opened shapes into the grid
+ *
+ * Called by the scene thread when no events are waiting, until nothing is
+ * left to do
+ *
+ * @returns true if work is left
+ ******************************************************************************/
+bool idleScene()
+{
+   bool reclaiming = doc.history.reclaim(doc);
+   bool filling = doc.grid.fill(GRID_BATCH);
+   return reclaiming || filling;
+}
+
+/** **************************************************************************
+ * @brief Sets the memory the undo history may keep alive
+ *
+ * Only called before the scene thread starts, the document is not shared yet
+ *
+ * @param[in] bytes - the budget in bytes
+ ******************************************************************************/
+void setUndoBudget(size_t bytes)
+{
+   doc.history.setBudget(bytes);
+}
+
+/** **************************************************************************
+ * @brief Opens a scene file, the drawing is saved back to it
+ *
+ * The shapes of the file are put on the canvas as one change, which can be
+ * undone. A file that does not exist yet starts an empty drawing. Only called
+ * before the scene thread starts, the document is not shared yet
+ *
+ * @param[in] path - the scene file
+ *
+ * @returns false if the file exists but could not be read
+ ******************************************************************************/
+bool openDocument(const char *path)
+{
+   setScenePath(path);
+   std::unique_ptr<SceneParts> parts = openScene(path, doc);
+   if (parts == nullptr)
+      return access(path, F_OK) != 0;
+   doc.history.replace(doc, std::move(parts));
+   doc.damage();
+   return true;
+}
+
+/** **************************************************************************
+ * @brief Starts autosaving the shapes, after putting back the ones an earlier
+ * autosave holds
+ *
+ * The recovered shapes replace the ones on the canvas as one change, which
+ * can be undone. Only called before the scene thread starts, the document is
+ * not shared yet
+ *
+ * @param[in] base - the autosave path, without the .pscn and .plog
+ * @param[in] limit - log bytes after which it is compacted
+ *
+ * @returns false if there is an autosave but it could not be read
+ ******************************************************************************/
+bool resumeAutosave(const char *base, size_t limit)
+{
+   std::unique_ptr<SceneParts> parts = recoverAutosave(base, doc, cerr);
+   if (parts != nullptr)
+   {
+      doc.history.replace(doc, std::move(parts));
+      doc.damage();
+   }
+   else if (access((string(base) + ".pscn").c_str(), F_OK) == 0)
+      return false;   // it would be written over
+   return startAutosave(base, limit, doc.records.snapshot());
+}
+
+/** **************************************************************************
+ * @brief Draws the document into a framebuffer the size of the window, or a
+ * multiple of it, with the software rasterizer
+ *
+ * The shapes are drawn back to front and the toolbox over them, as the window
+ * shows them, without the toolbox text. No OpenGL is used, so a document
+ * rebuilt from a journal can be drawn on a host without a display. The tiles
+ * of the image are drawn in parallel.
+ *
+ * Scene thread (or replay driver) only
+ *
+ * @param[out] image - resized to the window times the scale and drawn into
+ * @param[in,out] tiles - the threads that draw the image
+ * @param[in] scale - the size of the image relative to the window
  ******************************************************************************/
-void utilityCentral(Event * event)
+void renderImage(Framebuffer &image, TileRenderer &tiles, float scale)
 {
-   static vector<Event *> events;      // static vector of events
-   static vector<MenuItem *> menuItems;   // static vector of menu items
-   static vector<Shape *> shapes;         // static vector of shapes
-   static Selections selected;            // static selection instance
-   event->action(events, menuItems, shapes, selected);   // the pointed event
+   int width, height;
+   getWindowSize(width, height);
+   const uint8_t black[4] = {0, 0, 0, 255};   // the window has no alpha, it reads back opaque
+   image.resize(int(width * scale), int(height * scale));
+   image.clear(packColor(black));
+
+   RenderList list;
+   for (Shape *shape : doc.shapes)
+      shape->draw(list);
+   mainPalleteDraw(doc.toolbox, list);   // recorded last, so it is drawn over the shapes
+   list.scale(scale);
+   tiles.render(list, image);
+}
+
+/** **************************************************************************
+ * @brief Rebuilds an event from its compact record and dispatches it
+ *
+ * The event is built as a value on the stack, exactly as the glut callbacks do
+ *
+ * @param[in] record - the recorded event
+ ******************************************************************************/
+void dispatchRecord(const EventRecord &record)
+{
+   switch (record.type)
+   {
+      case INIT_EVENT:    utilityCentral(Init(record.x, record.y)); break;
+      case DISPLAY_EVENT: utilityCentral(Display()); break;
+      case RESHAPE_EVENT: utilityCentral(ReshapeEvent(record.x, record.y)); break;
+      case KEY_EVENT:     utilityCentral(KeyPress(record.button, record.x, record.y)); break;
+      case CLICK_EVENT:   utilityCentral(MouseClick(record.button, record.state, record.x, record.y)); break;
+      case DRAG_EVENT:    utilityCentral(MouseDrag(record.x, record.y)); break;
+      case MOVE_EVENT:    utilityCentral(MouseMove(record.x, record.y)); break;
+      case CLOSE_EVENT:   utilityCentral(CloseEvent()); break;
+   }
 }
 
 /** ***************************************************************************
@@ -36,8 +203,9 @@ void initOpenGL(int argc, char **argv, int wCols, int wRows)
 
 // Choose the display mode for the window.  GLUT_DOUBLE means double buffering
 // GLUT_SINGLE is single buffering.  GLUT_RGBA is 24-bit color with 8-bit alpha
+// GLUT_DEPTH adds the depth buffer the render list keeps the drawing order with
 
-   glutInitDisplayMode(GLUT_SINGLE | GLUT_RGBA);
+   glutInitDisplayMode(GLUT_SINGLE | GLUT_RGBA | GLUT_DEPTH);
 
    glutSetOption(GLUT_ACTION_ON_WINDOW_CLOSE,GLUT_ACTION_CONTINUE_EXECUTION);
 
@@ -62,7 +230,7 @@ void initOpenGL(int argc, char **argv, int wCols, int wRows)
 
    glutPassiveMotionFunc(mouseMove);
 
-   //glutTimerFunc(1000, ticktock, 1000);
+   glutTimerFunc(frameInterval(), frameTick, 0);
 
    glutCloseFunc(onClose);
 
@@ -70,6 +238,10 @@ void initOpenGL(int argc, char **argv, int wCols, int wRows)
 // when glClear() is called
    glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
 
+// Start the scene thread, every event from here on runs there
+   startScene();
+
 // Use the InitEvent object to perform startup operations for the application
-   utilityCentral(new Init(wCols, wRows));
+   Init init(wCols, wRows);
+   postEvent(init);
 }
\ No newline at end of file
@@ -11,10 +11,19 @@
 #include <vector>
 #include "event.h"
 #include "callbacks.h"
+#include "tiles.h"
 
 
 using namespace std;
 
 void initOpenGL(int argc, char **argv, int wCols, int wRows);   // central OpenGL function
-void utilityCentral(Event * event);     // Utility function which holds state of program
+void utilityCentral(const Event &event);    // Utility function which holds state of program
+void dispatchRecord(const EventRecord &record);   // rebuilds a recorded event and dispatches it
+bool sceneDamaged();                        // true if the document changed since the last frame
+bool renderDamage();                        // renders one frame if the document changed
+bool idleScene();                           // does a batch of the work clears and opens leave behind
+void setUndoBudget(size_t bytes);           // sets the memory the undo history may keep alive
+bool openDocument(const char *path);        // opens a scene file, the drawing is saved back to it
+bool resumeAutosave(const char *base, size_t limit);    // recovers an autosave and starts autosaving
+void renderImage(Framebuffer &image, TileRenderer &tiles, float scale = 1.0f);   // draws the shapes and toolbox in software
 #endif
@@ -0,0 +1,249 @@
+/** ***************************************************************************
+* @file
+* @brief Cpp file including functions for the zorder.h, holds the functions
+* which restack the shapes
+******************************************************************************/
+
+#include "zorder.h"
+
+/** **************************************************************************
+ * @brief Puts a shape at a depth, the depth must be free
+ *
+ * @param[in] shape - the shape
+ * @param[in] depth - its new depth
+ ******************************************************************************/
+void ZOrder::place(Shape *shape, long long depth)
+{
+   byDepth.emplace_hint(byDepth.end(), depth, shape);   // constant time for a shape put in front
+   depths[shape] = depth;
+}
+
+/** **************************************************************************
+ * @brief Puts a new shape in front of every other shape
+ *
+ * @param[in] shape - the shape, not already in the order
+ *
+ * @returns the depth of the shape
+ ******************************************************************************/
+long long ZOrder::add(Shape *shape)
+{
+   long long depth = byDepth.empty() ? 0 : byDepth.rbegin()->first + 1;
+   place(shape, depth);
+   heap += shape->heapBytes();
+   return depth;
+}
+
+/** **************************************************************************
+ * @brief Puts a new shape at a depth no other shape has, used to put back a
+ * shape that was taken out
+ *
+ * @param[in] shape - the shape, not already in the order
+ * @param[in] depth - its depth, free
+ ******************************************************************************/
+void ZOrder::insert(Shape *shape, long long depth)
+{
+   place(shape, depth);
+   heap += shape->heapBytes();
+}
+
+/** **************************************************************************
+ * @brief Moves a shape to a depth no other shape has
+ *
+ * @param[in] shape - the shape, in the order
+ * @param[in] depth - its new depth, free
+ ******************************************************************************/
+void ZOrder::moveTo(Shape *shape, long long depth)
+{
+   byDepth.erase(depths.at(shape));
+   place(shape, depth);
+}
+
+/** **************************************************************************
+ * @brief Swaps the depths of two shapes, the others stay put
+ *
+ * @param[in] shape - a shape, in the order
+ * @param[in] other - another shape, in the order
+ ******************************************************************************/
+void ZOrder::exchange(Shape *shape, Shape *other)
+{
+   long long depth = depths.at(shape);
+   long long otherDepth = depths.at(other);
+   byDepth[depth] = other;
+   byDepth[otherDepth] = shape;
+   depths[shape] = otherDepth;
+   depths[other] = depth;
+}
+
+/** **************************************************************************
+ * @brief Puts a shape in front of every other shape
+ *
+ * @param[in] shape - the shape, in the order
+ *
+ * @returns the new depth of the shape
+ ******************************************************************************/
+long long ZOrder::bringToFront(Shape *shape)
+{
+   long long depth = depths.at(shape);
+   long long front = byDepth.rbegin()->first;
+   if (front == depth)
+      return depth;
+   byDepth.erase(depth);
+   place(shape, front + 1);
+   return front + 1;
+}
+
+/** **************************************************************************
+ * @brief Puts a shape behind every other shape
+ *
+ * @param[in] shape - the shape, in the order
+ *
+ * @returns the new depth of the shape
+ ******************************************************************************/
+long long ZOrder::sendToBack(Shape *shape)
+{
+   long long depth = depths.at(shape);
+   long long back = byDepth.begin()->first;
+   if (back == depth)
+      return depth;
+   byDepth.erase(depth);
+   place(shape, back - 1);
+   return back - 1;
+}
+
+/** **************************************************************************
+ * @brief Swaps a shape with the shape just in front of it
+ *
+ * @param[in] shape - the shape, in the order
+ *
+ * @returns the shape now behind it, nullptr if it was already in front
+ ******************************************************************************/
+Shape *ZOrder::raise(Shape *shape)
+{
+   Tree::iterator at = byDepth.find(depths.at(shape));
+   Tree::iterator above = std::next(at);
+   if (above == byDepth.end())
+      return nullptr;
+   Shape *other = above->second;
+   above->second = shape;
+   at->second = other;
+   depths[shape] = above->first;
+   depths[other] = at->first;
+   return other;
+}
+
+/** **************************************************************************
+ * @brief Swaps a shape with the shape just behind it
+ *
+ * @param[in] shape - the shape, in the order
+ *
+ * @returns the shape now in front of it, nullptr if it was already at the back
+ ******************************************************************************/
+Shape *ZOrder::lower(Shape *shape)
+{
+   Tree::iterator at = byDepth.find(depths.at(shape));
+   if (at == byDepth.begin())
+      return nullptr;
+   Shape *other = std::prev(at)->second;
+   raise(other);
+   return other;
+}
+
+/** **************************************************************************
+ * @brief Takes a shape out of the order, the others keep their depths
+ *
+ * @param[in] shape - the shape, ignored if not in the order
+ ******************************************************************************/
+void ZOrder::remove(Shape *shape)
+{
+   auto found = depths.find(shape);
+   if (found == depths.end())
+      return;
+   byDepth.erase(found->second);
+   depths.erase(found);
+   heap -= shape->heapBytes();
+}
+
+/** **************************************************************************
+ * @brief Takes every shape out of the order
+ ******************************************************************************/
+void ZOrder::clear()
+{
+   byDepth.clear();
+   depths.clear();
+   heap = 0;
+}
+
+/** **************************************************************************
+ * @brief Replaces the shapes with a whole set, in time linear in their number
+ *
+ * The tree is built from the sorted depths in one pass, each node put after
+ * the last, and the depth of every shape is looked up from a table sized once.
+ *
+ * @param[in] sorted - the shapes with their depths, back to front, no depth twice
+ ******************************************************************************/
+void ZOrder::assign(const std::vector<std::pair<long long, Shape *>> &sorted)
+{
+   byDepth.clear();
+   depths.clear();
+   depths.reserve(sorted.size());
+   heap = 0;
+   for (const auto &entry : sorted)
+   {
+      byDepth.emplace_hint(byDepth.end(), entry.first, entry.second);   // the range constructor searches from the root for each
+      depths.emplace(entry.second, entry.first);
+      heap += entry.second->heapBytes();
+   }
+}
+
+/** **************************************************************************
+ * @brief Returns true if the shape is in the order
+ *
+ * @param[in] shape - the shape
+ ******************************************************************************/
+bool ZOrder::contains(Shape *shape) const
+{
+   return depths.count(shape) != 0;
+}
+
+/** **************************************************************************
+ * @brief Returns the depth of a shape, larger is further in front
+ *
+ * @param[in] shape - the shape, in the order
+ ******************************************************************************/
+long long ZOrder::depthOf(Shape *shape) const
+{
+   return depths.at(shape);
+}
+
+/** **************************************************************************
+ * @brief Returns the shape in front of every other, nullptr if there are none
+ ******************************************************************************/
+Shape *ZOrder::top() const
+{
+   return byDepth.empty() ? nullptr : byDepth.rbegin()->second;
+}
+
+/** **************************************************************************
+ * @brief Returns the number of shapes in the order
+ ******************************************************************************/
+size_t ZOrder::size() const
+{
+   return byDepth.size();
+}
+
+/** **************************************************************************
+ * @brief Returns the bytes the shapes in the order hold outside the arena,
+ * their outlines
+ ******************************************************************************/
+size_t ZOrder::heapBytes() const
+{
+   return heap;
+}
+
+/** **************************************************************************
+ * @brief Returns true if there are no shapes in the order
+ ******************************************************************************/
+bool ZOrder::empty() const
+{
+   return byDepth.empty();
+}
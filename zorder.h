@@ -0,0 +1,77 @@
+/** ***************************************************************************
+* @file
+* @brief Header file that holds the ZOrder class, the drawing order of the
+* shapes kept as a tree keyed by depth so restacking a shape never moves the
+* others
+******************************************************************************/
+
+#ifndef __ZORDER_H
+#define __ZORDER_H
+
+#include <map>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "shape.h"
+
+/*!
+ * @brief ZOrder class, the shapes of the document from back to front
+ *
+ * Every shape has a depth, larger is further in front. A shape brought to
+ * the front or sent to the back gets a depth past the current front or back
+ * one, and raising or lowering it by one swaps depths with its neighbour, so
+ * every change is one or two tree operations and no other shape is touched.
+ * Depths are 64 bit, they never run out.
+ *
+ * The grid stacks the shapes it finds by the same depths, so the changed
+ * depths are returned to be handed on to it.
+ */
+class ZOrder
+{
+    typedef std::map<long long, Shape *> Tree;
+
+    Tree byDepth;                                   /*!< the shapes, back to front */
+    std::unordered_map<Shape *, long long> depths;  /*!< the depth of every shape */
+    size_t heap = 0;                                /*!< the bytes the shapes hold outside the arena */
+
+    void place(Shape *shape, long long depth);      // puts a shape at a depth
+public:
+    /*!
+     * @brief Walks the shapes from back to front
+     */
+    class const_iterator
+    {
+        Tree::const_iterator at;    /*!< the tree node of the current shape */
+    public:
+        const_iterator() {}
+        const_iterator(Tree::const_iterator it) : at(it) {}
+        Shape *operator*() const { return at->second; }
+        long long depth() const { return at->first; }   ///< the depth of the current shape
+        const_iterator &operator++() { ++at; return *this; }
+        bool operator!=(const const_iterator &other) const { return at != other.at; }
+        bool operator==(const const_iterator &other) const { return at == other.at; }
+    };
+
+    const_iterator begin() const { return const_iterator(byDepth.begin()); }  ///< the shape at the back
+    const_iterator end() const { return const_iterator(byDepth.end()); }      ///< past the shape in front
+
+    long long add(Shape *shape);            // puts a new shape in front, returns its depth
+    void insert(Shape *shape, long long depth);     // puts a new shape at a free depth
+    void moveTo(Shape *shape, long long depth);     // moves a shape to a free depth
+    void exchange(Shape *shape, Shape *other);      // swaps the depths of two shapes
+    long long bringToFront(Shape *shape);   // puts a shape in front of all others, returns its depth
+    long long sendToBack(Shape *shape);     // puts a shape behind all others, returns its depth
+    Shape *raise(Shape *shape);             // swaps a shape with the one in front of it, returns that one
+    Shape *lower(Shape *shape);             // swaps a shape with the one behind it, returns that one
+    void remove(Shape *shape);              // takes a shape out
+    void clear();                           // takes every shape out
+    void assign(const std::vector<std::pair<long long, Shape *>> &sorted);   // replaces the shapes with ones sorted by depth
+    bool contains(Shape *shape) const;      // returns true if the shape is in the order
+    long long depthOf(Shape *shape) const;  // returns the depth of a shape in the order
+    Shape *top() const;                     // returns the shape in front, nullptr if none
+    size_t size() const;                    // returns the number of shapes
+    size_t heapBytes() const;               // returns the bytes the shapes hold outside the arena
+    bool empty() const;                     // returns true if there are no shapes
+};
+
+#endif